@@ -59,7 +59,17 @@ public class BetaHubBugReporter : ModuleRules
 			}
 			);
 
-		
+		// Local stand-in for the BetaHub API and S3 used by BetaHub.BenchmarkSubmission and the automation tests, never shipped
+		if (Target.Configuration != UnrealTargetConfiguration.Shipping)
+		{
+			PrivateDependencyModuleNames.Add("HTTPServer");
+			PrivateDefinitions.Add("BH_WITH_MOCK_SERVER=1");
+		}
+		else
+		{
+			PrivateDefinitions.Add("BH_WITH_MOCK_SERVER=0");
+		}
+
 		string ffmpegPath = Path.Combine(PluginDirectory, "ThirdParty/FFmpeg/Windows/ffmpeg.exe");
 		if (File.Exists(ffmpegPath))
 		{
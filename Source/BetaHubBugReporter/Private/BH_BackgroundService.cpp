@@ -2,6 +2,9 @@
 #include "BH_BackgroundService.h"
 #include "BH_Log.h"
 #include "BH_FFmpeg.h"
+#include "BH_StorageManager.h"
+#include "BH_UploadJournal.h"
+#include "BH_HttpRequest.h"
 #include "Engine/Engine.h"
 #include "Engine/GameViewportClient.h"
 #include "Blueprint/UserWidget.h"
@@ -10,6 +13,9 @@
 #include "TimerManager.h"
 #include "UnrealClient.h"
 
+// Errors and warnings a report's signature is computed from
+static const int32 MaxSignatureProblems = 5;
+
 UBH_BackgroundService::UBH_BackgroundService()
     : Settings(nullptr), GameRecorder(nullptr)
 {
@@ -20,7 +26,7 @@ UBH_BackgroundService::UBH_BackgroundService()
 void UBH_BackgroundService::StartService()
 {
     GameRecorder = NewObject<UBH_GameRecorder>(this);
-    LogCapture = new UBH_LogCapture();
+    LogCapture = new UBH_LogCapture((int64)Settings->MaxCapturedLogMB * 1024 * 1024);
     
     GLog->AddOutputDevice(LogCapture);
     
@@ -110,8 +116,29 @@ void UBH_BackgroundService::InitializeService()
             UE_LOG(LogBetaHub, Warning, TEXT("FFmpeg not found. Video recording is disabled. Bug reports will include screenshots but not video. See https://github.com/betahub-io/unreal-plugin/blob/master/FFMPEG_SETUP.md for setup instructions."));
         }
 
+        BH_StorageManager::Configure(
+            (int64)Settings->MaxStorageMB * 1024 * 1024,
+            (int64)Settings->MinFreeDiskSpaceMB * 1024 * 1024,
+            Settings->VideoSegmentsDirectory);
+
+        // The first report does not pay for the DNS lookup and TLS handshake
+        BH_HttpRequest::PrewarmConnection(Settings->ApiEndpoint);
+
+        // Resume reports that earlier sessions could not finish sending
+        BH_UploadJournal::Get().Initialize();
+
         // Set maximum video dimensions while maintaining aspect ratio
         GameRecorder->SetMaxVideoDimensions(Settings->MaxVideoWidth, Settings->MaxVideoHeight);
+        GameRecorder->SetTriageProxy(
+            Settings->bRecordTriageProxy ? Settings->TriageProxyHeight : 0,
+            Settings->TriageProxyBitrateKbps);
+        GameRecorder->SetIntraFrameCapture(Settings->bUseIntraFrameCaptureCodec);
+
+        FBH_EncoderCpuLimits CpuLimits;
+        CpuLimits.ThreadLimit = Settings->EncoderThreadLimit;
+        CpuLimits.AffinityMask = (uint64)Settings->EncoderAffinityMask;
+        CpuLimits.bLowerPriority = Settings->bLowerEncoderPriority;
+        GameRecorder->SetEncoderCpuLimits(CpuLimits);
         GameRecorder->StartRecording(Settings->MaxRecordedFrames, Settings->MaxRecordingDuration);
     }
 }
@@ -164,6 +191,9 @@ UBH_ReportFormWidget* UBH_BackgroundService::SpawnBugReportWidget(APlayerControl
 
     CaptureScreenshot();
 
+    // Idle connections are closed after a while, reopen one while the player fills in the form
+    BH_HttpRequest::PrewarmConnection(Settings->ApiEndpoint);
+
     // Create the widget
     UBH_ReportFormWidget* ReportForm = CreateWidget<UBH_ReportFormWidget>(LocalPlayerController, ReportFormWidgetClass);
     if (!ReportForm)
@@ -172,7 +202,9 @@ UBH_ReportFormWidget* UBH_BackgroundService::SpawnBugReportWidget(APlayerControl
         return nullptr;
     }
 
-    ReportForm->Setup(Settings, GameRecorder, ScreenshotPath, LogCapture->GetCapturedLogs(), bTryCaptureMouse);
+    ReportForm->SetLogProblems(LogCapture->GetTopProblems(MaxSignatureProblems));
+    ReportForm->SetLogSnapshot(GetReportLogSnapshot());
+    ReportForm->Setup(Settings, GameRecorder, ScreenshotPath, FString(), bTryCaptureMouse);
 
     UE_LOG(LogBetaHub, Log, TEXT("ReportForm widget created successfully."));
 
@@ -186,3 +218,32 @@ UBH_GameRecorder* UBH_BackgroundService::GetGameRecorder()
 {
     return GameRecorder;
 }
+
+UBH_LogCapture* UBH_BackgroundService::GetLogCapture()
+{
+    return LogCapture;
+}
+
+FString UBH_BackgroundService::GetReportLogs()
+{
+    TSharedPtr<const FBH_LogSnapshot, ESPMode::ThreadSafe> Snapshot = GetReportLogSnapshot();
+    return Snapshot.IsValid() ? Snapshot->ToString() : FString();
+}
+
+TSharedPtr<const FBH_LogSnapshot, ESPMode::ThreadSafe> UBH_BackgroundService::GetReportLogSnapshot()
+{
+    if (!LogCapture)
+    {
+        return nullptr;
+    }
+
+    // Times of the recorded frames, the clip can be shorter than MaxRecordingDuration or span pauses
+    double ClipStart = 0.0;
+    double ClipEnd = 0.0;
+    if (!Settings->bAttachClipWindowLogs || !GameRecorder || !GameRecorder->GetRecordedTimeRange(ClipStart, ClipEnd))
+    {
+        return MakeShared<FBH_LogSnapshot, ESPMode::ThreadSafe>(LogCapture->Snapshot());
+    }
+
+    return MakeShared<FBH_LogSnapshot, ESPMode::ThreadSafe>(LogCapture->Snapshot(ClipStart - Settings->LogLeadInSeconds, ClipEnd));
+}
@@ -0,0 +1,256 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "BH_BandwidthLimiter.h"
+#include "BH_Log.h"
+#include "BH_PluginSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+    const float TickIntervalSeconds = 0.5f;
+
+    // Adaptive mode never goes below this, in bytes per second
+    const int64 MinAdaptiveRate = 32 * 1024;
+
+    // The bucket holds a quarter of a second of sending, but at least this much
+    const int64 MinBurstBytes = 16 * 1024;
+
+    // A connection is congested when its round-trip time grows this much over its baseline, or it loses packets
+    const float CongestedRttFactor = 1.5f;
+    const float CongestedRttMarginMs = 20.0f;
+    const float CongestedLoss = 0.02f;
+
+    // Without input for this long the player is not playing
+    const double IdleSeconds = 60.0;
+}
+
+BH_BandwidthLimiter& BH_BandwidthLimiter::Get()
+{
+    static BH_BandwidthLimiter Instance;
+    return Instance;
+}
+
+BH_BandwidthLimiter::BH_BandwidthLimiter()
+    : Tokens(0.0)
+    , LastRefillTime(FPlatformTime::Seconds())
+    , Rate(0)
+    , BurstBytes(MinBurstBytes)
+    , BytesSinceTick(0)
+    , AdaptiveRate(0)
+    , BaselineRttMs(0.0f)
+{
+    check(IsInGameThread());
+
+    const UBH_PluginSettings* Settings = GetDefault<UBH_PluginSettings>();
+    PlayingCap = (int64)FMath::Max(Settings->UploadBandwidthLimitKbps, 0) * 1000 / 8;
+    IdleCap = (int64)FMath::Max(Settings->IdleUploadBandwidthLimitKbps, 0) * 1000 / 8;
+    bAdaptive = Settings->bAdaptiveUploadBandwidth;
+
+    SetRate(IdleCap);
+
+    if (PlayingCap > 0 || IdleCap > 0 || bAdaptive)
+    {
+        TickHandle = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateRaw(this, &BH_BandwidthLimiter::Tick), TickIntervalSeconds);
+    }
+}
+
+void BH_BandwidthLimiter::WhenAvailable(int64 Bytes, TFunction<void()>&& Callback)
+{
+    check(IsInGameThread());
+
+    double WaitSeconds = 0.0;
+    if (TryAcquire(Bytes, WaitSeconds))
+    {
+        Callback();
+        return;
+    }
+
+    // Checked again in short steps, so a rate raised in the meantime is picked up
+    FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda(
+        [this, Bytes, Callback = MoveTemp(Callback)](float DeltaTime) mutable
+        {
+            WhenAvailable(Bytes, MoveTemp(Callback));
+            return false;
+        }), (float)FMath::Clamp(WaitSeconds, 0.05, 0.5));
+}
+
+bool BH_BandwidthLimiter::TryAcquire(int64 Bytes, double& OutWaitSeconds)
+{
+    FScopeLock Lock(&Mutex);
+    if (Rate <= 0)
+    {
+        return true;
+    }
+
+    Refill();
+
+    // A request larger than the bucket goes once the bucket is full and leaves it in debt
+    if (Tokens >= (double)FMath::Min(Bytes, BurstBytes))
+    {
+        Tokens -= (double)Bytes;
+        return true;
+    }
+
+    OutWaitSeconds = ((double)FMath::Min(Bytes, BurstBytes) - Tokens) / (double)Rate;
+    return false;
+}
+
+void BH_BandwidthLimiter::AddSentBytes(int64 Bytes)
+{
+    FScopeLock Lock(&Mutex);
+    BytesSinceTick += Bytes;
+}
+
+bool BH_BandwidthLimiter::IsLimited() const
+{
+    FScopeLock Lock(&Mutex);
+    return Rate > 0;
+}
+
+bool BH_BandwidthLimiter::Tick(float DeltaTime)
+{
+    int64 SentBytes;
+    int64 CurrentRate;
+    {
+        FScopeLock Lock(&Mutex);
+        SentBytes = BytesSinceTick;
+        BytesSinceTick = 0;
+        CurrentRate = Rate;
+    }
+
+    float RttMs = 0.0f;
+    float Loss = 0.0f;
+    const bool bPlaying = SampleConnections(RttMs, Loss) && !IsPlayerIdle();
+    const int64 Cap = bPlaying ? PlayingCap : IdleCap;
+
+    if (!bAdaptive || !bPlaying)
+    {
+        AdaptiveRate = 0;
+        BaselineRttMs = 0.0f;
+        if (CurrentRate != Cap)
+        {
+            SetRate(Cap);
+        }
+        return true;
+    }
+
+    // The lowest round-trip time seen is the baseline, it drifts up slowly in case the route changed
+    BaselineRttMs = BaselineRttMs <= 0.0f ? RttMs : FMath::Min(RttMs, BaselineRttMs * 1.01f);
+
+    const bool bCongested = Loss > CongestedLoss || RttMs > BaselineRttMs * CongestedRttFactor + CongestedRttMarginMs;
+    const int64 SentRate = (int64)((double)SentBytes / FMath::Max((double)DeltaTime, 0.001));
+
+    if (AdaptiveRate == 0)
+    {
+        // Entering a session, or still unlimited
+        AdaptiveRate = Cap;
+    }
+
+    // Only back off when uploads are running, a congested connection without them is not caused by us
+    if (bCongested && SentRate > 0)
+    {
+        const int64 From = AdaptiveRate > 0 ? FMath::Min(AdaptiveRate, SentRate) : SentRate;
+        AdaptiveRate = FMath::Max(From * 7 / 10, MinAdaptiveRate);
+        UE_LOG(LogBetaHub, Verbose, TEXT("Connection congested (RTT %.0f ms, baseline %.0f ms, loss %.1f%%), uploading at %lld KB/s"),
+            RttMs, BaselineRttMs, Loss * 100.0f, AdaptiveRate / 1024);
+    }
+    else if (!bCongested && AdaptiveRate > 0)
+    {
+        AdaptiveRate += FMath::Max(AdaptiveRate / 10, MinAdaptiveRate / 2);
+    }
+
+    if (Cap > 0)
+    {
+        AdaptiveRate = FMath::Min(AdaptiveRate, Cap);
+    }
+
+    if (CurrentRate != AdaptiveRate)
+    {
+        SetRate(AdaptiveRate);
+    }
+    return true;
+}
+
+void BH_BandwidthLimiter::SetRate(int64 BytesPerSecond)
+{
+    FScopeLock Lock(&Mutex);
+    Refill();
+    Rate = BytesPerSecond;
+    BurstBytes = FMath::Max(Rate / 4, MinBurstBytes);
+    Tokens = FMath::Min(Tokens, (double)BurstBytes);
+}
+
+void BH_BandwidthLimiter::Refill()
+{
+    const double Now = FPlatformTime::Seconds();
+    Tokens = FMath::Min(Tokens + (Now - LastRefillTime) * (double)Rate, (double)BurstBytes);
+    LastRefillTime = Now;
+}
+
+bool BH_BandwidthLimiter::SampleConnections(float& OutRttMs, float& OutLoss) const
+{
+    if (!GEngine)
+    {
+        return false;
+    }
+
+    bool bFound = false;
+    auto SampleConnection = [&bFound, &OutRttMs, &OutLoss](const UNetConnection* Connection)
+    {
+        if (!Connection || Connection->GetConnectionState() != USOCK_Open)
+        {
+            return;
+        }
+
+        OutRttMs = FMath::Max(OutRttMs, Connection->AvgLag * 1000.0f);
+        OutLoss = FMath::Max3(OutLoss,
+            Connection->GetInLossPercentage().GetAvgLossPercentage(),
+            Connection->GetOutLossPercentage().GetAvgLossPercentage());
+        bFound = true;
+    };
+
+    for (const FWorldContext& Context : GEngine->GetWorldContexts())
+    {
+        const UWorld* World = Context.World();
+        if (!World || !World->IsGameWorld())
+        {
+            continue;
+        }
+
+        const UNetDriver* NetDriver = World->GetNetDriver();
+        if (!NetDriver)
+        {
+            continue;
+        }
+
+        SampleConnection(NetDriver->ServerConnection);
+        for (const UNetConnection* Connection : NetDriver->ClientConnections)
+        {
+            SampleConnection(Connection);
+        }
+    }
+
+    return bFound;
+}
+
+bool BH_BandwidthLimiter::IsPlayerIdle() const
+{
+    // Pause menus pause the world
+    for (const FWorldContext& Context : GEngine->GetWorldContexts())
+    {
+        const UWorld* World = Context.World();
+        if (World && World->IsGameWorld() && World->IsPaused())
+        {
+            return true;
+        }
+    }
+
+    return FSlateApplication::IsInitialized()
+        && FPlatformTime::Seconds() - FSlateApplication::Get().GetLastUserInteractionTime() > IdleSeconds;
+}
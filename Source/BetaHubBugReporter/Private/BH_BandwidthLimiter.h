@@ -0,0 +1,86 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "HAL/CriticalSection.h"
+
+/**
+ * Token bucket shared by the S3 uploads of all reports, so a report sent mid-match does not saturate the
+ * player's uplink. The rate is capped while the player is in a network session and active, and capped
+ * separately in menus, while paused or idle. In adaptive mode the rate in a session follows the game's
+ * connections: it backs off when their round-trip time rises or packets get lost while uploads are
+ * running, and ramps up again when the connection recovers.
+ *
+ * Uploads are paced per request: a request is started once the bucket allows it, and the next one waits until the
+ * bucket has recovered. Nothing waits on an HTTP thread, which libcurl shares with every other request of the
+ * process, so a request is sent at line speed once started. To keep those bursts short, S3 uploads larger than
+ * a part are split into parts of the smallest size S3 accepts while the rate is limited (see IsLimited).
+ * Created at module startup. Game thread only, except AddSentBytes.
+ */
+class BH_BandwidthLimiter
+{
+public:
+    static BH_BandwidthLimiter& Get();
+
+    /**
+     * Calls Callback on the game thread once a request of Bytes may be started, right away while the rate is unlimited
+     */
+    void WhenAvailable(int64 Bytes, TFunction<void()>&& Callback);
+
+    /**
+     * Records bytes actually sent by an upload, for the adaptive rate. Called from request progress.
+     */
+    void AddSentBytes(int64 Bytes);
+
+    /**
+     * True while the rate is limited, uploads are then split into small requests
+     */
+    bool IsLimited() const;
+
+private:
+    BH_BandwidthLimiter();
+
+    bool Tick(float DeltaTime);
+
+    /**
+     * Sets the rate in bytes per second, 0 is unlimited
+     */
+    void SetRate(int64 BytesPerSecond);
+
+    void Refill();
+
+    /**
+     * Takes Bytes from the bucket if a request of that size may start now
+     *
+     * @param OutWaitSeconds    How long until it may, if not
+     */
+    bool TryAcquire(int64 Bytes, double& OutWaitSeconds);
+
+    /**
+     * Highest round-trip time and packet loss (0-1) of the open connections of the game worlds
+     *
+     * @return              False if there is no network session
+     */
+    bool SampleConnections(float& OutRttMs, float& OutLoss) const;
+
+    bool IsPlayerIdle() const;
+
+    mutable FCriticalSection Mutex;
+    double Tokens;
+    double LastRefillTime;
+    int64 Rate;
+    int64 BurstBytes;
+    int64 BytesSinceTick;
+
+    // From the plugin settings, in bytes per second, 0 is unlimited
+    int64 PlayingCap;
+    int64 IdleCap;
+    bool bAdaptive;
+
+    // Adaptive state, game thread only
+    int64 AdaptiveRate;
+    float BaselineRttMs;
+
+    FTSTicker::FDelegateHandle TickHandle;
+};
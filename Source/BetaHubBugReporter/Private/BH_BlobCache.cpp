@@ -0,0 +1,152 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "BH_BlobCache.h"
+#include "BH_PluginSettings.h"
+#include "BH_StorageManager.h"
+#include "BH_Log.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/FileHelper.h"
+
+// Oldest entries are dropped beyond this, a tester attaches far fewer files within the expiry time
+static const int32 MaxCacheEntries = 512;
+
+BH_BlobCache& BH_BlobCache::Get()
+{
+    static BH_BlobCache Instance;
+    return Instance;
+}
+
+BH_BlobCache::BH_BlobCache()
+{
+    check(IsInGameThread());
+
+    TimeToLive = FTimespan::FromHours(FMath::Max(GetDefault<UBH_PluginSettings>()->UploadCacheHours, 0));
+    if (TimeToLive > FTimespan::Zero())
+    {
+        Load();
+    }
+}
+
+FString BH_BlobCache::MakeKey(
+    const FString& BaseUrl,
+    const FString& ProjectId,
+    const FString& MediaEndpoint,
+    const FString& ChecksumAlgorithm,
+    const FString& Checksum,
+    int64 FileSize,
+    const FString& ContentEncoding)
+{
+    return FString::Printf(TEXT("%s|%s|%s|%s:%s|%lld|%s"),
+        *BaseUrl, *ProjectId, *MediaEndpoint, *ChecksumAlgorithm, *Checksum, FileSize, *ContentEncoding);
+}
+
+FString BH_BlobCache::Find(const FString& Key) const
+{
+    check(IsInGameThread());
+
+    const FEntry* Entry = Entries.Find(Key);
+    return Entry && Entry->Expires > FDateTime::UtcNow() ? Entry->BlobSignedId : FString();
+}
+
+void BH_BlobCache::Add(const FString& Key, const FString& BlobSignedId)
+{
+    check(IsInGameThread());
+
+    if (TimeToLive <= FTimespan::Zero() || BlobSignedId.IsEmpty())
+    {
+        return;
+    }
+
+    FEntry& Entry = Entries.FindOrAdd(Key);
+    Entry.BlobSignedId = BlobSignedId;
+    Entry.Expires = FDateTime::UtcNow() + TimeToLive;
+
+    if (Entries.Num() > MaxCacheEntries)
+    {
+        Entries.ValueSort([](const FEntry& A, const FEntry& B) { return A.Expires > B.Expires; });
+        TArray<FString> Keys;
+        Entries.GetKeys(Keys);
+        for (int32 Index = MaxCacheEntries; Index < Keys.Num(); ++Index)
+        {
+            Entries.Remove(Keys[Index]);
+        }
+    }
+
+    Save();
+}
+
+void BH_BlobCache::Remove(const FString& Key)
+{
+    check(IsInGameThread());
+
+    if (Entries.Remove(Key) > 0)
+    {
+        Save();
+    }
+}
+
+void BH_BlobCache::Load()
+{
+    FString JsonString;
+    if (!FFileHelper::LoadFileToString(JsonString, *GetCachePath()))
+    {
+        return;
+    }
+
+    TSharedPtr<FJsonObject> Cache;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+    if (!FJsonSerializer::Deserialize(Reader, Cache) || !Cache.IsValid())
+    {
+        return;
+    }
+
+    // Expired entries are not loaded, and are dropped from the file with the next save
+    const FDateTime Now = FDateTime::UtcNow();
+    for (const auto& Pair : Cache->Values)
+    {
+        const TSharedPtr<FJsonObject>* EntryObject;
+        FString Expires;
+        FEntry Entry;
+        if (Pair.Value->TryGetObject(EntryObject)
+            && (*EntryObject)->TryGetStringField(TEXT("blob_signed_id"), Entry.BlobSignedId)
+            && (*EntryObject)->TryGetStringField(TEXT("expires"), Expires)
+            && FDateTime::ParseIso8601(*Expires, Entry.Expires)
+            && Entry.Expires > Now)
+        {
+            // A shorter expiry set since the entry was written applies too
+            Entry.Expires = FMath::Min(Entry.Expires, Now + TimeToLive);
+            Entries.Add(Pair.Key, Entry);
+        }
+    }
+
+    UE_LOG(LogBetaHub, Verbose, TEXT("Loaded %d cached uploads"), Entries.Num());
+}
+
+void BH_BlobCache::Save() const
+{
+    TSharedPtr<FJsonObject> Cache = MakeShareable(new FJsonObject);
+    const FDateTime Now = FDateTime::UtcNow();
+    for (const TPair<FString, FEntry>& Pair : Entries)
+    {
+        if (Pair.Value.Expires > Now)
+        {
+            TSharedPtr<FJsonObject> EntryObject = MakeShareable(new FJsonObject);
+            EntryObject->SetStringField(TEXT("blob_signed_id"), Pair.Value.BlobSignedId);
+            EntryObject->SetStringField(TEXT("expires"), Pair.Value.Expires.ToIso8601());
+            Cache->SetObjectField(Pair.Key, EntryObject);
+        }
+    }
+
+    FString JsonString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+    FJsonSerializer::Serialize(Cache.ToSharedRef(), Writer);
+
+    // A crash mid-write must not corrupt the cache
+    BH_StorageManager::SaveStringToFileAtomic(JsonString, GetCachePath());
+}
+
+FString BH_BlobCache::GetCachePath()
+{
+    return BH_StorageManager::GetUploadStateDir() / TEXT("blob_cache.json");
+}
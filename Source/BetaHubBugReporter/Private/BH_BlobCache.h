@@ -0,0 +1,65 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Remembers the blobs of files uploaded with earlier reports by their content, so a file attached to
+ * several reports (the same screenshot, an unchanged log) is uploaded once and referenced by its signed id
+ * afterwards. Persisted across sessions, entries expire after UploadCacheHours.
+ *
+ * Only blobs that were confirmed are added, those are attached to an issue and kept by BetaHub.
+ * Game thread only.
+ */
+class BH_BlobCache
+{
+public:
+    static BH_BlobCache& Get();
+
+    /**
+     * Identifies uploaded content: the same bytes, sent the same way, to the same kind of attachment of a project
+     *
+     * @param BaseUrl           BetaHub API base URL
+     * @param Checksum          Checksum of the uploaded bytes (after compression), as sent to the API
+     * @param ContentEncoding   "gzip" for compressed content, empty otherwise
+     */
+    static FString MakeKey(
+        const FString& BaseUrl,
+        const FString& ProjectId,
+        const FString& MediaEndpoint,
+        const FString& ChecksumAlgorithm,
+        const FString& Checksum,
+        int64 FileSize,
+        const FString& ContentEncoding
+    );
+
+    /**
+     * @return              Signed id of the blob with this content, empty if it is not cached or has expired
+     */
+    FString Find(const FString& Key) const;
+
+    void Add(const FString& Key, const FString& BlobSignedId);
+
+    /**
+     * Forgets a blob the API no longer accepts
+     */
+    void Remove(const FString& Key);
+
+private:
+    BH_BlobCache();
+
+    void Load();
+    void Save() const;
+
+    static FString GetCachePath();
+
+    struct FEntry
+    {
+        FString BlobSignedId;
+        FDateTime Expires;
+    };
+    TMap<FString, FEntry> Entries;
+
+    // Zero when the cache is disabled
+    FTimespan TimeToLive;
+};
@@ -5,11 +5,15 @@
 #include "BH_PopupWidget.h"
 #include "BH_PluginSettings.h"
 #include "BH_GameRecorder.h"
-#include "BH_MediaUploadManager.h"
+#include "BH_VideoEncoder.h"
+#include "BH_UploadJournal.h"
+#include "BH_StorageManager.h"
+#include "BH_LogCapture.h"
 #include "Json.h"
 #include "Async/Async.h"
 #include "Misc/Paths.h"
 #include "HAL/PlatformFilemanager.h"
+#include "HAL/FileManager.h"
 #include "Misc/FileHelper.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpRequest.h"
@@ -18,6 +22,9 @@
 #include "Interfaces/IHttpResponse.h"
 #include "Serialization/JsonSerializer.h"
 #include "Serialization/JsonWriter.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+#include "Misc/SecureHash.h"
 
 UBH_BugReport::UBH_BugReport()
 {
@@ -45,40 +52,819 @@ void UBH_BugReport::SubmitReportWithMedia(
         OnSuccess, OnFailure, ReleaseLabel, ReleaseId, CustomFields);
 }
 
+/**
+ * A file of a report staged off the game thread, so joining the media only moves it into the upload journal
+ */
+struct FBH_StagedFile
+{
+    EBH_MediaType MediaType;
+    FBH_MediaFile File;
+    FString FileName;           // Name it is stored and uploaded with, the staged copy has a unique name
+    bool bOwned;                // A copy made for the report, otherwise the file of the game could not be copied
+};
+
+struct FBH_DraftResult
+{
+    FString IssueId;            // g-<id>, empty if the draft was not created
+    FString ApiToken;
+    FString Error;
+};
+
+struct FBH_RecordedVideo
+{
+    FString VideoPath;
+    FString ProxyPath;
+};
+
+/**
+ * A report submitted with SubmitReportWithMedia. Its stages (creating the draft, saving the recording,
+ * staging the media, encoding screenshots) run at the same time and are joined on the game thread,
+ * the media is uploaded once the last one the report waits for is done.
+ */
+struct FBH_ReportSubmission
+{
+    TSharedPtr<BH_HttpRequest> DraftRequest;
+    bool bVideoAfterPublishing = false;
+
+    // Stage results, set on the game thread
+    TOptional<FBH_DraftResult> Draft;
+    TOptional<FBH_RecordedVideo> Video;
+    TArray<FBH_StagedFile> StagedFiles;
+    int32 PendingMediaStages = 0;
+
+    bool bJoined = false;           // The media is in the upload journal
+    bool bVideoAdded = false;       // The recording is in the upload journal or deleted
+    bool bAborted = false;          // Failed before the join or cancelled, results arriving later are discarded
+    bool bDraftDiscarded = false;
+    bool bFinished = false;         // OnSuccess or OnFailure was called
+    TFunction<void()> OnSuccess;
+    TFunction<void(const FString&)> OnFailure;
+};
+
+namespace
+{
+    /**
+     * Formats the captured logs of the files into their contents, on a worker thread
+     */
+    void FormatLogSnapshots(TArray<FBH_MediaFile>& Files)
+    {
+        for (FBH_MediaFile& File : Files)
+        {
+            if (File.LogSnapshot.IsValid())
+            {
+                File.Content = File.LogSnapshot->ToString();
+                File.LogSnapshot.Reset();
+            }
+        }
+    }
+
+    /**
+     * Formats captured logs, writes log contents and copies the files of the game to the temp directory, on a worker thread
+     */
+    TArray<FBH_StagedFile> StageMedia(const TArray<FBH_MediaFile>& Videos, const TArray<FBH_MediaFile>& Screenshots, const TArray<FBH_MediaFile>& Logs)
+    {
+        IFileManager& FileManager = IFileManager::Get();
+        const FString TempDir = BH_StorageManager::GetTempDir();
+        FileManager.MakeDirectory(*TempDir, true);
+
+        TArray<FBH_StagedFile> Staged;
+        auto StageFiles = [&](EBH_MediaType MediaType, const TArray<FBH_MediaFile>& Files)
+        {
+            for (const FBH_MediaFile& File : Files)
+            {
+                FBH_StagedFile& Result = Staged.AddDefaulted_GetRef();
+                Result.MediaType = MediaType;
+                Result.File = File;
+                Result.bOwned = false;
+
+                if (!File.FilePath.IsEmpty())
+                {
+                    Result.FileName = FPaths::GetCleanFilename(File.FilePath);
+                    const FString StagedPath = TempDir / FString::Printf(TEXT("staged_%s_%s"), *FGuid::NewGuid().ToString(EGuidFormats::Digits), *Result.FileName);
+                    if (FileManager.Copy(*StagedPath, *File.FilePath, true, true) == COPY_OK)
+                    {
+                        Result.File.FilePath = StagedPath;
+                        Result.bOwned = true;
+                    }
+                }
+                else if (!File.Content.IsEmpty())
+                {
+                    // Written once as UTF-8, the same bytes are uploaded later without another conversion
+                    Result.FileName = TEXT("log.log");
+                    const FString StagedPath = TempDir / FString::Printf(TEXT("staged_%s.log"), *FGuid::NewGuid().ToString(EGuidFormats::Digits));
+                    if (FFileHelper::SaveStringToFile(File.Content, *StagedPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+                    {
+                        Result.File.FilePath = StagedPath;
+                        Result.File.Content.Empty();
+                        Result.bOwned = true;
+                    }
+                }
+            }
+        };
+
+        StageFiles(EBH_MediaType::Video, Videos);
+        StageFiles(EBH_MediaType::Screenshot, Screenshots);
+        TArray<FBH_MediaFile> FormattedLogs = Logs;
+        FormatLogSnapshots(FormattedLogs);
+        StageFiles(EBH_MediaType::LogFile, FormattedLogs);
+        return Staged;
+    }
+}
+
 void UBH_BugReport::SubmitReportWithMediaAsync(
     UBH_PluginSettings* Settings,
-    UBH_GameRecorder* GameRecorder,
+    UBH_GameRecorder* GameRecorder,
+    const FString& Description,
+    const FString& StepsToReproduce,
+    const TArray<FBH_MediaFile>& Videos,
+    const TArray<FBH_MediaFile>& Screenshots,
+    const TArray<FBH_MediaFile>& Logs,
+    TFunction<void()> OnSuccess,
+    TFunction<void(const FString&)> OnFailure,
+    const FString& ReleaseLabel,
+    const FString& ReleaseId,
+    const TMap<FString, FBH_CustomFieldValue>& CustomFields
+    )
+{
+    if (!Settings)
+    {
+        UE_LOG(LogBetaHub, Error, TEXT("Settings is null"));
+        AsyncTask(ENamedThreads::GameThread, [OnFailure]() {
+            OnFailure(TEXT("Invalid settings"));
+        });
+        return;
+    }
+
+    if (Settings->ProjectToken.IsEmpty())
+    {
+        UE_LOG(LogBetaHub, Error, TEXT("ProjectToken is not configured. Cannot submit bug report."));
+        AsyncTask(ENamedThreads::GameThread, [OnFailure]() {
+            OnFailure(TEXT("Project Token is not configured. Please set it in the BetaHub plugin settings."));
+        });
+        return;
+    }
+
+    TSharedRef<FBH_ReportSubmission> State = MakeShared<FBH_ReportSubmission>();
+    State->bVideoAfterPublishing = Settings->bUploadVideoAfterPublishing;
+    State->OnSuccess = OnSuccess;
+    State->OnFailure = OnFailure;
+    Submission = State;
+
+    // None of the stages depends on another, the report waits for the longest one instead of all of them in turn
+
+    // Draft issue, the media is attached to it before it is published
+    TSharedRef<TPromise<FBH_DraftResult>> DraftPromise = MakeShared<TPromise<FBH_DraftResult>>();
+    State->DraftRequest = CreateDraftRequest(Settings, Description, StepsToReproduce, ReleaseLabel, ReleaseId, CustomFields, Signature);
+    State->DraftRequest->ProcessRequest([DraftPromise](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+    {
+        FBH_DraftResult Result;
+        if (bWasSuccessful && Response.IsValid() && (Response->GetResponseCode() == 200 || Response->GetResponseCode() == 201))
+        {
+            FString ContentAsString = Response->GetContentAsString();
+            FString IssueId = UBH_BugReport::ParseIssueIdFromResponse(ContentAsString);
+            if (!IssueId.IsEmpty())
+            {
+                UE_LOG(LogBetaHub, Log, TEXT("Draft issue created successfully with ID: %s"), *IssueId);
+                Result.IssueId = FString::Printf(TEXT("g-%s"), *IssueId);
+                Result.ApiToken = UBH_BugReport::ParseTokenFromResponse(ContentAsString);
+            }
+            else
+            {
+                UE_LOG(LogBetaHub, Error, TEXT("Failed to parse Issue ID from response: %s"), *ContentAsString);
+                Result.Error = FString::Printf(TEXT("Failed to parse Issue ID from response: %s"), *ContentAsString);
+            }
+        }
+        else
+        {
+            // Handle failure case
+            Result.Error = TEXT("Unknown error submitting bug report.");
+            FString ResponseContentForLog = TEXT("No response content available.");
+            if (Response.IsValid())
+            {
+                ResponseContentForLog = Response->GetContentAsString();
+                Result.Error = UBH_BugReport::ParseErrorFromResponse(ResponseContentForLog);
+            }
+            else if (!bWasSuccessful)
+            {
+                Result.Error = TEXT("HTTP request failed (bWasSuccessful is false).");
+                ResponseContentForLog = Result.Error;
+            }
+
+            UE_LOG(LogBetaHub, Error, TEXT("Failed to submit bug report: %s"), *ResponseContentForLog);
+        }
+        DraftPromise->SetValue(MoveTemp(Result));
+    });
+
+    const FString BaseUrl = Settings->ApiEndpoint;
+    const FString ProjectId = Settings->ProjectId;
+    JoinStage(State, DraftPromise->GetFuture(), [BaseUrl, ProjectId](FBH_ReportSubmission& Report, FBH_DraftResult&& Draft)
+    {
+        // From here on the report survives a crash or a failed upload
+        if (!Draft.IssueId.IsEmpty())
+        {
+            BH_UploadJournal::Get().BeginReport(BaseUrl, ProjectId, Draft.IssueId, Draft.ApiToken);
+        }
+        Report.Draft = MoveTemp(Draft);
+        Report.DraftRequest.Reset();
+    });
+
+    // Recording, with bUploadVideoAfterPublishing the report does not wait for it
+    if (GameRecorder)
+    {
+        UE_LOG(LogBetaHub, Log, TEXT("GameRecorder provided, saving the video while the draft is created..."));
+
+        TSharedRef<TPromise<FBH_RecordedVideo>> VideoPromise = MakeShared<TPromise<FBH_RecordedVideo>>();
+        SaveRecordedVideo(GameRecorder, Settings, true, [VideoPromise](const FString& VideoPath, const FString& ProxyPath)
+        {
+            VideoPromise->SetValue(FBH_RecordedVideo{ VideoPath, ProxyPath });
+        });
+
+        JoinStage(State, VideoPromise->GetFuture(), [](FBH_ReportSubmission& Report, FBH_RecordedVideo&& Video)
+        {
+            Report.Video = MoveTemp(Video);
+        });
+    }
+    else
+    {
+        State->Video.Emplace();
+    }
+
+    // Media given by the caller, written and copied on a worker thread instead of in the journal on the game thread
+    State->PendingMediaStages++;
+    JoinStage(State,
+        Async(EAsyncExecution::ThreadPool, [Videos, Screenshots, Logs]() { return StageMedia(Videos, Screenshots, Logs); }),
+        [](FBH_ReportSubmission& Report, TArray<FBH_StagedFile>&& Files)
+        {
+            Report.StagedFiles.Append(MoveTemp(Files));
+            Report.PendingMediaStages--;
+        });
+
+    // Screenshots still being encoded
+    for (TFuture<FString>& Screenshot : PendingScreenshots)
+    {
+        State->PendingMediaStages++;
+        JoinStage(State, MoveTemp(Screenshot), [](FBH_ReportSubmission& Report, FString&& ScreenshotPath)
+        {
+            if (!ScreenshotPath.IsEmpty())
+            {
+                FBH_StagedFile& Staged = Report.StagedFiles.AddDefaulted_GetRef();
+                Staged.MediaType = EBH_MediaType::Screenshot;
+                Staged.File.FilePath = ScreenshotPath;
+                Staged.bOwned = true;
+            }
+            Report.PendingMediaStages--;
+        });
+    }
+    PendingScreenshots.Empty();
+}
+
+template <typename ResultType, typename ApplyType>
+void UBH_BugReport::JoinStage(const TSharedRef<FBH_ReportSubmission>& State, TFuture<ResultType>&& Stage, ApplyType Apply)
+{
+    Stage.Next([State, Apply](ResultType Result)
+    {
+        AsyncTask(ENamedThreads::GameThread, [State, Apply, Result = MoveTemp(Result)]() mutable
+        {
+            Apply(*State, MoveTemp(Result));
+            AdvanceSubmission(State);
+        });
+    });
+}
+
+void UBH_BugReport::AdvanceSubmission(const TSharedRef<FBH_ReportSubmission>& State)
+{
+    BH_UploadJournal& Journal = BH_UploadJournal::Get();
+
+    if (State->bAborted)
+    {
+        DiscardSubmission(State);
+        return;
+    }
+
+    if (State->bJoined)
+    {
+        // The recording goes up after publishing, it was still being saved when the report was joined
+        if (State->Video.IsSet() && !State->bVideoAdded)
+        {
+            State->bVideoAdded = true;
+            AddReportArtifacts(State->Draft->IssueId, TArray<FBH_MediaFile>(), TArray<FBH_MediaFile>(), TArray<FBH_MediaFile>(),
+                State->Video->VideoPath, State->Video->ProxyPath, true);
+            Journal.EndExpectedArtifacts(State->Draft->IssueId);
+        }
+        return;
+    }
+
+    if (State->Draft.IsSet() && State->Draft->IssueId.IsEmpty())
+    {
+        AbortSubmission(State, State->Draft->Error);
+        return;
+    }
+
+    if (!State->Draft.IsSet() || State->PendingMediaStages > 0 || (!State->Video.IsSet() && !State->bVideoAfterPublishing))
+    {
+        return;
+    }
+
+    const FString IssueId = State->Draft->IssueId;
+    for (const FBH_StagedFile& Staged : State->StagedFiles)
+    {
+        // Videos of the game are held back like the recording
+        const bool bDeferred = Staged.MediaType == EBH_MediaType::Video && State->bVideoAfterPublishing;
+        Journal.AddArtifact(IssueId, Staged.MediaType, Staged.File, Staged.bOwned, bDeferred, Staged.FileName);
+    }
+    State->StagedFiles.Empty();
+
+    if (State->Video.IsSet())
+    {
+        State->bVideoAdded = true;
+        AddReportArtifacts(IssueId, TArray<FBH_MediaFile>(), TArray<FBH_MediaFile>(), TArray<FBH_MediaFile>(),
+            State->Video->VideoPath, State->Video->ProxyPath, State->bVideoAfterPublishing);
+    }
+    else
+    {
+        // The journal is not tied to the world, the video is uploaded across level transitions
+        UE_LOG(LogBetaHub, Log, TEXT("The video is attached after publishing..."));
+        Journal.ExpectArtifacts(IssueId);
+    }
+    State->bJoined = true;
+
+    UE_LOG(LogBetaHub, Log, TEXT("Starting media uploads..."));
+    Journal.ProcessReport(IssueId,
+        [State]()
+        {
+            if (!State->bFinished)
+            {
+                State->bFinished = true;
+                State->OnSuccess();
+            }
+        },
+        [State](const FString& Error)
+        {
+            if (!State->bFinished)
+            {
+                State->bFinished = true;
+                State->OnFailure(Error);
+            }
+        });
+}
+
+void UBH_BugReport::AbortSubmission(const TSharedRef<FBH_ReportSubmission>& State, const FString& Error)
+{
+    State->bAborted = true;
+    DiscardSubmission(State);
+
+    if (!State->bFinished)
+    {
+        State->bFinished = true;
+        State->OnFailure(Error);
+    }
+}
+
+void UBH_BugReport::DiscardSubmission(const TSharedRef<FBH_ReportSubmission>& State)
+{
+    IFileManager& FileManager = IFileManager::Get();
+
+    // Also cancels the uploads of a report that was already joined
+    if (State->Draft.IsSet() && !State->Draft->IssueId.IsEmpty() && !State->bDraftDiscarded)
+    {
+        State->bDraftDiscarded = true;
+        BH_UploadJournal::Get().DiscardReport(State->Draft->IssueId);
+    }
+
+    for (const FBH_StagedFile& Staged : State->StagedFiles)
+    {
+        if (Staged.bOwned)
+        {
+            FileManager.Delete(*Staged.File.FilePath, false, false, true);
+        }
+    }
+    State->StagedFiles.Empty();
+
+    if (State->Video.IsSet() && !State->bVideoAdded)
+    {
+        State->bVideoAdded = true;
+        FileManager.Delete(*State->Video->VideoPath, false, false, true);
+        FileManager.Delete(*State->Video->ProxyPath, false, false, true);
+    }
+}
+
+void UBH_BugReport::CancelSubmission()
+{
+    if (!Submission.IsValid() || Submission->bFinished)
+    {
+        return;
+    }
+
+    TSharedRef<FBH_ReportSubmission> State = Submission.ToSharedRef();
+    UE_LOG(LogBetaHub, Log, TEXT("Report submission cancelled"));
+
+    if (State->DraftRequest.IsValid())
+    {
+        State->DraftRequest->CancelRequest();
+    }
+    AbortSubmission(State, TEXT("Submission cancelled"));
+}
+
+void UBH_BugReport::AddPendingScreenshot(TFuture<FString>&& Screenshot)
+{
+    PendingScreenshots.Add(MoveTemp(Screenshot));
+}
+
+struct FBH_SpeculativeReport
+{
+    TWeakObjectPtr<UBH_PluginSettings> Settings;
+    TWeakObjectPtr<UBH_GameRecorder> GameRecorder;
+    TArray<FBH_MediaFile> Screenshots;
+    TArray<FBH_MediaFile> Logs;
+    bool bVideoAfterPublishing = false;
+
+    FString IssueId;                // Set once the draft is created
+    bool bDraftFailed = false;
+    bool bMediaReady = false;       // The media is in the upload journal
+    bool bAbandoned = false;
+
+    // Set by FinishSpeculativeReport
+    bool bSubmitted = false;
+    FString Description;
+    FString StepsToReproduce;
+    bool bIncludeVideo = false;
+    bool bIncludeScreenshots = false;
+    bool bIncludeLogs = false;
+    TFunction<void()> OnSuccess;
+    TFunction<void(const FString&)> OnFailure;
+};
+
+void UBH_BugReport::BeginSpeculativeReport(
+    UBH_PluginSettings* Settings,
+    UBH_GameRecorder* GameRecorder,
+    const TArray<FBH_MediaFile>& Screenshots,
+    const TArray<FBH_MediaFile>& Logs)
+{
+    TSharedRef<FBH_SpeculativeReport> State = MakeShared<FBH_SpeculativeReport>();
+    State->Settings = Settings;
+    State->GameRecorder = GameRecorder;
+    State->Screenshots = Screenshots;
+    State->Logs = Logs;
+    Speculative = State;
+
+    if (!Settings || Settings->ProjectToken.IsEmpty())
+    {
+        // Submitted the regular way, which reports the configuration error
+        State->bDraftFailed = true;
+        return;
+    }
+    State->bVideoAfterPublishing = Settings->bUploadVideoAfterPublishing;
+
+    // The text is not known yet, it replaces the placeholder when the report is submitted
+    TSharedPtr<BH_HttpRequest> DraftRequest = CreateDraftRequest(Settings, TEXT("Report in progress"), TEXT(""),
+        TEXT(""), TEXT(""), TMap<FString, FBH_CustomFieldValue>(), Signature);
+
+    DraftRequest->ProcessRequest([State, DraftRequest](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+    {
+        AsyncTask(ENamedThreads::GameThread, [State, Response, bWasSuccessful]()
+        {
+            FString IssueId;
+            FString ApiToken;
+            if (bWasSuccessful && Response.IsValid() && (Response->GetResponseCode() == 200 || Response->GetResponseCode() == 201))
+            {
+                IssueId = UBH_BugReport::ParseIssueIdFromResponse(Response->GetContentAsString());
+                ApiToken = UBH_BugReport::ParseTokenFromResponse(Response->GetContentAsString());
+            }
+
+            UBH_PluginSettings* Settings = State->Settings.Get();
+            if (IssueId.IsEmpty() || !Settings)
+            {
+                UE_LOG(LogBetaHub, Warning, TEXT("Failed to create the draft issue ahead of submission, it is created when the report is submitted"));
+                State->bDraftFailed = true;
+                CompleteSpeculativeReport(State);
+                return;
+            }
+
+            State->IssueId = FString::Printf(TEXT("g-%s"), *IssueId);
+            UE_LOG(LogBetaHub, Log, TEXT("Draft issue %s created ahead of submission"), *State->IssueId);
+
+            BH_UploadJournal::Get().BeginReport(Settings->ApiEndpoint, Settings->ProjectId, State->IssueId, ApiToken, true);
+            if (State->bAbandoned)
+            {
+                BH_UploadJournal::Get().DiscardReport(State->IssueId);
+                return;
+            }
+
+            auto StartPreUpload = [State](const FString& VideoPath, const FString& ProxyPath)
+            {
+                // The captured logs are formatted on a worker thread, they can be megabytes
+                Async(EAsyncExecution::ThreadPool, [State, Logs = State->Logs, VideoPath, ProxyPath]() mutable
+                {
+                    FormatLogSnapshots(Logs);
+
+                    AsyncTask(ENamedThreads::GameThread, [State, Logs = MoveTemp(Logs), VideoPath, ProxyPath]()
+                    {
+                        if (State->bAbandoned)
+                        {
+                            // The draft is already discarded, the recording never made it into the journal
+                            IFileManager::Get().Delete(*VideoPath, false, false, true);
+                            IFileManager::Get().Delete(*ProxyPath, false, false, true);
+                            return;
+                        }
+
+                        // A video held back until after publishing is not uploaded ahead, submitting would wait for it
+                        AddReportArtifacts(State->IssueId, TArray<FBH_MediaFile>(), State->Screenshots, Logs, VideoPath, ProxyPath,
+                            State->bVideoAfterPublishing);
+                        State->bMediaReady = true;
+
+                        BH_UploadJournal::Get().PreUploadReport(State->IssueId);
+                        CompleteSpeculativeReport(State);
+                    });
+                });
+            };
+
+            // The recording is stopped while the form is open, it is restarted once the report is submitted
+            if (State->GameRecorder.IsValid())
+            {
+                SaveRecordedVideo(State->GameRecorder, State->Settings, false, StartPreUpload);
+            }
+            else
+            {
+                StartPreUpload(TEXT(""), TEXT(""));
+            }
+        });
+    });
+}
+
+void UBH_BugReport::FinishSpeculativeReport(
+    const FString& Description,
+    const FString& StepsToReproduce,
+    bool bIncludeVideo,
+    bool bIncludeScreenshots,
+    bool bIncludeLogs,
+    TFunction<void()> OnSuccess,
+    TFunction<void(const FString&)> OnFailure)
+{
+    if (!Speculative.IsValid() || Speculative->bSubmitted)
+    {
+        UE_LOG(LogBetaHub, Error, TEXT("FinishSpeculativeReport called without BeginSpeculativeReport"));
+        OnFailure(TEXT("The report was not started"));
+        return;
+    }
+
+    TSharedRef<FBH_SpeculativeReport> State = Speculative.ToSharedRef();
+    State->bSubmitted = true;
+    State->Description = Description;
+    State->StepsToReproduce = StepsToReproduce;
+    State->bIncludeVideo = bIncludeVideo;
+    State->bIncludeScreenshots = bIncludeScreenshots;
+    State->bIncludeLogs = bIncludeLogs;
+    State->OnSuccess = MoveTemp(OnSuccess);
+    State->OnFailure = MoveTemp(OnFailure);
+
+    CompleteSpeculativeReport(State);
+}
+
+void UBH_BugReport::AbandonSpeculativeReport()
+{
+    if (!Speculative.IsValid() || Speculative->bSubmitted)
+    {
+        return;
+    }
+
+    Speculative->bAbandoned = true;
+    if (!Speculative->IssueId.IsEmpty())
+    {
+        UE_LOG(LogBetaHub, Log, TEXT("Report form closed, deleting draft issue %s"), *Speculative->IssueId);
+        BH_UploadJournal::Get().DiscardReport(Speculative->IssueId);
+    }
+    Speculative.Reset();
+}
+
+void UBH_BugReport::CompleteSpeculativeReport(const TSharedRef<FBH_SpeculativeReport>& State)
+{
+    if (!State->bSubmitted || State->bAbandoned)
+    {
+        return;
+    }
+
+    if (State->bDraftFailed)
+    {
+        UBH_BugReport* BugReport = NewObject<UBH_BugReport>();
+        BugReport->SubmitReportWithMedia(
+            State->Settings.Get(),
+            State->bIncludeVideo ? State->GameRecorder.Get() : nullptr,
+            State->Description,
+            State->StepsToReproduce,
+            TArray<FBH_MediaFile>(),
+            State->bIncludeScreenshots ? State->Screenshots : TArray<FBH_MediaFile>(),
+            State->bIncludeLogs ? State->Logs : TArray<FBH_MediaFile>(),
+            State->OnSuccess,
+            State->OnFailure
+        );
+        return;
+    }
+
+    // Called again once the media is in the journal
+    if (!State->bMediaReady)
+    {
+        UE_LOG(LogBetaHub, Log, TEXT("Report submitted, waiting for its video to be saved"));
+        return;
+    }
+
+    BH_UploadJournal& Journal = BH_UploadJournal::Get();
+
+    // Uploaded but never confirmed, so the files the player chose not to send are not attached
+    if (!State->bIncludeVideo)
+    {
+        Journal.RemoveArtifacts(State->IssueId, EBH_MediaType::Video);
+    }
+    if (!State->bIncludeScreenshots)
+    {
+        Journal.RemoveArtifacts(State->IssueId, EBH_MediaType::Screenshot);
+    }
+    if (!State->bIncludeLogs)
+    {
+        Journal.RemoveArtifacts(State->IssueId, EBH_MediaType::LogFile);
+    }
+
+    TSharedRef<FJsonObject> IssueFields = MakeShared<FJsonObject>();
+    IssueFields->SetStringField(TEXT("description"), State->Description);
+    IssueFields->SetStringField(TEXT("unformatted_steps_to_reproduce"), State->StepsToReproduce);
+    Journal.SetIssueFields(State->IssueId, IssueFields);
+
+    UBH_GameRecorder* GameRecorder = State->GameRecorder.Get();
+    UBH_PluginSettings* Settings = State->Settings.Get();
+    if (GameRecorder && Settings)
+    {
+        GameRecorder->StartRecording(Settings->MaxRecordedFrames, Settings->MaxRecordingDuration);
+    }
+
+    UE_LOG(LogBetaHub, Log, TEXT("Submitting report %s, its media was uploaded ahead"), *State->IssueId);
+    Journal.ProcessReport(State->IssueId, State->OnSuccess, State->OnFailure);
+}
+
+FBH_ReportSignature UBH_BugReport::ComputeSignature(const UBH_PluginSettings* Settings, const UWorld* World, const TArray<FString>& Problems)
+{
+    FBH_ReportSignature Result;
+    Result.Problems = Problems;
+    Result.Map = World ? UWorld::RemovePIEPrefix(World->GetMapName()) : FString();
+    Result.Build = Settings && !Settings->ReleaseLabel.IsEmpty() ? Settings->ReleaseLabel : FString(FApp::GetBuildVersion());
+
+    // Every report from the same map and build would match
+    if (Problems.Num() == 0)
+    {
+        return Result;
+    }
+
+    FString Text = Result.Map + TEXT("\n") + Result.Build;
+    for (const FString& Problem : Problems)
+    {
+        Text += TEXT("\n") + Problem;
+    }
+
+    FTCHARToUTF8 TextUtf8(*Text, Text.Len());
+    FSHAHash Hash;
+    FSHA1::HashBuffer(TextUtf8.Get(), TextUtf8.Length(), Hash.Hash);
+    Result.Hash = Hash.ToString().ToLower();
+    return Result;
+}
+
+void UBH_BugReport::SetSignature(const FBH_ReportSignature& InSignature)
+{
+    Signature = InSignature;
+}
+
+void UBH_BugReport::FindDuplicateIssue(
+    UBH_PluginSettings* Settings,
+    const FBH_ReportSignature& Signature,
+    TFunction<void(const FString& IssueId, const FString& IssueTitle)> OnComplete)
+{
+    if (!Settings || Settings->ProjectToken.IsEmpty() || Signature.Hash.IsEmpty())
+    {
+        OnComplete(TEXT(""), TEXT(""));
+        return;
+    }
+
+    TArray<TSharedPtr<FJsonValue>> Problems;
+    for (const FString& Problem : Signature.Problems)
+    {
+        Problems.Add(MakeShareable(new FJsonValueString(Problem)));
+    }
+
+    TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
+    JsonObject->SetStringField(TEXT("signature"), Signature.Hash);
+    JsonObject->SetStringField(TEXT("map"), Signature.Map);
+    JsonObject->SetStringField(TEXT("build"), Signature.Build);
+    JsonObject->SetArrayField(TEXT("problems"), Problems);
+
+    FString JsonString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+    FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
+
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    Request->SetURL(Settings->ApiEndpoint + TEXT("/projects/") + Settings->ProjectId + TEXT("/issues/find_by_signature.json"));
+    Request->SetVerb(TEXT("POST"));
+    Request->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("FormUser %s"), *Settings->ProjectToken));
+    Request->SetHeader(TEXT("BetaHub-Project-ID"), Settings->ProjectId);
+    Request->SetHeader(TEXT("Accept"), TEXT("application/json"));
+    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+    Request->SetContentAsString(JsonString);
+
+    // The player is typing meanwhile, a slow answer is no longer useful
+    Request->SetTimeout(5.0f);
+
+    Request->OnProcessRequestComplete().BindLambda([OnComplete](FHttpRequestPtr HttpRequest, FHttpResponsePtr Response, bool bWasSuccessful)
+    {
+        FString IssueId;
+        FString IssueTitle;
+
+        TSharedPtr<FJsonObject> JsonResponse;
+        const TSharedPtr<FJsonObject>* Issue;
+        if (bWasSuccessful && Response.IsValid() && Response->GetResponseCode() == 200
+            && FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Response->GetContentAsString()), JsonResponse)
+            && JsonResponse.IsValid() && JsonResponse->TryGetObjectField(TEXT("issue"), Issue))
+        {
+            (*Issue)->TryGetStringField(TEXT("id"), IssueId);
+            (*Issue)->TryGetStringField(TEXT("title"), IssueTitle);
+        }
+        else
+        {
+            UE_LOG(LogBetaHub, Verbose, TEXT("No open issue with the signature of this report (%d)"),
+                Response.IsValid() ? Response->GetResponseCode() : 0);
+        }
+
+        AsyncTask(ENamedThreads::GameThread, [OnComplete, IssueId, IssueTitle]()
+        {
+            OnComplete(IssueId, IssueTitle);
+        });
+    });
+    Request->ProcessRequest();
+}
+
+void UBH_BugReport::SubmitDuplicateReport(
+    UBH_PluginSettings* Settings,
+    const FString& IssueId,
     const FString& Description,
     const FString& StepsToReproduce,
-    const TArray<FBH_MediaFile>& Videos,
-    const TArray<FBH_MediaFile>& Screenshots,
-    const TArray<FBH_MediaFile>& Logs,
+    const FString& ScreenshotPath,
     TFunction<void()> OnSuccess,
-    TFunction<void(const FString&)> OnFailure,
-    const FString& ReleaseLabel,
-    const FString& ReleaseId,
-    const TMap<FString, FBH_CustomFieldValue>& CustomFields
-    )
+    TFunction<void(const FString&)> OnFailure)
 {
-    if (!Settings)
+    if (!Settings || Settings->ProjectToken.IsEmpty())
     {
-        UE_LOG(LogBetaHub, Error, TEXT("Settings is null"));
-        AsyncTask(ENamedThreads::GameThread, [OnFailure]() {
-            OnFailure(TEXT("Invalid settings"));
-        });
+        UE_LOG(LogBetaHub, Error, TEXT("ProjectToken is not configured. Cannot submit report."));
+        OnFailure(TEXT("Project Token is not configured. Please set it in the BetaHub plugin settings."));
         return;
     }
 
-    if (Settings->ProjectToken.IsEmpty())
+    TSharedPtr<BH_HttpRequest> Request = MakeShared<BH_HttpRequest>();
+    Request->SetURL(Settings->ApiEndpoint + TEXT("/projects/") + Settings->ProjectId + TEXT("/issues/g-") + IssueId + TEXT("/occurrences.json"));
+    Request->SetVerb("POST");
+
+    Request->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("FormUser %s"), *Settings->ProjectToken));
+    Request->SetHeader(TEXT("BetaHub-Project-ID"), Settings->ProjectId);
+    Request->SetHeader(TEXT("Accept"), TEXT("application/json"));
+
+    Request->AddField(TEXT("occurrence[description]"), Description);
+    Request->AddField(TEXT("occurrence[unformatted_steps_to_reproduce]"), StepsToReproduce);
+    Request->AddField(TEXT("occurrence[signature]"), Signature.Hash);
+    Request->AddField(TEXT("occurrence[build]"), Signature.Build);
+    Request->AddField(TEXT("occurrence[log_excerpt]"), FString::Join(Signature.Problems, TEXT("\n")));
+
+    // The issue already has the video and logs of the first report
+    if (!ScreenshotPath.IsEmpty())
     {
-        UE_LOG(LogBetaHub, Error, TEXT("ProjectToken is not configured. Cannot submit bug report."));
-        AsyncTask(ENamedThreads::GameThread, [OnFailure]() {
-            OnFailure(TEXT("Project Token is not configured. Please set it in the BetaHub plugin settings."));
-        });
-        return;
+        Request->AddFile(TEXT("occurrence[screenshot]"), ScreenshotPath, TEXT("image/jpeg"));
     }
 
-    // Submit the initial bug report without media
+    Request->FinalizeFormData();
+
+    UE_LOG(LogBetaHub, Log, TEXT("Adding report to existing issue %s"), *IssueId);
+
+    Request->ProcessRequest([Request, OnSuccess, OnFailure](FHttpRequestPtr HttpRequest, FHttpResponsePtr Response, bool bWasSuccessful)
+    {
+        AsyncTask(ENamedThreads::GameThread, [Response, bWasSuccessful, OnSuccess, OnFailure]()
+        {
+            if (bWasSuccessful && Response.IsValid() && (Response->GetResponseCode() == 200 || Response->GetResponseCode() == 201))
+            {
+                UE_LOG(LogBetaHub, Log, TEXT("Report added to existing issue"));
+                OnSuccess();
+            }
+            else
+            {
+                const FString Error = Response.IsValid() ? ParseErrorFromResponse(Response->GetContentAsString()) : FString();
+                UE_LOG(LogBetaHub, Error, TEXT("Failed to add report to existing issue: %s"), *Error);
+                OnFailure(Error.IsEmpty() ? TEXT("Failed to submit the report.") : Error);
+            }
+        });
+    });
+}
+
+TSharedPtr<BH_HttpRequest> UBH_BugReport::CreateDraftRequest(
+    UBH_PluginSettings* Settings,
+    const FString& Description,
+    const FString& StepsToReproduce,
+    const FString& ReleaseLabel,
+    const FString& ReleaseId,
+    const TMap<FString, FBH_CustomFieldValue>& CustomFields,
+    const FBH_ReportSignature& Signature)
+{
     TSharedPtr<BH_HttpRequest> InitialRequest = MakeShared<BH_HttpRequest>();
     InitialRequest->SetURL(Settings->ApiEndpoint + TEXT("/projects/") + Settings->ProjectId + TEXT("/issues.json"));
     InitialRequest->SetVerb("POST");
@@ -128,229 +914,126 @@ void UBH_BugReport::SubmitReportWithMediaAsync(
         }
     }
 
+    // Lets later reports of the same problem find this issue
+    if (!Signature.Hash.IsEmpty())
+    {
+        InitialRequest->AddField(TEXT("issue[signature]"), Signature.Hash);
+    }
+
     InitialRequest->FinalizeFormData();
 
-    // Use weak pointers for UObjects to prevent crashes if garbage collected during async operation
-    TWeakObjectPtr<UBH_PluginSettings> WeakSettings = Settings;
-    TWeakObjectPtr<UBH_GameRecorder> WeakGameRecorder = GameRecorder;
+    return InitialRequest;
+}
 
-    InitialRequest->ProcessRequest(
-        [WeakSettings, WeakGameRecorder, Videos, Screenshots, Logs, InitialRequest,
-        OnSuccess, OnFailure]
-        (FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+void UBH_BugReport::SaveRecordedVideo(
+    TWeakObjectPtr<UBH_GameRecorder> WeakGameRecorder,
+    TWeakObjectPtr<UBH_PluginSettings> WeakSettings,
+    bool bRestartRecording,
+    TFunction<void(const FString& VideoPath, const FString& ProxyPath)> OnSaved)
+{
+    // Use AsyncTask - saves video then continues in the same callback
+    AsyncTask(ENamedThreads::GameThread, [WeakGameRecorder, WeakSettings, bRestartRecording, OnSaved]()
     {
-        // Validate UObject pointers are still valid
-        if (!WeakSettings.IsValid())
-        {
-            UE_LOG(LogBetaHub, Warning, TEXT("Settings destroyed during async operation"));
-            AsyncTask(ENamedThreads::GameThread, [OnFailure]() {
-                OnFailure(TEXT("Operation cancelled - settings no longer valid"));
-            });
-            return;
-        }
+        UE_LOG(LogBetaHub, Log, TEXT("Game thread task: saving video recording..."));
 
+        UBH_GameRecorder* GameRecorder = WeakGameRecorder.Get();
         UBH_PluginSettings* Settings = WeakSettings.Get();
-        UBH_GameRecorder* GameRecorder = WeakGameRecorder.Get(); // May be null if destroyed
 
-        // Double-check Settings is valid (IsValid can return true for pending kill objects)
-        if (!Settings)
+        FString VideoPath;
+        FString ProxyPath;
+        if (GameRecorder && Settings)
         {
-            UE_LOG(LogBetaHub, Warning, TEXT("Settings invalid after weak pointer validation"));
-            AsyncTask(ENamedThreads::GameThread, [OnFailure]() {
-                OnFailure(TEXT("Operation cancelled - settings no longer valid"));
-            });
-            return;
-        }
-
-        if (bWasSuccessful && Response.IsValid() && (Response->GetResponseCode() == 200 || Response->GetResponseCode() == 201))
-        {
-            FString ContentAsString = Response->GetContentAsString();
-            FString IssueId = UBH_BugReport::ParseIssueIdFromResponse(ContentAsString);
-            FString ApiToken = UBH_BugReport::ParseTokenFromResponse(ContentAsString);
+            VideoPath = GameRecorder->SaveRecording();
+            UE_LOG(LogBetaHub, Log, TEXT("SaveRecording returned: %s"), *VideoPath);
 
-            if (!IssueId.IsEmpty())
+            if (!VideoPath.IsEmpty())
             {
-                UE_LOG(LogBetaHub, Log, TEXT("Draft issue created successfully with ID: %s"), *IssueId);
+                ProxyPath = GameRecorder->SaveProxyRecording();
+            }
 
-                FString FormattedIssueId = FString::Printf(TEXT("g-%s"), *IssueId);
+            if (bRestartRecording)
+            {
+                GameRecorder->StartRecording(Settings->MaxRecordedFrames, Settings->MaxRecordingDuration);
+            }
+        }
+        else
+        {
+            UE_LOG(LogBetaHub, Warning, TEXT("GameRecorder or Settings destroyed, skipping video save"));
+        }
 
-                // Lambda to start media uploads - called after video save completes (or immediately if no video)
-                auto StartMediaUploads = [WeakSettings, Videos, Screenshots, Logs, FormattedIssueId, ApiToken, OnSuccess, OnFailure]
-                    (const FString& VideoPath)
+        if (BH_VideoEncoder::NeedsTranscode(VideoPath))
+        {
+            // Intra-frame captures are too large to upload, convert them off the game thread
+            AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [OnSaved, VideoPath, ProxyPath]()
+            {
+                FString TranscodedPath = BH_VideoEncoder::TranscodeForUpload(VideoPath);
+                if (TranscodedPath.IsEmpty())
                 {
-                    UE_LOG(LogBetaHub, Log, TEXT("StartMediaUploads called with VideoPath: %s"), *VideoPath);
-
-                    if (!WeakSettings.IsValid())
-                    {
-                        UE_LOG(LogBetaHub, Warning, TEXT("Settings destroyed before media upload"));
-                        OnFailure(TEXT("Operation cancelled - settings destroyed"));
-                        return;
-                    }
-
-                    UBH_PluginSettings* Settings = WeakSettings.Get();
-                    if (!Settings)
-                    {
-                        UE_LOG(LogBetaHub, Warning, TEXT("Settings invalid before media upload"));
-                        OnFailure(TEXT("Operation cancelled - settings no longer valid"));
-                        return;
-                    }
-
-                    // Prepare media arrays
-                    TArray<FBH_MediaFile> FinalVideos = Videos;
-                    TArray<FBH_MediaFile> FinalScreenshots = Screenshots;
-                    TArray<FBH_MediaFile> FinalLogs = Logs;
-
-                    if (!VideoPath.IsEmpty())
-                    {
-                        FBH_MediaFile RecordedVideo;
-                        RecordedVideo.FilePath = VideoPath;
-                        RecordedVideo.Name = TEXT("");
-                        FinalVideos.Add(RecordedVideo);
-                    }
-
-                    // Use new media upload manager for S3 uploads
-                    TSharedPtr<BH_MediaUploadManager> MediaManager = MakeShareable(new BH_MediaUploadManager());
-
-                    BH_MediaUploadManager::FOnUploadComplete UploadCompleteDelegate;
-                    UploadCompleteDelegate.BindLambda([WeakSettings, FormattedIssueId, ApiToken, OnSuccess, OnFailure, VideoPath, MediaManager]
-                        (const BH_MediaUploadManager::FMediaUploadResult& Result)
-                    {
-                        if (!WeakSettings.IsValid())
-                        {
-                            UE_LOG(LogBetaHub, Warning, TEXT("Settings destroyed during media upload"));
-                            OnFailure(TEXT("Operation cancelled - settings destroyed during upload"));
-                            return;
-                        }
-
-                        UBH_PluginSettings* Settings = WeakSettings.Get();
-                        if (!Settings)
-                        {
-                            UE_LOG(LogBetaHub, Warning, TEXT("Settings invalid during upload completion"));
-                            OnFailure(TEXT("Operation cancelled - settings no longer valid"));
-                            return;
-                        }
-
-                        if (Result.bSuccess)
-                        {
-                            UE_LOG(LogBetaHub, Log, TEXT("Media upload completed successfully"));
-                            UE_LOG(LogBetaHub, Log, TEXT("  - Screenshots: %d"), Result.ScreenshotsUploaded);
-                            UE_LOG(LogBetaHub, Log, TEXT("  - Videos: %d"), Result.VideosUploaded);
-                            UE_LOG(LogBetaHub, Log, TEXT("  - Log files: %d"), Result.LogsUploaded);
-                        }
-                        else if (Result.TotalFilesUploaded > 0)
-                        {
-                            UE_LOG(LogBetaHub, Warning, TEXT("Some media uploads succeeded (%d of attempted)"), Result.TotalFilesUploaded);
-                            for (const FString& Error : Result.Errors)
-                            {
-                                UE_LOG(LogBetaHub, Warning, TEXT("Upload error: %s"), *Error);
-                            }
-                        }
-                        else
-                        {
-                            UE_LOG(LogBetaHub, Warning, TEXT("All media uploads failed, publishing issue without media"));
-                        }
-
-                        // Always publish the issue, even if media uploads failed
-                        PublishIssue(Settings, FormattedIssueId, ApiToken, OnSuccess, OnFailure);
-
-                        // Cleanup auto-recorded video file
-                        if (!VideoPath.IsEmpty())
-                        {
-                            IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-                            if (PlatformFile.FileExists(*VideoPath))
-                            {
-                                PlatformFile.DeleteFile(*VideoPath);
-                            }
-                        }
-                    });
-
-                    BH_MediaUploadManager::FOnProgressUpdate ProgressDelegate;
-                    ProgressDelegate.BindLambda([](const BH_MediaUploadManager::FUploadProgress& Progress)
-                    {
-                        UE_LOG(LogBetaHub, Verbose, TEXT("Upload progress: %s (%.1f%%)"),
-                            *Progress.CurrentFile, Progress.ProgressPercent);
-                    });
+                    UE_LOG(LogBetaHub, Warning, TEXT("Video transcode failed, submitting without the recorded video"));
+                    IFileManager::Get().Delete(*VideoPath);
+                }
 
-                    UE_LOG(LogBetaHub, Log, TEXT("Starting media uploads..."));
-                    MediaManager->UploadMediaFiles(
-                        Settings->ApiEndpoint,
-                        Settings->ProjectId,
-                        FormattedIssueId,
-                        ApiToken,
-                        FinalVideos,
-                        FinalScreenshots,
-                        FinalLogs,
-                        ProgressDelegate,
-                        UploadCompleteDelegate
-                    );
-                };
-
-                // Handle GameRecorder using continuation style (no blocking)
-                if (GameRecorder)
+                // Uploads are scheduled on the game thread
+                AsyncTask(ENamedThreads::GameThread, [OnSaved, TranscodedPath, ProxyPath]()
                 {
-                    UE_LOG(LogBetaHub, Log, TEXT("GameRecorder provided, scheduling video save on game thread..."));
+                    OnSaved(TranscodedPath, ProxyPath);
+                });
+            });
+            return;
+        }
 
-                    // Use AsyncTask - saves video then continues with media upload in the same callback
-                    AsyncTask(ENamedThreads::GameThread, [WeakGameRecorder, WeakSettings, StartMediaUploads]()
-                    {
-                        UE_LOG(LogBetaHub, Log, TEXT("Game thread task: saving video recording..."));
+        // Continue with media upload (no blocking needed)
+        OnSaved(VideoPath, ProxyPath);
+    });
+}
 
-                        UBH_GameRecorder* GameRecorder = WeakGameRecorder.Get();
-                        UBH_PluginSettings* Settings = WeakSettings.Get();
+void UBH_BugReport::AddReportArtifacts(
+    const FString& IssueId,
+    const TArray<FBH_MediaFile>& Videos,
+    const TArray<FBH_MediaFile>& Screenshots,
+    const TArray<FBH_MediaFile>& Logs,
+    const FString& VideoPath,
+    const FString& ProxyPath,
+    bool bDeferVideos)
+{
+    BH_UploadJournal& Journal = BH_UploadJournal::Get();
 
-                        FString VideoPath;
-                        if (GameRecorder && Settings)
-                        {
-                            VideoPath = GameRecorder->SaveRecording();
-                            UE_LOG(LogBetaHub, Log, TEXT("SaveRecording returned: %s"), *VideoPath);
+    for (const FBH_MediaFile& Video : Videos)
+    {
+        Journal.AddArtifact(IssueId, EBH_MediaType::Video, Video, false, bDeferVideos);
+    }
+    for (const FBH_MediaFile& Screenshot : Screenshots)
+    {
+        Journal.AddArtifact(IssueId, EBH_MediaType::Screenshot, Screenshot, false, false);
+    }
+    for (const FBH_MediaFile& Log : Logs)
+    {
+        Journal.AddArtifact(IssueId, EBH_MediaType::LogFile, Log, false, false);
+    }
 
-                            GameRecorder->StartRecording(Settings->MaxRecordedFrames, Settings->MaxRecordingDuration);
-                        }
-                        else
-                        {
-                            UE_LOG(LogBetaHub, Warning, TEXT("GameRecorder or Settings destroyed, skipping video save"));
-                        }
+    // Recordings belong to the plugin and are moved into the journal
+    if (!ProxyPath.IsEmpty())
+    {
+        FBH_MediaFile ProxyVideo;
+        ProxyVideo.FilePath = ProxyPath;
+        ProxyVideo.Name = TEXT("Triage proxy");
+        Journal.AddArtifact(IssueId, EBH_MediaType::Video, ProxyVideo, true, bDeferVideos);
 
-                        // Continue with media upload (no blocking needed)
-                        StartMediaUploads(VideoPath);
-                    });
-                }
-                else
-                {
-                    // No GameRecorder - start media uploads immediately
-                    StartMediaUploads(TEXT(""));
-                }
-            }
-            else
-            {
-                UE_LOG(LogBetaHub, Error, TEXT("Failed to parse Issue ID from response: %s"), *ContentAsString);
-                AsyncTask(ENamedThreads::GameThread, [OnFailure, ContentAsString]() {
-                    OnFailure(FString::Printf(TEXT("Failed to parse Issue ID from response: %s"), *ContentAsString));
-                });
-            }
-        }
-        else
+        // The report is already triageable with the proxy, the full clip is attached after publishing
+        if (!VideoPath.IsEmpty())
         {
-            // Handle failure case
-            FString ErrorMessage = TEXT("Unknown error submitting bug report.");
-            FString ResponseContentForLog = TEXT("No response content available.");
-            if (Response.IsValid())
-            {
-                ResponseContentForLog = Response->GetContentAsString();
-                ErrorMessage = UBH_BugReport::ParseErrorFromResponse(ResponseContentForLog);
-            }
-            else if (!bWasSuccessful)
-            {
-                 ErrorMessage = TEXT("HTTP request failed (bWasSuccessful is false).");
-                 ResponseContentForLog = ErrorMessage;
-            }
-
-            UE_LOG(LogBetaHub, Error, TEXT("Failed to submit bug report: %s"), *ResponseContentForLog);
-            AsyncTask(ENamedThreads::GameThread, [OnFailure, ErrorMessage]() {
-                OnFailure(ErrorMessage);
-            });
+            FBH_MediaFile FullVideo;
+            FullVideo.FilePath = VideoPath;
+            Journal.AddArtifact(IssueId, EBH_MediaType::Video, FullVideo, true, true);
         }
-    });
+    }
+    else if (!VideoPath.IsEmpty())
+    {
+        FBH_MediaFile RecordedVideo;
+        RecordedVideo.FilePath = VideoPath;
+        RecordedVideo.Name = TEXT("");
+        Journal.AddArtifact(IssueId, EBH_MediaType::Video, RecordedVideo, true, bDeferVideos);
+    }
 }
 
 void UBH_BugReport::SubmitReport(
@@ -592,77 +1275,6 @@ FString UBH_BugReport::ParseTokenFromResponse(const FString& Response)
     return FString(); // Return empty string if parsing fails
 }
 
-void UBH_BugReport::PublishIssue(
-    UBH_PluginSettings* Settings,
-    const FString& IssueId,
-    const FString& ApiToken,
-    TFunction<void()> OnSuccess,
-    TFunction<void(const FString&)> OnFailure)
-{
-    if (!Settings)
-    {
-        UE_LOG(LogBetaHub, Error, TEXT("Settings is null in PublishIssue"));
-        AsyncTask(ENamedThreads::GameThread, [OnFailure]() {
-            OnFailure(TEXT("Invalid settings"));
-        });
-        return;
-    }
-
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    FString Url = Settings->ApiEndpoint + TEXT("/projects/") + Settings->ProjectId + TEXT("/issues/") + IssueId + TEXT("/publish");
-
-    Request->SetURL(Url);
-    Request->SetVerb(TEXT("POST"));
-    Request->SetHeader(TEXT("Accept"), TEXT("application/json"));
-    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
-    Request->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *ApiToken));
-    Request->SetHeader(TEXT("BetaHub-Project-ID"), Settings->ProjectId);
-
-    // Create JSON body
-    TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
-    JsonObject->SetBoolField(TEXT("email_my_report"), false);
-
-    FString JsonString;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
-    FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
-    Request->SetContentAsString(JsonString);
-
-    Request->OnProcessRequestComplete().BindLambda(
-        [OnSuccess, OnFailure](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
-        {
-            if (bWasSuccessful && HttpResponse.IsValid() &&
-                (HttpResponse->GetResponseCode() == 200 || HttpResponse->GetResponseCode() == 201))
-            {
-                UE_LOG(LogBetaHub, Log, TEXT("Issue published successfully"));
-                AsyncTask(ENamedThreads::GameThread, [OnSuccess]() {
-                    OnSuccess();
-                });
-            }
-            else
-            {
-                FString ErrorMessage = TEXT("Failed to publish issue");
-                if (HttpResponse.IsValid())
-                {
-                    ErrorMessage = FString::Printf(TEXT("Failed to publish issue: HTTP %d - %s"),
-                        HttpResponse->GetResponseCode(), *HttpResponse->GetContentAsString());
-                }
-                else if (!bWasSuccessful)
-                {
-                    ErrorMessage = TEXT("Failed to publish issue: Network request failed");
-                }
-
-                UE_LOG(LogBetaHub, Error, TEXT("%s"), *ErrorMessage);
-                AsyncTask(ENamedThreads::GameThread, [OnFailure, ErrorMessage]() {
-                    OnFailure(ErrorMessage);
-                });
-            }
-        }
-    );
-
-    Request->SetTimeout(30.0f);
-    Request->ProcessRequest();
-}
-
 void UBH_BugReport::ShowPopup(const FString& Message)
 {
     AsyncTask(ENamedThreads::GameThread, [Message]()
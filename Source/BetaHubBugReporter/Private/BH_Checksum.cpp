@@ -0,0 +1,494 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "BH_Checksum.h"
+#include "BH_Log.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Base64.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+    #include <immintrin.h>
+#elif PLATFORM_CPU_ARM_FAMILY && defined(__ARM_FEATURE_CRC32)
+    #include <arm_acle.h>
+#endif
+
+// Intrinsics outside of the compiler's baseline instruction set need a target attribute on clang and gcc
+#if defined(__clang__) || defined(__GNUC__)
+    #define BH_TARGET(Features) __attribute__((target(Features)))
+#else
+    #define BH_TARGET(Features)
+#endif
+
+namespace BH_ChecksumImpl
+{
+    struct FCpuFeatures
+    {
+        bool bCrc32c = false;
+        bool bSha = false;
+
+        FCpuFeatures()
+        {
+#if PLATFORM_CPU_X86_FAMILY
+            int Regs[4] = { 0, 0, 0, 0 };
+            Cpuid(0, Regs);
+            const int MaxLeaf = Regs[0];
+
+            Cpuid(1, Regs);
+            const bool bSSSE3 = (Regs[2] & (1 << 9)) != 0;
+            const bool bSSE41 = (Regs[2] & (1 << 19)) != 0;
+            bCrc32c = (Regs[2] & (1 << 20)) != 0;
+
+            if (MaxLeaf >= 7)
+            {
+                Cpuid(7, Regs);
+                bSha = bSSSE3 && bSSE41 && (Regs[1] & (1 << 29)) != 0;
+            }
+#elif PLATFORM_CPU_ARM_FAMILY && defined(__ARM_FEATURE_CRC32)
+            bCrc32c = true;
+#endif
+        }
+
+#if PLATFORM_CPU_X86_FAMILY
+        static void Cpuid(int Leaf, int Regs[4])
+        {
+#if defined(_MSC_VER)
+            __cpuidex(Regs, Leaf, 0);
+#else
+            __cpuid_count(Leaf, 0, Regs[0], Regs[1], Regs[2], Regs[3]);
+#endif
+        }
+#endif
+    };
+
+    static const FCpuFeatures& GetCpuFeatures()
+    {
+        static const FCpuFeatures Features;
+        return Features;
+    }
+
+    // CRC32C (Castagnoli), reflected polynomial
+    static const uint32 Crc32cPolynomial = 0x82F63B78;
+
+    struct FCrc32cTables
+    {
+        uint32 Table[8][256];
+
+        FCrc32cTables()
+        {
+            for (uint32 i = 0; i < 256; ++i)
+            {
+                uint32 Crc = i;
+                for (int32 Bit = 0; Bit < 8; ++Bit)
+                {
+                    Crc = (Crc >> 1) ^ ((Crc & 1) ? Crc32cPolynomial : 0);
+                }
+                Table[0][i] = Crc;
+            }
+
+            for (uint32 i = 0; i < 256; ++i)
+            {
+                for (int32 Slice = 1; Slice < 8; ++Slice)
+                {
+                    Table[Slice][i] = (Table[Slice - 1][i] >> 8) ^ Table[0][Table[Slice - 1][i] & 0xFF];
+                }
+            }
+        }
+    };
+
+    // Slicing-by-8, processes 8 bytes per step
+    static uint32 Crc32cSoftware(uint32 Crc, const uint8* Data, int64 Size)
+    {
+        static const FCrc32cTables Tables;
+        const uint32 (*T)[256] = Tables.Table;
+
+        while (Size >= 8)
+        {
+            const uint32 Low = (Data[0] | (Data[1] << 8) | (Data[2] << 16) | ((uint32)Data[3] << 24)) ^ Crc;
+            const uint32 High = Data[4] | (Data[5] << 8) | (Data[6] << 16) | ((uint32)Data[7] << 24);
+            Crc = T[7][Low & 0xFF] ^ T[6][(Low >> 8) & 0xFF] ^ T[5][(Low >> 16) & 0xFF] ^ T[4][Low >> 24] ^
+                  T[3][High & 0xFF] ^ T[2][(High >> 8) & 0xFF] ^ T[1][(High >> 16) & 0xFF] ^ T[0][High >> 24];
+            Data += 8;
+            Size -= 8;
+        }
+
+        while (Size-- > 0)
+        {
+            Crc = (Crc >> 8) ^ T[0][(Crc ^ *Data++) & 0xFF];
+        }
+
+        return Crc;
+    }
+
+#if PLATFORM_CPU_X86_FAMILY
+    BH_TARGET("sse4.2")
+    static uint32 Crc32cHardware(uint32 Crc, const uint8* Data, int64 Size)
+    {
+        uint64 Crc64 = Crc;
+
+        while (Size >= 8)
+        {
+            uint64 Value;
+            FMemory::Memcpy(&Value, Data, sizeof(Value));
+            Crc64 = _mm_crc32_u64(Crc64, Value);
+            Data += 8;
+            Size -= 8;
+        }
+
+        uint32 Crc32 = (uint32)Crc64;
+        while (Size-- > 0)
+        {
+            Crc32 = _mm_crc32_u8(Crc32, *Data++);
+        }
+
+        return Crc32;
+    }
+#elif PLATFORM_CPU_ARM_FAMILY && defined(__ARM_FEATURE_CRC32)
+    static uint32 Crc32cHardware(uint32 Crc, const uint8* Data, int64 Size)
+    {
+        while (Size >= 8)
+        {
+            uint64 Value;
+            FMemory::Memcpy(&Value, Data, sizeof(Value));
+            Crc = __crc32cd(Crc, Value);
+            Data += 8;
+            Size -= 8;
+        }
+
+        while (Size-- > 0)
+        {
+            Crc = __crc32cb(Crc, *Data++);
+        }
+
+        return Crc;
+    }
+#else
+    static uint32 Crc32cHardware(uint32 Crc, const uint8* Data, int64 Size)
+    {
+        return Crc32cSoftware(Crc, Data, Size);
+    }
+#endif
+
+    static const uint32 Sha256K[64] = {
+        0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+        0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+        0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+        0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+        0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+        0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+        0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+        0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+    };
+
+    static FORCEINLINE uint32 RotateRight(uint32 Value, uint32 Bits)
+    {
+        return (Value >> Bits) | (Value << (32 - Bits));
+    }
+
+    static void Sha256Software(uint32 State[8], const uint8* Data, int64 NumBlocks)
+    {
+        for (; NumBlocks > 0; --NumBlocks, Data += 64)
+        {
+            uint32 W[64];
+            for (int32 i = 0; i < 16; ++i)
+            {
+                W[i] = ((uint32)Data[i * 4] << 24) | ((uint32)Data[i * 4 + 1] << 16) | ((uint32)Data[i * 4 + 2] << 8) | Data[i * 4 + 3];
+            }
+            for (int32 i = 16; i < 64; ++i)
+            {
+                const uint32 S0 = RotateRight(W[i - 15], 7) ^ RotateRight(W[i - 15], 18) ^ (W[i - 15] >> 3);
+                const uint32 S1 = RotateRight(W[i - 2], 17) ^ RotateRight(W[i - 2], 19) ^ (W[i - 2] >> 10);
+                W[i] = W[i - 16] + S0 + W[i - 7] + S1;
+            }
+
+            uint32 A = State[0], B = State[1], C = State[2], D = State[3];
+            uint32 E = State[4], F = State[5], G = State[6], H = State[7];
+
+            for (int32 i = 0; i < 64; ++i)
+            {
+                const uint32 S1 = RotateRight(E, 6) ^ RotateRight(E, 11) ^ RotateRight(E, 25);
+                const uint32 Ch = (E & F) ^ (~E & G);
+                const uint32 Temp1 = H + S1 + Ch + Sha256K[i] + W[i];
+                const uint32 S0 = RotateRight(A, 2) ^ RotateRight(A, 13) ^ RotateRight(A, 22);
+                const uint32 Maj = (A & B) ^ (A & C) ^ (B & C);
+                const uint32 Temp2 = S0 + Maj;
+
+                H = G;
+                G = F;
+                F = E;
+                E = D + Temp1;
+                D = C;
+                C = B;
+                B = A;
+                A = Temp1 + Temp2;
+            }
+
+            State[0] += A; State[1] += B; State[2] += C; State[3] += D;
+            State[4] += E; State[5] += F; State[6] += G; State[7] += H;
+        }
+    }
+
+#if PLATFORM_CPU_X86_FAMILY
+    // SHA-NI, four rounds per group with the message schedule computed in registers
+    BH_TARGET("sha,sse4.1,ssse3")
+    static void Sha256Hardware(uint32 State[8], const uint8* Data, int64 NumBlocks)
+    {
+        const __m128i ByteSwapMask = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+
+        __m128i Temp = _mm_loadu_si128((const __m128i*)&State[0]);
+        __m128i State1 = _mm_loadu_si128((const __m128i*)&State[4]);
+
+        Temp = _mm_shuffle_epi32(Temp, 0xB1);            // CDAB
+        State1 = _mm_shuffle_epi32(State1, 0x1B);        // EFGH
+        __m128i State0 = _mm_alignr_epi8(Temp, State1, 8); // ABEF
+        State1 = _mm_blend_epi16(State1, Temp, 0xF0);    // CDGH
+
+        for (; NumBlocks > 0; --NumBlocks, Data += 64)
+        {
+            const __m128i AbefSave = State0;
+            const __m128i CdghSave = State1;
+
+            __m128i Msg[4];
+
+            for (int32 Group = 0; Group < 16; ++Group)
+            {
+                __m128i& Current = Msg[Group & 3];
+                if (Group < 4)
+                {
+                    Current = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(Data + Group * 16)), ByteSwapMask);
+                }
+
+                __m128i RoundInput = _mm_add_epi32(Current, _mm_loadu_si128((const __m128i*)&Sha256K[Group * 4]));
+                State1 = _mm_sha256rnds2_epu32(State1, State0, RoundInput);
+
+                if (Group >= 3 && Group <= 14)
+                {
+                    __m128i& Next = Msg[(Group + 1) & 3];
+                    Next = _mm_add_epi32(Next, _mm_alignr_epi8(Current, Msg[(Group - 1) & 3], 4));
+                    Next = _mm_sha256msg2_epu32(Next, Current);
+                }
+
+                RoundInput = _mm_shuffle_epi32(RoundInput, 0x0E);
+                State0 = _mm_sha256rnds2_epu32(State0, State1, RoundInput);
+
+                if (Group >= 1 && Group <= 12)
+                {
+                    __m128i& Previous = Msg[(Group - 1) & 3];
+                    Previous = _mm_sha256msg1_epu32(Previous, Current);
+                }
+            }
+
+            State0 = _mm_add_epi32(State0, AbefSave);
+            State1 = _mm_add_epi32(State1, CdghSave);
+        }
+
+        Temp = _mm_shuffle_epi32(State0, 0x1B);          // FEBA
+        State1 = _mm_shuffle_epi32(State1, 0xB1);        // DCHG
+        State0 = _mm_blend_epi16(Temp, State1, 0xF0);    // DCBA
+        State1 = _mm_alignr_epi8(State1, Temp, 8);       // HGFE
+
+        _mm_storeu_si128((__m128i*)&State[0], State0);
+        _mm_storeu_si128((__m128i*)&State[4], State1);
+    }
+#else
+    static void Sha256Hardware(uint32 State[8], const uint8* Data, int64 NumBlocks)
+    {
+        Sha256Software(State, Data, NumBlocks);
+    }
+#endif
+
+    static void Sha256Blocks(uint32 State[8], const uint8* Data, int64 NumBlocks)
+    {
+        if (GetCpuFeatures().bSha)
+        {
+            Sha256Hardware(State, Data, NumBlocks);
+        }
+        else
+        {
+            Sha256Software(State, Data, NumBlocks);
+        }
+    }
+}
+
+BH_Checksum::BH_Checksum(EBH_ChecksumAlgorithm InAlgorithm)
+    : Algorithm(InAlgorithm)
+    , Crc(0xFFFFFFFF)
+    , ShaBufferSize(0)
+    , ShaTotalSize(0)
+{
+    static const uint32 Sha256Init[8] = {
+        0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+    };
+    FMemory::Memcpy(ShaState, Sha256Init, sizeof(ShaState));
+}
+
+void BH_Checksum::Update(const uint8* Data, int64 Size)
+{
+    switch (Algorithm)
+    {
+    case EBH_ChecksumAlgorithm::CRC32C:
+        Crc = BH_ChecksumImpl::GetCpuFeatures().bCrc32c
+            ? BH_ChecksumImpl::Crc32cHardware(Crc, Data, Size)
+            : BH_ChecksumImpl::Crc32cSoftware(Crc, Data, Size);
+        break;
+
+    case EBH_ChecksumAlgorithm::SHA256:
+        ShaUpdate(Data, Size);
+        break;
+
+    default:
+        Md5.Update(Data, Size);
+        break;
+    }
+}
+
+void BH_Checksum::ShaUpdate(const uint8* Data, int64 Size)
+{
+    ShaTotalSize += Size;
+
+    if (ShaBufferSize > 0)
+    {
+        const int32 ToCopy = (int32)FMath::Min<int64>(64 - ShaBufferSize, Size);
+        FMemory::Memcpy(ShaBuffer + ShaBufferSize, Data, ToCopy);
+        ShaBufferSize += ToCopy;
+        Data += ToCopy;
+        Size -= ToCopy;
+
+        if (ShaBufferSize < 64)
+        {
+            return;
+        }
+
+        BH_ChecksumImpl::Sha256Blocks(ShaState, ShaBuffer, 1);
+        ShaBufferSize = 0;
+    }
+
+    const int64 NumBlocks = Size / 64;
+    if (NumBlocks > 0)
+    {
+        BH_ChecksumImpl::Sha256Blocks(ShaState, Data, NumBlocks);
+        Data += NumBlocks * 64;
+        Size -= NumBlocks * 64;
+    }
+
+    if (Size > 0)
+    {
+        FMemory::Memcpy(ShaBuffer, Data, Size);
+        ShaBufferSize = (int32)Size;
+    }
+}
+
+FString BH_Checksum::FinalizeBase64()
+{
+    switch (Algorithm)
+    {
+    case EBH_ChecksumAlgorithm::CRC32C:
+    {
+        const uint32 Value = ~Crc;
+        const uint8 Digest[4] = { (uint8)(Value >> 24), (uint8)(Value >> 16), (uint8)(Value >> 8), (uint8)Value };
+        return FBase64::Encode(Digest, 4);
+    }
+
+    case EBH_ChecksumAlgorithm::SHA256:
+    {
+        const uint64 TotalBits = ShaTotalSize * 8;
+
+        // Padding: 0x80, zeros up to 56 bytes mod 64, then the big-endian bit length
+        uint8 Padding[72] = { 0x80 };
+        const int32 PaddingSize = (ShaBufferSize < 56 ? 56 : 120) - ShaBufferSize;
+        uint8 Length[8];
+        for (int32 i = 0; i < 8; ++i)
+        {
+            Length[i] = (uint8)(TotalBits >> (56 - i * 8));
+        }
+        ShaUpdate(Padding, PaddingSize);
+        ShaUpdate(Length, 8);
+
+        uint8 Digest[32];
+        for (int32 i = 0; i < 8; ++i)
+        {
+            Digest[i * 4] = (uint8)(ShaState[i] >> 24);
+            Digest[i * 4 + 1] = (uint8)(ShaState[i] >> 16);
+            Digest[i * 4 + 2] = (uint8)(ShaState[i] >> 8);
+            Digest[i * 4 + 3] = (uint8)ShaState[i];
+        }
+        return FBase64::Encode(Digest, 32);
+    }
+
+    default:
+    {
+        uint8 Digest[16];
+        Md5.Final(Digest);
+        return FBase64::Encode(Digest, 16);
+    }
+    }
+}
+
+const TCHAR* BH_Checksum::GetAlgorithmName(EBH_ChecksumAlgorithm Algorithm)
+{
+    switch (Algorithm)
+    {
+    case EBH_ChecksumAlgorithm::CRC32C:
+        return TEXT("crc32c");
+    case EBH_ChecksumAlgorithm::SHA256:
+        return TEXT("sha256");
+    default:
+        return TEXT("md5");
+    }
+}
+
+bool BH_Checksum::IsHardwareAccelerated(EBH_ChecksumAlgorithm Algorithm)
+{
+    switch (Algorithm)
+    {
+    case EBH_ChecksumAlgorithm::CRC32C:
+        return BH_ChecksumImpl::GetCpuFeatures().bCrc32c;
+    case EBH_ChecksumAlgorithm::SHA256:
+        return BH_ChecksumImpl::GetCpuFeatures().bSha;
+    default:
+        return false;
+    }
+}
+
+#if !UE_BUILD_SHIPPING
+// Measures the throughput of each algorithm on this machine: BetaHub.BenchmarkChecksums [SizeMB]
+static FAutoConsoleCommand BenchmarkChecksumsCommand(
+    TEXT("BetaHub.BenchmarkChecksums"),
+    TEXT("Measures the throughput of the upload checksum algorithms. Optional argument: buffer size in MB (default 256, at most 1024)."),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        // The buffer is a TArray, its size must fit in an int32
+        const int64 MaxSizeMB = 1024;
+        const int64 RequestedSizeMB = Args.Num() > 0 ? FMath::Max(FCString::Atoi64(*Args[0]), (int64)1) : 256;
+        const int64 SizeMB = FMath::Min(RequestedSizeMB, MaxSizeMB);
+        if (SizeMB < RequestedSizeMB)
+        {
+            UE_LOG(LogBetaHub, Warning, TEXT("Checksum benchmark buffer limited to %lld MB"), MaxSizeMB);
+        }
+
+        TArray<uint8> Buffer;
+        Buffer.SetNumUninitialized(SizeMB * 1024 * 1024);
+        for (int64 i = 0; i < Buffer.Num(); ++i)
+        {
+            Buffer[i] = (uint8)(i * 2654435761u >> 24);
+        }
+
+        for (EBH_ChecksumAlgorithm Algorithm : { EBH_ChecksumAlgorithm::MD5, EBH_ChecksumAlgorithm::CRC32C, EBH_ChecksumAlgorithm::SHA256 })
+        {
+            BH_Checksum Checksum(Algorithm);
+
+            const double StartTime = FPlatformTime::Seconds();
+            Checksum.Update(Buffer.GetData(), Buffer.Num());
+            const FString Result = Checksum.FinalizeBase64();
+            const double Elapsed = FMath::Max(FPlatformTime::Seconds() - StartTime, 1e-9);
+
+            UE_LOG(LogBetaHub, Display, TEXT("%-6s %s: %8.1f MB/s (%s)"),
+                BH_Checksum::GetAlgorithmName(Algorithm),
+                BH_Checksum::IsHardwareAccelerated(Algorithm) ? TEXT("hardware") : TEXT("software"),
+                SizeMB / Elapsed, *Result);
+        }
+    }));
+#endif
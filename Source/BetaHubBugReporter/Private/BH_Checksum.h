@@ -0,0 +1,50 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/SecureHash.h"
+#include "BH_MediaTypes.h"
+
+/**
+ * Incremental upload checksum in the format S3 expects: the Base64-encoded big-endian digest.
+ * CRC32C and SHA-256 use CPU instructions when available (SSE4.2 or ARMv8 CRC, SHA-NI)
+ * and fall back to portable implementations otherwise.
+ */
+class BH_Checksum
+{
+public:
+    explicit BH_Checksum(EBH_ChecksumAlgorithm InAlgorithm);
+
+    void Update(const uint8* Data, int64 Size);
+
+    /**
+     * Finishes the checksum, the object must not be updated afterwards
+     *
+     * @return              Base64-encoded digest
+     */
+    FString FinalizeBase64();
+
+    /**
+     * Name of the algorithm as sent to the BetaHub API ("md5", "crc32c" or "sha256")
+     */
+    static const TCHAR* GetAlgorithmName(EBH_ChecksumAlgorithm Algorithm);
+
+    /**
+     * True when the current CPU has instructions for the algorithm
+     */
+    static bool IsHardwareAccelerated(EBH_ChecksumAlgorithm Algorithm);
+
+private:
+    EBH_ChecksumAlgorithm Algorithm;
+
+    FMD5 Md5;
+
+    uint32 Crc;
+
+    uint32 ShaState[8];
+    uint8 ShaBuffer[64];
+    int32 ShaBufferSize;
+    uint64 ShaTotalSize;
+
+    void ShaUpdate(const uint8* Data, int64 Size);
+};
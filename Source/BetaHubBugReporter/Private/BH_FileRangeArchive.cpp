@@ -0,0 +1,87 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "BH_FileRangeArchive.h"
+#include "HAL/FileManager.h"
+
+FBH_FileRangeArchive::FBH_FileRangeArchive(const FString& InFilePath, int64 InRangeOffset, int64 InRangeSize)
+    : FilePath(InFilePath)
+    , RangeOffset(InRangeOffset)
+    , RangeSize(InRangeSize)
+    , Position(0)
+{
+    SetIsLoading(true);
+    SetIsPersistent(true);
+
+    FileReader.Reset(IFileManager::Get().CreateFileReader(*FilePath, FILEREAD_Silent));
+    if (FileReader && FileReader->TotalSize() >= RangeOffset + RangeSize)
+    {
+        FileReader->Seek(RangeOffset);
+    }
+    else
+    {
+        FileReader.Reset();
+    }
+}
+
+FBH_FileRangeArchive::~FBH_FileRangeArchive()
+{
+    Close();
+}
+
+bool FBH_FileRangeArchive::IsValid() const
+{
+    return FileReader.IsValid();
+}
+
+void FBH_FileRangeArchive::Serialize(void* Data, int64 Length)
+{
+    if (!FileReader || Length < 0 || Position + Length > RangeSize)
+    {
+        SetError();
+        return;
+    }
+
+    FileReader->Serialize(Data, Length);
+    Position += Length;
+
+    if (FileReader->IsError())
+    {
+        SetError();
+    }
+}
+
+void FBH_FileRangeArchive::Seek(int64 InPos)
+{
+    if (!FileReader || InPos < 0 || InPos > RangeSize)
+    {
+        SetError();
+        return;
+    }
+
+    FileReader->Seek(RangeOffset + InPos);
+    Position = InPos;
+}
+
+int64 FBH_FileRangeArchive::Tell()
+{
+    return Position;
+}
+
+int64 FBH_FileRangeArchive::TotalSize()
+{
+    return RangeSize;
+}
+
+bool FBH_FileRangeArchive::Close()
+{
+    if (FileReader)
+    {
+        FileReader->Close();
+        FileReader.Reset();
+    }
+    return !IsError();
+}
+
+FString FBH_FileRangeArchive::GetArchiveName() const
+{
+    return FString::Printf(TEXT("%s [%lld, %lld)"), *FilePath, RangeOffset, RangeOffset + RangeSize);
+}
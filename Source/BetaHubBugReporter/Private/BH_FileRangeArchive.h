@@ -0,0 +1,33 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+
+/**
+ * Read-only archive over a byte range of a file, used to stream a part of a file as an HTTP request body
+ * without loading it into memory. Positions are relative to the start of the range.
+ */
+class FBH_FileRangeArchive : public FArchive
+{
+public:
+    FBH_FileRangeArchive(const FString& FilePath, int64 InRangeOffset, int64 InRangeSize);
+    virtual ~FBH_FileRangeArchive();
+
+    // False if the file cannot be opened or is shorter than the range
+    bool IsValid() const;
+
+    virtual void Serialize(void* Data, int64 Length) override;
+    virtual void Seek(int64 InPos) override;
+    virtual int64 Tell() override;
+    virtual int64 TotalSize() override;
+    virtual bool Close() override;
+    virtual FString GetArchiveName() const override;
+
+private:
+    TUniquePtr<FArchive> FileReader;
+    FString FilePath;
+    int64 RangeOffset;
+    int64 RangeSize;
+    int64 Position;
+};
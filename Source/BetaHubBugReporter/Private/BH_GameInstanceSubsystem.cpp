@@ -35,4 +35,9 @@ void UBH_GameInstanceSubsystem::Deinitialize()
     {
         Manager->StopService();
     }
+}
+
+UBH_Manager* UBH_GameInstanceSubsystem::GetManager() const
+{
+    return Manager;
 }
\ No newline at end of file
@@ -23,6 +23,9 @@
 #include "Slate/SceneViewport.h"
 #include "Framework/Application/SlateApplication.h"
 
+// Segments of 10 seconds joined into a saved clip
+static const int32 SavedClipSegments = 12;
+
 #if ENGINE_MINOR_VERSION < 4
 bool ConvertRAWSurfaceDataToFLinearColor(EPixelFormat Format, uint32 Width, uint32 Height, uint8 *In, uint32 SrcPitch, FLinearColor* Out, FReadSurfaceDataFlags InFlags);
 #endif
@@ -45,6 +48,9 @@ UBH_GameRecorder::UBH_GameRecorder(const FObjectInitializer& ObjectInitializer)
     , LargestSize(0, 0)
     , MaxVideoWidth(512) // Initialize with minimum value
     , MaxVideoHeight(512) // Initialize with minimum value
+    , TriageProxyHeight(0)
+    , TriageProxyBitrateKbps(0)
+    , bIntraFrameCapture(false)
 {
     FrameBuffer = ObjectInitializer.CreateDefaultSubobject<UBH_FrameBuffer>(this, TEXT("FrameBuffer"));
 }
@@ -121,6 +127,12 @@ void UBH_GameRecorder::StartRecording(int32 InTargetFPS, int32 InRecordingDurati
         if (!FFmpegPath.IsEmpty() && FPaths::FileExists(FFmpegPath))
         {
             VideoEncoder = MakeShareable(new BH_VideoEncoder(InTargetFPS, FTimespan(0, 0, InRecordingDuration), FrameWidth, FrameHeight, FrameBuffer->GetFrameSource()));
+            if (TriageProxyHeight > 0)
+            {
+                VideoEncoder->SetProxyRendition(TriageProxyHeight, TriageProxyBitrateKbps);
+            }
+            VideoEncoder->SetIntraFrameCapture(bIntraFrameCapture);
+            VideoEncoder->SetCpuLimits(EncoderCpuLimits);
         }
     }
 
@@ -203,7 +215,28 @@ FString UBH_GameRecorder::SaveRecording()
         return FString();
     }
 
-    return VideoEncoder->MergeSegments(12);
+    return VideoEncoder->MergeSegments(SavedClipSegments);
+}
+
+FString UBH_GameRecorder::SaveProxyRecording()
+{
+    if (!VideoEncoder.IsValid() || !VideoEncoder->HasProxyRendition())
+    {
+        return FString();
+    }
+
+    if (bIsRecording)
+    {
+        UE_LOG(LogBetaHub, Error, TEXT("Recording is still in progress."));
+        return FString();
+    }
+
+    return VideoEncoder->MergeProxySegments(SavedClipSegments);
+}
+
+bool UBH_GameRecorder::GetRecordedTimeRange(double& OutStart, double& OutEnd) const
+{
+    return VideoEncoder.IsValid() && VideoEncoder->GetRecordedTimeRange(SavedClipSegments, OutStart, OutEnd);
 }
 
 void UBH_GameRecorder::Tick(float DeltaTime)
@@ -276,15 +309,44 @@ void UBH_GameRecorder::ResizeImageToFrame(
 {
     ResizedImage.SetNum(InFrameWidth * InFrameHeight);
 
-    float ScaleX = static_cast<float>(ImageWidth) / InFrameWidth;
-    float ScaleY = static_cast<float>(ImageHeight) / InFrameHeight;
+    // The frame size is fixed for the session, so the source may have a different aspect ratio
+    // after a window resize. Fit it into the frame and letterbox the rest instead of stretching.
+    // Small differences (e.g. rounding the frame to a multiple of 4) are still stretched.
+    uint32 TargetWidth = InFrameWidth;
+    uint32 TargetHeight = InFrameHeight;
+
+    const float SourceAspect = static_cast<float>(ImageWidth) / ImageHeight;
+    const float FrameAspect = static_cast<float>(InFrameWidth) / InFrameHeight;
+    if (FMath::Abs(SourceAspect / FrameAspect - 1.0f) > 0.02f)
+    {
+        if (SourceAspect > FrameAspect)
+        {
+            TargetHeight = FMath::Clamp<uint32>(FMath::RoundToInt(InFrameWidth / SourceAspect), 1u, InFrameHeight);
+        }
+        else
+        {
+            TargetWidth = FMath::Clamp<uint32>(FMath::RoundToInt(InFrameHeight * SourceAspect), 1u, InFrameWidth);
+        }
+    }
+
+    const uint32 OffsetX = (InFrameWidth - TargetWidth) / 2;
+    const uint32 OffsetY = (InFrameHeight - TargetHeight) / 2;
+
+    float ScaleX = static_cast<float>(ImageWidth) / TargetWidth;
+    float ScaleY = static_cast<float>(ImageHeight) / TargetHeight;
 
     for (uint32 Y = 0; Y < InFrameHeight; ++Y)
     {
         for (uint32 X = 0; X < InFrameWidth; ++X)
         {
-            uint32 SourceX = FMath::Clamp(static_cast<uint32>(X * ScaleX), 0u, ImageWidth - 1);
-            uint32 SourceY = FMath::Clamp(static_cast<uint32>(Y * ScaleY), 0u, ImageHeight - 1);
+            if (X < OffsetX || X >= OffsetX + TargetWidth || Y < OffsetY || Y >= OffsetY + TargetHeight)
+            {
+                ResizedImage[Y * InFrameWidth + X] = FColor::Black;
+                continue;
+            }
+
+            uint32 SourceX = FMath::Clamp(static_cast<uint32>((X - OffsetX) * ScaleX), 0u, ImageWidth - 1);
+            uint32 SourceY = FMath::Clamp(static_cast<uint32>((Y - OffsetY) * ScaleY), 0u, ImageHeight - 1);
 
             ResizedImage[Y * InFrameWidth + X] = ImageData[SourceY * ImageWidth + SourceX];
         }
@@ -439,7 +501,7 @@ void UBH_GameRecorder::ReadPixels(const FTextureRHIRef& BackBuffer)
     if (BackBuffer->GetDesc().GetSize().X != ViewportWidth 
         || BackBuffer->GetDesc().GetSize().Y != ViewportHeight)
     {
-        UE_LOG(LogBetaHub, Warning, TEXT("Viewport size has changed. Restarting recording. Was: %dx%d, Now: %dx%d"),
+        UE_LOG(LogBetaHub, Warning, TEXT("Viewport size has changed. Was: %dx%d, Now: %dx%d"),
             ViewportWidth, ViewportHeight, BackBuffer->GetDesc().GetSize().X, BackBuffer->GetDesc().GetSize().Y);
         OnBackBufferResized(BackBuffer);
         return;
@@ -561,16 +623,13 @@ void UBH_GameRecorder::OnBackBufferResized(const FTextureRHIRef& BackBuffer)
         return;
     }
 
-    bIsResizing = true;
-
     FIntVector OriginalSize = BackBuffer->GetDesc().GetSize();
 
     // Validate size is reasonable (not 0x0 which can happen during transitions)
     if (OriginalSize.X <= 0 || OriginalSize.Y <= 0)
     {
-        UE_LOG(LogBetaHub, Warning, TEXT("Invalid back buffer size during resize: %dx%d, skipping resize"), 
+        UE_LOG(LogBetaHub, Warning, TEXT("Invalid back buffer size during resize: %dx%d, skipping resize"),
             OriginalSize.X, OriginalSize.Y);
-        bIsResizing = false;
         return;
     }
 
@@ -578,6 +637,19 @@ void UBH_GameRecorder::OnBackBufferResized(const FTextureRHIRef& BackBuffer)
     int32 OriginalWidth = ViewportWidth = OriginalSize.X;
     int32 OriginalHeight = ViewportHeight = OriginalSize.Y;
 
+    // The output resolution is fixed for the whole session. Once the encoder runs with a known
+    // frame size, a back buffer resize only needs a new staging texture - incoming frames are
+    // rescaled into the existing frame when processed, so the encoder and its segments survive.
+    if (VideoEncoder.IsValid() && FrameWidth > 0 && FrameHeight > 0)
+    {
+        UE_LOG(LogBetaHub, Log, TEXT("Back buffer resized to %dx%d, keeping video output at %dx%d"),
+            OriginalWidth, OriginalHeight, FrameWidth, FrameHeight);
+        ReleaseStagingTexture();
+        return;
+    }
+
+    bIsResizing = true;
+
     UE_LOG(LogBetaHub, Log, TEXT("Resizing recording from viewport size: %dx%d"), OriginalWidth, OriginalHeight);
 
     // Calculate scaling factor based on the maximum dimension
@@ -640,6 +712,20 @@ void UBH_GameRecorder::OnBackBufferResized(const FTextureRHIRef& BackBuffer)
     }
 }
 
+void UBH_GameRecorder::ReleaseStagingTexture()
+{
+    // Release on the render thread, after any copy command that still references the old texture.
+    // OnBackBufferReady recreates it with the new back buffer size on the next captured frame.
+    ENQUEUE_RENDER_COMMAND(ReleaseStagingTextureCommand)(
+        [this](FRHICommandListImmediate& RHICmdList)
+        {
+            if (StagingTexture.IsValid())
+            {
+                StagingTexture.SafeRelease();
+            }
+        });
+}
+
 void UBH_GameRecorder::SetFrameData(int32 Width, int32 Height, const TArray<FColor>& Data)
 {
     SCOPE_CYCLE_COUNTER(STAT_BetaHub_SetFrameData);
@@ -689,12 +775,57 @@ FString UBH_GameRecorder::CaptureScreenshotToJPG(const FString& Filename)
     }
 }
 
+TFuture<FString> UBH_GameRecorder::CaptureScreenshotToJPGAsync(const FString& Filename)
+{
+    TSharedPtr<FBH_Frame> Frame = FrameBuffer->GetFrame();
+    if (!Frame.IsValid() || Frame->Data.Num() == 0)
+    {
+        UE_LOG(LogBetaHub, Error, TEXT("No frame to capture a screenshot from."));
+        return MakeFulfilledPromise<FString>(FString()).GetFuture();
+    }
+
+    // The frame buffer keeps writing into its frame, the encoder gets a copy
+    TSharedRef<FBH_Frame, ESPMode::ThreadSafe> Copy = MakeShared<FBH_Frame, ESPMode::ThreadSafe>(*Frame);
+
+    IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+    TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::JPEG);
+
+    return Async(EAsyncExecution::ThreadPool, [Copy, ImageWrapper, Filename]()
+    {
+        ImageWrapper->SetRaw(Copy->Data.GetData(), Copy->Data.Num() * sizeof(FColor), Copy->Width, Copy->Height, ERGBFormat::BGRA, 8);
+        const TArray64<uint8>& JPEGData = ImageWrapper->GetCompressed(90);
+
+        if (!FFileHelper::SaveArrayToFile(JPEGData, *Filename))
+        {
+            UE_LOG(LogBetaHub, Error, TEXT("Failed to write screenshot %s"), *Filename);
+            return FString();
+        }
+        return Filename;
+    });
+}
+
 void UBH_GameRecorder::SetMaxVideoDimensions(int32 InMaxWidth, int32 InMaxHeight)
 {
     MaxVideoWidth = FMath::Max(InMaxWidth, 512);
     MaxVideoHeight = FMath::Max(InMaxHeight, 512);
 }
 
+void UBH_GameRecorder::SetTriageProxy(int32 InHeight, int32 InBitrateKbps)
+{
+    TriageProxyHeight = FMath::Max(InHeight, 0);
+    TriageProxyBitrateKbps = FMath::Max(InBitrateKbps, 0);
+}
+
+void UBH_GameRecorder::SetIntraFrameCapture(bool bEnable)
+{
+    bIntraFrameCapture = bEnable;
+}
+
+void UBH_GameRecorder::SetEncoderCpuLimits(const FBH_EncoderCpuLimits& InCpuLimits)
+{
+    EncoderCpuLimits = InCpuLimits;
+}
+
 #if ENGINE_MINOR_VERSION < 4
 bool ConvertRAWSurfaceDataToFLinearColor(EPixelFormat Format, uint32 Width, uint32 Height, uint8 *In, uint32 SrcPitch, FLinearColor* Out, FReadSurfaceDataFlags InFlags)
 {
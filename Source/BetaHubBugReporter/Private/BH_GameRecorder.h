@@ -4,6 +4,7 @@
 #include "CoreMinimal.h"
 #include "Tickable.h"
 #include "HAL/CriticalSection.h"
+#include "Async/Future.h"
 #include "BH_VideoEncoder.h"
 #include "BH_FrameBuffer.h"
 #include "UObject/NoExportTypes.h"
@@ -34,9 +35,19 @@ public:
     UFUNCTION(BlueprintCallable, Category="Recording")
     FString SaveRecording();
 
+    // Merges the low-resolution proxy segments; returns empty when no proxy is being recorded
+    UFUNCTION(BlueprintCallable, Category="Recording")
+    FString SaveProxyRecording();
+
+    // FPlatformTime::Seconds() of the first and last frame SaveRecording would save now, false when nothing is recorded
+    bool GetRecordedTimeRange(double& OutStart, double& OutEnd) const;
+
     UFUNCTION(BlueprintCallable, Category="Recording")
     FString CaptureScreenshotToJPG(const FString& Filename = "");
 
+    // Copies the current frame and encodes it on a worker thread; resolves to an empty path on failure
+    TFuture<FString> CaptureScreenshotToJPGAsync(const FString& Filename);
+
     virtual void Tick(float DeltaTime) override;
     virtual bool IsTickable() const override;
     virtual TStatId GetStatId() const override;
@@ -44,6 +55,18 @@ public:
     // Sets the maximum video dimensions while maintaining aspect ratio
     void SetMaxVideoDimensions(int32 InMaxWidth, int32 InMaxHeight);
 
+    // Records an additional low-resolution rendition next to the full one (height 0 disables it).
+    // Takes effect the next time the video encoder is created.
+    void SetTriageProxy(int32 InHeight, int32 InBitrateKbps);
+
+    // Captures with an intra-frame codec when no hardware encoder is available.
+    // Takes effect the next time the video encoder is created.
+    void SetIntraFrameCapture(bool bEnable);
+
+    // Restricts the encoder's threads, cores and priority.
+    // Takes effect the next time the video encoder is created.
+    void SetEncoderCpuLimits(const FBH_EncoderCpuLimits& InCpuLimits);
+
 private:
     UPROPERTY()
     TObjectPtr<UBH_FrameBuffer> FrameBuffer;
@@ -85,6 +108,14 @@ private:
     int32 MaxVideoWidth;
     int32 MaxVideoHeight;
 
+    // Triage proxy rendition, 0 when disabled
+    int32 TriageProxyHeight;
+    int32 TriageProxyBitrateKbps;
+
+    bool bIntraFrameCapture;
+
+    FBH_EncoderCpuLimits EncoderCpuLimits;
+
     void ReadPixels(const FTextureRHIRef& BackBuffer);
 
     void SetFrameData(int32 Width, int32 Height, const TArray<FColor>& Data);
@@ -94,6 +125,9 @@ private:
 
     void OnBackBufferResized(const FTextureRHIRef& BackBuffer);
 
+    // Drops the staging texture so it gets recreated with the current back buffer size
+    void ReleaseStagingTexture();
+
     //Hack TODO
     TSet<FString> CreatedWindows;
 };
@@ -1,10 +1,13 @@
 // Copyright (c) 2024-2026 Upsoft sp. z o. o.
 #include "BH_HttpRequest.h"
-#include "Misc/FileHelper.h"
+#include "BH_Log.h"
+#include "BH_BandwidthLimiter.h"
 #include "Misc/Paths.h"
 #include "GenericPlatform/GenericPlatformProcess.h"
+#include "Runtime/Launch/Resources/Version.h"
 
 BH_HttpRequest::BH_HttpRequest()
+    : FormData(MakeShared<FBH_MultipartBody, ESPMode::ThreadSafe>())
 {
     HttpRequest = FHttpModule::Get().CreateRequest();
     Boundary = TEXT("---------------------------") + FString::FromInt(FMath::Rand());
@@ -28,35 +31,98 @@ void BH_HttpRequest::SetHeader(const FString& HeaderName, const FString& HeaderV
 
 void BH_HttpRequest::AddField(const FString& Name, const FString& Value)
 {
-    FString FieldContent = FString::Printf(TEXT("--%s\r\nContent-Disposition: form-data; name=\"%s\"\r\n\r\n%s\r\n"), *Boundary, *Name, *Value);
-    FTCHARToUTF8 Convert(*FieldContent);
-    FormData.Append((uint8*)Convert.Get(), Convert.Length());
+    FormData->AppendText("--");
+    FormData->AppendText(Boundary);
+    FormData->AppendText("\r\nContent-Disposition: form-data; name=\"");
+    FormData->AppendText(Name);
+    FormData->AppendText("\"\r\n\r\n");
+    FormData->AppendText(Value);
+    FormData->AppendText("\r\n");
 }
 
 void BH_HttpRequest::AddFile(const FString& FieldName, const FString& FilePath, const FString& ContentType)
 {
     if (FPaths::FileExists(FilePath))
     {
-        TArray<uint8> FileData;
-        FFileHelper::LoadFileToArray(FileData, *FilePath);
-        FString FileHeader = FString::Printf(TEXT("--%s\r\nContent-Disposition: form-data; name=\"%s\"; filename=\"%s\"\r\nContent-Type: %s\r\n\r\n"), *Boundary, *FieldName, *FPaths::GetCleanFilename(FilePath), *ContentType);
-        FTCHARToUTF8 Convert(*FileHeader);
-        FormData.Append((uint8*)Convert.Get(), Convert.Length());
-        FormData.Append(FileData);
-        FormData.Append((uint8*)"\r\n", 2);
+        FormData->AppendText("--");
+        FormData->AppendText(Boundary);
+        FormData->AppendText("\r\nContent-Disposition: form-data; name=\"");
+        FormData->AppendText(FieldName);
+        FormData->AppendText("\"; filename=\"");
+        FormData->AppendText(FPaths::GetCleanFilename(FilePath));
+        FormData->AppendText("\"\r\nContent-Type: ");
+        FormData->AppendText(ContentType);
+        FormData->AppendText("\r\n\r\n");
+        FormData->AppendFile(FilePath);
+        FormData->AppendText("\r\n");
     }
 }
 
 void BH_HttpRequest::FinalizeFormData()
 {
-    FString EndBoundary = FString::Printf(TEXT("--%s--\r\n"), *Boundary);
-    FTCHARToUTF8 ConvertEndBoundary(*EndBoundary);
-    FormData.Append((uint8*)ConvertEndBoundary.Get(), ConvertEndBoundary.Length());
-    HttpRequest->SetContent(FormData);
+    FormData->AppendText("--");
+    FormData->AppendText(Boundary);
+    FormData->AppendText("--\r\n");
+
+    // The content length is the size of the body, known before anything is read
+    HttpRequest->SetContentFromStream(FormData);
 }
 
 void BH_HttpRequest::ProcessRequest(TFunction<void(FHttpRequestPtr, FHttpResponsePtr, bool)> Callback)
 {
     HttpRequest->OnProcessRequestComplete().BindLambda(Callback);
-    HttpRequest->ProcessRequest();
-}
\ No newline at end of file
+
+    // Attached screenshots and logs count against the upload bandwidth like the S3 uploads
+    TSharedRef<int64> ReportedBytes = MakeShared<int64>(0);
+#if ENGINE_MINOR_VERSION >= 4
+    HttpRequest->OnRequestProgress64().BindLambda(
+        [ReportedBytes](FHttpRequestPtr Request, uint64 BytesSent, uint64 BytesReceived)
+        {
+            BH_BandwidthLimiter::Get().AddSentBytes((int64)BytesSent - *ReportedBytes);
+            *ReportedBytes = (int64)BytesSent;
+        }
+    );
+#else
+    HttpRequest->OnRequestProgress().BindLambda(
+        [ReportedBytes](FHttpRequestPtr Request, int32 BytesSent, int32 BytesReceived)
+        {
+            BH_BandwidthLimiter::Get().AddSentBytes((int64)(uint32)BytesSent - *ReportedBytes);
+            *ReportedBytes = (int64)(uint32)BytesSent;
+        }
+    );
+#endif
+
+    TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request = HttpRequest;
+    BH_BandwidthLimiter::Get().WhenAvailable(FormData->TotalSize(), [Request]()
+    {
+        // Not started if the request was cancelled while waiting
+        if (Request->GetStatus() == EHttpRequestStatus::NotStarted)
+        {
+            Request->ProcessRequest();
+        }
+    });
+}
+
+void BH_HttpRequest::CancelRequest()
+{
+    HttpRequest->CancelRequest();
+}
+
+void BH_HttpRequest::PrewarmConnection(const FString& URL)
+{
+    if (URL.IsEmpty())
+    {
+        return;
+    }
+
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    Request->SetURL(URL);
+    Request->SetVerb(TEXT("HEAD"));
+    Request->SetTimeout(10.0f);
+    Request->OnProcessRequestComplete().BindLambda([](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
+    {
+        UE_LOG(LogBetaHub, Verbose, TEXT("Pre-warmed connection to %s: %s"),
+            *HttpRequest->GetURL(), bWasSuccessful ? TEXT("connected") : TEXT("failed"));
+    });
+    Request->ProcessRequest();
+}
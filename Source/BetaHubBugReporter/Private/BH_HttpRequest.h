@@ -4,13 +4,16 @@
 #include "CoreMinimal.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpRequest.h"
+#include "BH_MultipartBody.h"
 
 class BH_HttpRequest
 {
 private:
     TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HttpRequest;
     FString Boundary;
-    TArray<uint8> FormData;
+
+    // Streamed to the socket, attached files are read while the request is sent
+    TSharedRef<FBH_MultipartBody, ESPMode::ThreadSafe> FormData;
 
 public:
     BH_HttpRequest();
@@ -20,5 +23,20 @@ public:
     void AddField(const FString& Name, const FString& Value);
     void AddFile(const FString& FieldName, const FString& FilePath, const FString& ContentType);
     void FinalizeFormData();
+
+    /**
+     * Starts the request once the upload bandwidth limiter allows a body of its size
+     */
     void ProcessRequest(TFunction<void(FHttpRequestPtr, FHttpResponsePtr, bool)> Callback);
+
+    /**
+     * Aborts the request, its callback is called as failed
+     */
+    void CancelRequest();
+
+    /**
+     * Sends a HEAD request to a host so its DNS lookup and TLS handshake are done, and the connection
+     * is pooled, before the first real request to it. The response is ignored.
+     */
+    static void PrewarmConnection(const FString& URL);
 };
\ No newline at end of file
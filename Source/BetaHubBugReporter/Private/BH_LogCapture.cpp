@@ -1,14 +1,345 @@
 // Copyright (c) 2024-2026 Upsoft sp. z o. o.
 #include "BH_LogCapture.h"
+#include "BH_Log.h"
+
+// Distinct problems counted per session, spam of new ones beyond this is not counted
+static const int32 MaxDistinctProblems = 256;
+
+// Long messages (e.g. with call stacks) are cut, their start identifies them
+static const int32 MaxProblemLength = 160;
+
+// A thread's staging buffer is published once it holds this much
+static const int32 StagingChunkBytes = 64 * 1024;
+
+namespace
+{
+    // The staging buffer of the last capture the thread logged to, looked up without locking
+    struct FThreadStaging
+    {
+        uint32 CaptureId = 0;
+        void* Staging = nullptr;
+    };
+
+    thread_local FThreadStaging ThreadStaging;
+
+    std::atomic<uint32> NextCaptureId{1};
+
+    // Precedes the UTF-8 message of every record
+    struct FRecordHeader
+    {
+        uint64 Sequence;
+        double Time;            // FPlatformTime::Seconds()
+        uint64 Frame;
+        FName Category;
+        int32 Length;
+        uint8 Verbosity;
+    };
+}
+
+UBH_LogCapture::UBH_LogCapture(int64 InMaxBytes)
+    : MaxBytes(FMath::Max<int64>(InMaxBytes, StagingChunkBytes))
+    , Id(NextCaptureId.fetch_add(1))
+    , StartSeconds(FPlatformTime::Seconds())
+    , StartDateTime(FDateTime::Now())
+    , NextSequence(0)
+    , NumBytes(0)
+{
+}
+
+UBH_LogCapture::~UBH_LogCapture()
+{
+    // Unlinked one by one, releasing a long list at once would recurse through every chunk.
+    // Chunks still shared with a snapshot are released with it.
+    Newest.Reset();
+    while (Oldest.IsValid() && Oldest.IsUnique())
+    {
+        TSharedPtr<FBH_LogChunk, ESPMode::ThreadSafe> Next = MoveTemp(Oldest->Next);
+        Oldest = MoveTemp(Next);
+    }
+}
 
 void UBH_LogCapture::Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const class FName& Category)
 {
-    // Capture the log message
-    CapturedLogs.Append(V);
-    CapturedLogs.Append(TEXT("\n"));
+    const ELogVerbosity::Type Severity = (ELogVerbosity::Type)(Verbosity & ELogVerbosity::VerbosityMask);
+    // Console color changes are not lines
+    if (Severity == ELogVerbosity::SetColor)
+    {
+        return;
+    }
+
+    FRecordHeader Header;
+    Header.Sequence = NextSequence.fetch_add(1, std::memory_order_relaxed);
+    Header.Time = FPlatformTime::Seconds();
+    Header.Frame = GFrameCounter;
+    Header.Category = Category;
+    Header.Verbosity = (uint8)Severity;
+
+    const FTCHARToUTF8 Message(V);
+    Header.Length = Message.Length();
+
+    FStaging& Staging = GetStaging();
+    {
+        FScopeLock Lock(&Staging.Lock);
+
+        if (Staging.Data.Num() == 0)
+        {
+            Staging.FirstTime = Header.Time;
+        }
+        Staging.LastTime = Header.Time;
+
+        const int32 Offset = Staging.Data.AddUninitialized(sizeof(FRecordHeader) + Header.Length);
+        FMemory::Memcpy(Staging.Data.GetData() + Offset, &Header, sizeof(FRecordHeader));
+        FMemory::Memcpy(Staging.Data.GetData() + Offset + sizeof(FRecordHeader), Message.Get(), Header.Length);
+
+        if (Staging.Data.Num() >= StagingChunkBytes)
+        {
+            Publish(Staging);
+            Staging.Data.Reserve(StagingChunkBytes + 1024);
+        }
+    }
+
+    // The plugin's own upload warnings say nothing about the problem being reported
+    if (Severity <= ELogVerbosity::Warning && Severity != ELogVerbosity::NoLogging && Category != LogBetaHub.GetCategoryName())
+    {
+        const FString Problem = FString::Printf(TEXT("%c%s: %s"),
+            Severity == ELogVerbosity::Warning ? TEXT('W') : TEXT('E'), *Category.ToString(), *NormalizeProblem(V));
+
+        FScopeLock Lock(&ProblemsLock);
+        if (int32* Count = ProblemCounts.Find(Problem))
+        {
+            ++*Count;
+        }
+        else if (ProblemCounts.Num() < MaxDistinctProblems)
+        {
+            ProblemCounts.Add(Problem, 1);
+        }
+    }
 }
 
-FString UBH_LogCapture::GetCapturedLogs() const
+UBH_LogCapture::FStaging& UBH_LogCapture::GetStaging()
 {
-    return CapturedLogs;
-}
\ No newline at end of file
+    if (ThreadStaging.CaptureId != Id)
+    {
+        TUniquePtr<FStaging> Staging = MakeUnique<FStaging>();
+        Staging->Data.Reserve(StagingChunkBytes + 1024);
+
+        ThreadStaging.CaptureId = Id;
+        ThreadStaging.Staging = Staging.Get();
+
+        FScopeLock Lock(&StagingsLock);
+        Stagings.Add(MoveTemp(Staging));
+    }
+    return *static_cast<FStaging*>(ThreadStaging.Staging);
+}
+
+void UBH_LogCapture::Publish(FStaging& Staging)
+{
+    if (Staging.Data.Num() == 0)
+    {
+        return;
+    }
+
+    TSharedPtr<FBH_LogChunk, ESPMode::ThreadSafe> Chunk = MakeShared<FBH_LogChunk, ESPMode::ThreadSafe>();
+    Chunk->Data = MoveTemp(Staging.Data);
+    Chunk->FirstTime = Staging.FirstTime;
+    Chunk->LastTime = Staging.LastTime;
+
+    FScopeLock Lock(&ChunksLock);
+    NumBytes += Chunk->Data.Num();
+    if (Newest.IsValid())
+    {
+        Newest->Next = Chunk;
+    }
+    else
+    {
+        Oldest = Chunk;
+    }
+    Newest = Chunk;
+
+    // Whole chunks are dropped, snapshots still holding them keep them alive
+    while (NumBytes > MaxBytes && Oldest != Newest)
+    {
+        NumBytes -= Oldest->Data.Num();
+        Oldest = Oldest->Next;
+    }
+}
+
+FBH_LogSnapshot UBH_LogCapture::Snapshot()
+{
+    // The lines not published yet are the latest ones, the ones a report needs most
+    {
+        FScopeLock StagingsScope(&StagingsLock);
+        for (const TUniquePtr<FStaging>& Staging : Stagings)
+        {
+            FScopeLock Lock(&Staging->Lock);
+            Publish(*Staging);
+        }
+    }
+
+    FBH_LogSnapshot Result;
+    Result.StartSeconds = StartSeconds;
+    Result.StartDateTime = StartDateTime;
+
+    FScopeLock Lock(&ChunksLock);
+    Result.First = Oldest;
+    Result.Last = Newest.Get();
+    Result.NumBytes = NumBytes;
+    return Result;
+}
+
+FBH_LogSnapshot UBH_LogCapture::Snapshot(double StartTime, double EndTime)
+{
+    FBH_LogSnapshot Result = Snapshot();
+    Result.WindowStart = StartTime;
+    Result.WindowEnd = EndTime;
+    return Result;
+}
+
+FString UBH_LogCapture::GetCapturedLogs()
+{
+    return Snapshot().ToString();
+}
+
+FString UBH_LogCapture::ExportLogs(double StartTime, double EndTime)
+{
+    return Snapshot().ToString(StartTime, EndTime);
+}
+
+FString FBH_LogSnapshot::ToString() const
+{
+    return ToString(WindowStart, WindowEnd);
+}
+
+FString FBH_LogSnapshot::ToString(double StartTime, double EndTime) const
+{
+    struct FRecord
+    {
+        FRecordHeader Header;
+        const ANSICHAR* Message;
+    };
+
+    // Each thread publishes its own chunks, the sequence numbers put the lines back in the order they were logged
+    TArray<FRecord> Records;
+    int64 MessageBytes = 0;
+    for (const FBH_LogChunk* Chunk = First.Get(); Chunk; Chunk = Chunk == Last ? nullptr : Chunk->Next.Get())
+    {
+        if (Chunk->LastTime < StartTime || Chunk->FirstTime > EndTime)
+        {
+            continue;
+        }
+
+        const uint8* Data = Chunk->Data.GetData();
+        const uint8* End = Data + Chunk->Data.Num();
+        while (Data < End)
+        {
+            FRecord Record;
+            FMemory::Memcpy(&Record.Header, Data, sizeof(FRecordHeader));
+            Record.Message = reinterpret_cast<const ANSICHAR*>(Data + sizeof(FRecordHeader));
+            Data += sizeof(FRecordHeader) + Record.Header.Length;
+
+            if (Record.Header.Time >= StartTime && Record.Header.Time <= EndTime)
+            {
+                Records.Add(Record);
+                MessageBytes += Record.Header.Length;
+            }
+        }
+    }
+
+    Records.Sort([](const FRecord& A, const FRecord& B) { return A.Header.Sequence < B.Header.Sequence; });
+
+    // Same layout as the engine's log file: [2026.01.31-12.00.00:000][123]LogCategory: Warning: Message
+    FString Result;
+    Result.Reserve(MessageBytes + Records.Num() * 64);
+    for (const FRecord& Record : Records)
+    {
+        const FDateTime Timestamp = StartDateTime + FTimespan::FromSeconds(Record.Header.Time - StartSeconds);
+        Result.Appendf(TEXT("[%s][%3d]"), *Timestamp.ToString(TEXT("%Y.%m.%d-%H.%M.%S:%s")), (int32)(Record.Header.Frame % 1000));
+
+        if (Record.Header.Category != NAME_None)
+        {
+            Record.Header.Category.AppendString(Result);
+            Result.Append(TEXT(": "));
+        }
+        if (Record.Header.Verbosity != ELogVerbosity::Log)
+        {
+            Result.Append(::ToString((ELogVerbosity::Type)Record.Header.Verbosity));
+            Result.Append(TEXT(": "));
+        }
+
+        const FUTF8ToTCHAR Message(Record.Message, Record.Header.Length);
+        Result.Append(Message.Get(), Message.Length());
+        Result.AppendChar(TEXT('\n'));
+    }
+    return Result;
+}
+
+TArray<FString> UBH_LogCapture::GetTopProblems(int32 MaxLines) const
+{
+    TArray<TPair<FString, int32>> Problems;
+    {
+        FScopeLock Lock(&ProblemsLock);
+        Problems = ProblemCounts.Array();
+    }
+
+    Problems.Sort([](const TPair<FString, int32>& A, const TPair<FString, int32>& B)
+    {
+        // 'E' sorts before 'W', ties keep a stable order so the same problems give the same lines
+        if (A.Key[0] != B.Key[0])
+        {
+            return A.Key[0] < B.Key[0];
+        }
+        return A.Value != B.Value ? A.Value > B.Value : A.Key < B.Key;
+    });
+
+    TArray<FString> Lines;
+    for (int32 Index = 0; Index < Problems.Num() && Index < MaxLines; ++Index)
+    {
+        const FString& Problem = Problems[Index].Key;
+        Lines.Add((Problem[0] == TEXT('E') ? TEXT("Error: ") : TEXT("Warning: ")) + Problem.Mid(1));
+    }
+    return Lines;
+}
+
+FString UBH_LogCapture::NormalizeProblem(const TCHAR* Message)
+{
+    FString Result;
+    Result.Reserve(MaxProblemLength);
+
+    for (const TCHAR* Char = Message; *Char && Result.Len() < MaxProblemLength; ++Char)
+    {
+        if (Char[0] == TEXT('0') && (Char[1] == TEXT('x') || Char[1] == TEXT('X')))
+        {
+            // Addresses and handles
+            Char += 2;
+            while (FChar::IsHexDigit(*Char))
+            {
+                ++Char;
+            }
+            --Char;
+            Result.Append(TEXT("0x#"));
+        }
+        else if (FChar::IsDigit(*Char))
+        {
+            // Counts, coordinates, frame numbers and instance suffixes like BP_Enemy_C_12
+            while (FChar::IsDigit(Char[1]) || Char[1] == TEXT('.'))
+            {
+                ++Char;
+            }
+            Result.AppendChar(TEXT('#'));
+        }
+        else if (FChar::IsWhitespace(*Char))
+        {
+            if (Result.Len() > 0 && Result[Result.Len() - 1] != TEXT(' '))
+            {
+                Result.AppendChar(TEXT(' '));
+            }
+        }
+        else
+        {
+            Result.AppendChar(*Char);
+        }
+    }
+
+    Result.TrimEndInline();
+    return Result;
+}
@@ -3,14 +3,164 @@
 
 #include "CoreMinimal.h"
 #include "Misc/OutputDevice.h"
+#include "HAL/CriticalSection.h"
+#include <atomic>
 
+/**
+ * Log records published together by one thread. Not modified once published, except for the link to the next chunk.
+ */
+struct FBH_LogChunk
+{
+    // Binary records, each a header followed by the UTF-8 message, formatted only when exported
+    TArray<uint8> Data;
+
+    // Time of the oldest and newest record, chunks outside an exported window are skipped
+    double FirstTime = 0.0;
+    double LastTime = 0.0;
+
+    // Newer chunk, set under the capture's lock when it is published
+    TSharedPtr<FBH_LogChunk, ESPMode::ThreadSafe> Next;
+};
+
+/**
+ * The captured logs at the moment the snapshot was taken. Copies nothing: it shares the chunks with the capture
+ * and keeps them alive after the capture drops them. Meant to be formatted and released, not kept for the session.
+ */
+class FBH_LogSnapshot
+{
+public:
+    /**
+     * Formats the lines of the snapshot's time window in the order they were logged, one per line,
+     * like the engine's log file. Can take a while for a full capture, call it on a worker thread.
+     */
+    FString ToString() const;
+
+    /**
+     * Formats only the lines logged within a time window
+     *
+     * @param StartTime     FPlatformTime::Seconds() of the oldest line to include
+     * @param EndTime       FPlatformTime::Seconds() of the newest line to include
+     */
+    FString ToString(double StartTime, double EndTime) const;
+
+    int64 GetNumBytes() const { return NumBytes; }
+    bool IsEmpty() const { return NumBytes == 0; }
+
+private:
+    friend class UBH_LogCapture;
+
+    TSharedPtr<FBH_LogChunk, ESPMode::ThreadSafe> First;
+    const FBH_LogChunk* Last = nullptr;
+    int64 NumBytes = 0;
+
+    // The capture's start, to turn record times into the wall clock
+    double StartSeconds = 0.0;
+    FDateTime StartDateTime;
+
+    // Lines formatted by ToString(), all of them by default
+    double WindowStart = TNumericLimits<double>::Lowest();
+    double WindowEnd = TNumericLimits<double>::Max();
+};
+
+/**
+ * Keeps the latest logs of the session for bug reports, up to a byte cap beyond which the oldest are dropped.
+ * Serialize is called on every thread that logs. Each thread writes to its own staging buffer, which is published
+ * to the shared list of chunks when full or when a snapshot is taken, so threads do not wait for each other.
+ */
 class UBH_LogCapture : public FOutputDevice
 {
 public:
+    /**
+     * @param InMaxBytes    Size of the kept logs, the newest chunk is kept even if it is larger
+     */
+    explicit UBH_LogCapture(int64 InMaxBytes);
+    virtual ~UBH_LogCapture();
+
     virtual void Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const class FName& Category) override;
+    virtual bool CanBeUsedOnAnyThread() const override { return true; }
+    virtual bool CanBeUsedOnMultipleThreads() const override { return true; }
+    virtual bool IsMemoryOnly() const override { return true; }
 
-    FString GetCapturedLogs() const;
+    /**
+     * Takes the logs captured so far, including the lines still in the threads' staging buffers
+     */
+    FBH_LogSnapshot Snapshot();
+
+    /**
+     * Takes the logs captured so far, to be formatted only within a time window
+     *
+     * @param StartTime     FPlatformTime::Seconds() of the oldest line to include
+     * @param EndTime       FPlatformTime::Seconds() of the newest line to include
+     */
+    FBH_LogSnapshot Snapshot(double StartTime, double EndTime);
+
+    FString GetCapturedLogs();
+
+    /**
+     * Formats the lines logged within a time window, e.g. the one covered by a recorded video
+     *
+     * @param StartTime     FPlatformTime::Seconds() of the oldest line to include
+     * @param EndTime       FPlatformTime::Seconds() of the newest line to include
+     */
+    FString ExportLogs(double StartTime, double EndTime);
+
+    /**
+     * The errors and warnings logged most often, normalized so repeats of the same problem with different
+     * numbers, addresses or object names are counted together. Errors come first.
+     *
+     * @param MaxLines      How many lines to return at most
+     * @return              Lines in the form "Error: LogCategory: message"
+     */
+    TArray<FString> GetTopProblems(int32 MaxLines) const;
 
 private:
-    FString CapturedLogs;
-};
\ No newline at end of file
+    struct FStaging
+    {
+        // Taken by the owning thread for every line, contended only while a snapshot publishes the buffer
+        FCriticalSection Lock;
+        TArray<uint8> Data;
+        double FirstTime = 0.0;
+        double LastTime = 0.0;
+    };
+
+    /**
+     * The calling thread's staging buffer, created on its first line
+     */
+    FStaging& GetStaging();
+
+    /**
+     * Moves the staged records to the shared list and drops the oldest chunks beyond the cap
+     */
+    void Publish(FStaging& Staging);
+
+    /**
+     * Replaces the parts of a message that differ between repeats of the same problem
+     */
+    static FString NormalizeProblem(const TCHAR* Message);
+
+    const int64 MaxBytes;
+
+    // Identifies this capture in the threads' cached staging buffers
+    const uint32 Id;
+
+    const double StartSeconds;
+    const FDateTime StartDateTime;
+
+    // Orders the lines of different threads
+    std::atomic<uint64> NextSequence;
+
+    // Shared list of published chunks, oldest first
+    FCriticalSection ChunksLock;
+    TSharedPtr<FBH_LogChunk, ESPMode::ThreadSafe> Oldest;
+    TSharedPtr<FBH_LogChunk, ESPMode::ThreadSafe> Newest;
+    int64 NumBytes;
+
+    // Taken once per thread, and by snapshots
+    FCriticalSection StagingsLock;
+    TArray<TUniquePtr<FStaging>> Stagings;
+
+    mutable FCriticalSection ProblemsLock;
+
+    // Occurrences of each normalized error and warning, with the severity as its first character
+    TMap<FString, int32> ProblemCounts;
+};
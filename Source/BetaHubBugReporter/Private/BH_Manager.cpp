@@ -13,6 +13,11 @@ UBH_Manager::UBH_Manager()
     Settings = GetMutableDefault<UBH_PluginSettings>();
 }
 
+UBH_BackgroundService* UBH_Manager::GetBackgroundService() const
+{
+    return BackgroundService;
+}
+
 void UBH_Manager::StartService(UGameInstance* GI)
 {
     if (BackgroundService)
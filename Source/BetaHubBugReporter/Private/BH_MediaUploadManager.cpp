@@ -1,23 +1,46 @@
 // Copyright (c) 2024-2026 Upsoft sp. z o. o.
 #include "BH_MediaUploadManager.h"
 #include "BH_MediaTypes.h"
+#include "BH_PluginSettings.h"
+#include "BH_ReportBundle.h"
 #include "BH_Log.h"
-#include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
-#include "HAL/PlatformFilemanager.h"
-#include "HAL/PlatformProcess.h"
-#include "Misc/Guid.h"
+#include "HAL/FileManager.h"
 
 BH_MediaUploadManager::BH_MediaUploadManager()
-    : CurrentUploadIndex(0)
-    , bCancelRequested(false)
+    : CompletedFiles(0)
+    , GroupId(INDEX_NONE)
+    , TotalBytes(0)
+    , CompletedBytes(0)
+    , bHoldConfirmations(false)
 {
-    S3Uploader = MakeShareable(new BH_S3Uploader());
+    bBundleSmallFiles = GetDefault<UBH_PluginSettings>()->bBundleSmallAttachments;
 }
 
 BH_MediaUploadManager::~BH_MediaUploadManager()
 {
-    CleanupTempFiles();
+    // Outstanding uploads call back into this object, abort them without notifying the owner
+    ProgressCallback.Unbind();
+    CompleteCallback.Unbind();
+    FileStageCallback.Unbind();
+    FileCompleteCallback.Unbind();
+    CancelUploads();
+}
+
+void BH_MediaUploadManager::SetFileCallbacks(const FOnFileStage& OnStage, const FOnFileComplete& OnComplete)
+{
+    FileStageCallback = OnStage;
+    FileCompleteCallback = OnComplete;
+}
+
+void BH_MediaUploadManager::SetUploadedBlobs(const TMap<FString, FString>& InUploadedBlobs)
+{
+    UploadedBlobs = InUploadedBlobs;
+}
+
+void BH_MediaUploadManager::SetHoldConfirmations(bool bInHoldConfirmations)
+{
+    bHoldConfirmations = bInHoldConfirmations;
 }
 
 void BH_MediaUploadManager::UploadMediaFiles(
@@ -31,10 +54,17 @@ void BH_MediaUploadManager::UploadMediaFiles(
     const FOnProgressUpdate& OnProgress,
     const FOnUploadComplete& OnComplete)
 {
+    if (GroupId != INDEX_NONE && CompletedFiles < UploadQueue.Num())
+    {
+        UE_LOG(LogBetaHub, Warning, TEXT("New media upload started before the previous one finished, cancelling it"));
+        CancelUploads();
+    }
+
     // Reset state
     UploadQueue.Empty();
-    CurrentUploadIndex = 0;
-    bCancelRequested = false;
+    CompletedFiles = 0;
+    InFlightBytes.Empty();
+    GroupId = BH_UploadScheduler::Get().CreateGroup();
     UploadResult = FMediaUploadResult();
     UploadResult.bSuccess = true;
     UploadResult.ScreenshotsUploaded = 0;
@@ -42,11 +72,7 @@ void BH_MediaUploadManager::UploadMediaFiles(
     UploadResult.LogsUploaded = 0;
     UploadResult.TotalFilesUploaded = 0;
 
-    // Store parameters
-    CurrentBaseUrl = BaseUrl;
-    CurrentProjectId = ProjectId;
-    CurrentIssueId = IssueId;
-    CurrentApiToken = ApiToken;
+    // Store callbacks
     ProgressCallback = OnProgress;
     CompleteCallback = OnComplete;
 
@@ -85,7 +111,7 @@ void BH_MediaUploadManager::UploadMediaFiles(
             }
 
             Task.FilePath = Video.FilePath;
-            Task.bIsTempFile = false;
+            Task.SourcePath = Video.FilePath;
         }
         else
         {
@@ -142,7 +168,7 @@ void BH_MediaUploadManager::UploadMediaFiles(
             }
 
             Task.FilePath = Screenshot.FilePath;
-            Task.bIsTempFile = false;
+            Task.SourcePath = Screenshot.FilePath;
         }
         else
         {
@@ -190,54 +216,24 @@ void BH_MediaUploadManager::UploadMediaFiles(
 
         if (bHasFilePath)
         {
-            // File path provided - check if it exists and read it
+            // File path provided - uploaded as it is, without reading it here
             if (!FPaths::FileExists(Log.FilePath))
             {
                 UE_LOG(LogBetaHub, Warning, TEXT("Log file not found, skipping: %s"), *Log.FilePath);
                 continue;
             }
 
-            // Read file content
-            FString FileContent;
-            if (!FFileHelper::LoadFileToString(FileContent, *Log.FilePath))
-            {
-                UE_LOG(LogBetaHub, Error, TEXT("Failed to read log file, skipping: %s"), *Log.FilePath);
-                continue;
-            }
-
-            // Create temp file from content
-            FString TempLogPath = CreateTempFile(FileContent, TEXT("log"), LogIndex - 1, Log.Name);
-            if (TempLogPath.IsEmpty())
-            {
-                UE_LOG(LogBetaHub, Error, TEXT("Failed to create temp file for log: %s"), *Log.FilePath);
-                continue;
-            }
-
-            Task.FilePath = TempLogPath;
-            Task.ContentType = BH_MediaTypeHelper::GetDefaultContentType(EBH_MediaType::LogFile, TempLogPath);
-            Task.bIsTempFile = true;
-            TempFilesToCleanup.Add(TempLogPath);
+            Task.FilePath = Log.FilePath;
+            Task.SourcePath = Log.FilePath;
+            Task.ContentType = BH_MediaTypeHelper::GetDefaultContentType(EBH_MediaType::LogFile, Log.FilePath);
         }
         else
         {
-            // Content provided - create temp file
-            if (Log.Content.IsEmpty())
-            {
-                UE_LOG(LogBetaHub, Warning, TEXT("Log content is empty, skipping"));
-                continue;
-            }
-
-            FString TempLogPath = CreateTempFile(Log.Content, TEXT("log"), LogIndex - 1, Log.Name);
-            if (TempLogPath.IsEmpty())
-            {
-                UE_LOG(LogBetaHub, Error, TEXT("Failed to create temp file for log content"));
-                continue;
-            }
-
-            Task.FilePath = TempLogPath;
-            Task.ContentType = BH_MediaTypeHelper::GetDefaultContentType(EBH_MediaType::LogFile, TempLogPath);
-            Task.bIsTempFile = true;
-            TempFilesToCleanup.Add(TempLogPath);
+            // Content provided - encoded to UTF-8 once and uploaded from memory
+            FTCHARToUTF8 Utf8Content(*Log.Content, Log.Content.Len());
+            Task.Content = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>((const uint8*)Utf8Content.Get(), Utf8Content.Length());
+            Task.FilePath = LogIndex > 1 ? FString::Printf(TEXT("log_%d.log"), LogIndex) : TEXT("log.log");
+            Task.ContentType = BH_MediaTypeHelper::GetDefaultContentType(EBH_MediaType::LogFile, Task.FilePath);
         }
 
         if (Logs.Num() > 1)
@@ -262,9 +258,149 @@ void BH_MediaUploadManager::UploadMediaFiles(
         return;
     }
 
-    // Start uploading
-    UE_LOG(LogBetaHub, Log, TEXT("Starting upload of %d media files"), UploadQueue.Num());
-    ProcessNextUpload();
+    TotalBytes = 0;
+    CompletedBytes = 0;
+    for (FUploadTask& Task : UploadQueue)
+    {
+        Task.FileSize = Task.Content.IsValid() ? Task.Content->Num() : FMath::Max<int64>(IFileManager::Get().FileSize(*Task.FilePath), 0);
+        TotalBytes += Task.FileSize;
+    }
+
+    // Small files go up as one archive, a single file gains nothing from it
+    TArray<int32> BundledTasks;
+    // A bundle is rebuilt for each upload, it cannot be confirmed later
+    if (bBundleSmallFiles && !bHoldConfirmations)
+    {
+        for (int32 TaskIndex = 0; TaskIndex < UploadQueue.Num(); TaskIndex++)
+        {
+            const FUploadTask& Task = UploadQueue[TaskIndex];
+            if (Task.MediaType != EBH_MediaType::Video && Task.FileSize <= BH_ReportBundle::MaxEntryBytes
+                && !UploadedBlobs.Contains(Task.SourcePath))
+            {
+                BundledTasks.Add(TaskIndex);
+            }
+        }
+
+        if (BundledTasks.Num() < 2)
+        {
+            BundledTasks.Reset();
+        }
+    }
+
+    // Queue everything at once, the scheduler decides the order and how many run in parallel
+    UE_LOG(LogBetaHub, Log, TEXT("Starting upload of %d media files (%lld bytes)"), UploadQueue.Num(), TotalBytes);
+    UpdateProgress(0, 0);
+
+    BH_UploadScheduler& Scheduler = BH_UploadScheduler::Get();
+
+    if (BundledTasks.Num() > 0)
+    {
+        EnqueueBundle(BaseUrl, ProjectId, IssueId, ApiToken, BundledTasks);
+    }
+
+    const int32 NumTasks = UploadQueue.Num();
+    for (int32 TaskIndex = 0; TaskIndex < NumTasks; TaskIndex++)
+    {
+        if (BundledTasks.Contains(TaskIndex))
+        {
+            continue;
+        }
+
+        const FUploadTask& Task = UploadQueue[TaskIndex];
+
+        BH_UploadScheduler::FUploadRequest Request;
+        Request.BaseUrl = BaseUrl;
+        Request.ProjectId = ProjectId;
+        Request.IssueId = IssueId;
+        Request.ApiToken = ApiToken;
+        Request.MediaType = Task.MediaType;
+        Request.FilePath = Task.FilePath;
+        Request.Content = Task.Content;
+        Request.ContentType = Task.ContentType;
+        Request.CustomName = Task.CustomName;
+        Request.FileSize = Task.FileSize;
+        Request.bHoldConfirmation = bHoldConfirmations;
+
+        if (const FString* BlobSignedId = UploadedBlobs.Find(Task.SourcePath))
+        {
+            Request.UploadedBlobSignedId = *BlobSignedId;
+        }
+
+        Scheduler.Enqueue(
+            GroupId,
+            Request,
+            BH_S3Uploader::FOnUploadComplete::CreateLambda([this, TaskIndex](const BH_S3Uploader::FUploadResult& Result)
+            {
+                OnTaskComplete(TaskIndex, Result);
+            }),
+            BH_S3Uploader::FOnUploadProgress::CreateLambda([this, TaskIndex](int64 BytesSent, int64 FileBytes)
+            {
+                // Compressed files send fewer bytes than their size on disk, progress is kept relative to the original
+                const int64 TaskFileSize = UploadQueue[TaskIndex].FileSize;
+                UpdateProgress(TaskIndex, FileBytes > 0 && FileBytes != TaskFileSize ? BytesSent * TaskFileSize / FileBytes : BytesSent);
+            }),
+            BH_S3Uploader::FOnUploadStage::CreateLambda([this, TaskIndex](EBH_UploadStage Stage, const FString& BlobSignedId)
+            {
+                FileStageCallback.ExecuteIfBound(UploadQueue[TaskIndex].SourcePath, Stage, BlobSignedId);
+            })
+        );
+    }
+}
+
+void BH_MediaUploadManager::EnqueueBundle(
+    const FString& BaseUrl,
+    const FString& ProjectId,
+    const FString& IssueId,
+    const FString& ApiToken,
+    const TArray<int32>& TaskIndices)
+{
+    BH_UploadScheduler::FUploadRequest Request;
+    Request.BaseUrl = BaseUrl;
+    Request.ProjectId = ProjectId;
+    Request.IssueId = IssueId;
+    Request.ApiToken = ApiToken;
+    Request.MediaType = EBH_MediaType::Bundle;
+    Request.FilePath = BH_ReportBundle::Filename;
+    Request.ContentType = BH_MediaTypeHelper::GetDefaultContentType(EBH_MediaType::Bundle, Request.FilePath);
+    Request.FileSize = 0;
+    Request.bHoldConfirmation = false;
+
+    for (int32 TaskIndex : TaskIndices)
+    {
+        const FUploadTask& Task = UploadQueue[TaskIndex];
+
+        BH_ReportBundle::FEntry Entry;
+        Entry.MediaType = Task.MediaType;
+        Entry.FilePath = Task.FilePath;
+        Entry.Content = Task.Content;
+        Entry.ContentType = Task.ContentType;
+        Entry.Name = Task.CustomName;
+        Request.BundleEntries.Add(Entry);
+
+        Request.FileSize += Task.FileSize;
+    }
+
+    UE_LOG(LogBetaHub, Log, TEXT("Bundling %d small files (%lld bytes) into one upload"), TaskIndices.Num(), Request.FileSize);
+
+    // Each file of the bundle completes with the bundle, the archive is rebuilt if the report is retried,
+    // so the stages of the bundle are not reported for its files
+    const int64 BundleBytes = Request.FileSize;
+    BH_UploadScheduler::Get().Enqueue(
+        GroupId,
+        Request,
+        BH_S3Uploader::FOnUploadComplete::CreateLambda([this, TaskIndices](const BH_S3Uploader::FUploadResult& Result)
+        {
+            for (int32 TaskIndex : TaskIndices)
+            {
+                OnTaskComplete(TaskIndex, Result);
+            }
+        }),
+        BH_S3Uploader::FOnUploadProgress::CreateLambda([this, TaskIndices, BundleBytes](int64 BytesSent, int64 FileBytes)
+        {
+            // The archive is smaller than its files, its progress is counted against the first one
+            UpdateProgress(TaskIndices[0], FileBytes > 0 ? BytesSent * BundleBytes / FileBytes : BytesSent);
+        })
+    );
 }
 
 void BH_MediaUploadManager::UploadMediaFiles(
@@ -382,109 +518,95 @@ void BH_MediaUploadManager::UploadMediaFiles(
     );
 }
 
-void BH_MediaUploadManager::ProcessNextUpload()
+void BH_MediaUploadManager::OnTaskComplete(int32 TaskIndex, const BH_S3Uploader::FUploadResult& Result)
 {
-    if (bCancelRequested)
-    {
-        UE_LOG(LogBetaHub, Warning, TEXT("Upload cancelled"));
-        UploadResult.bSuccess = false;
-        UploadResult.Errors.Add(TEXT("Upload cancelled by user"));
-        CompleteUpload();
-        return;
-    }
+    const FUploadTask& Task = UploadQueue[TaskIndex];
 
-    if (CurrentUploadIndex >= UploadQueue.Num())
+    if (Result.bSuccess)
     {
-        // All uploads complete
-        CompleteUpload();
-        return;
-    }
+        UE_LOG(LogBetaHub, Log, TEXT("%s uploaded successfully"), *Task.Description);
 
-    const FUploadTask& Task = UploadQueue[CurrentUploadIndex];
-
-    // Update progress
-    UpdateProgress(Task.Description, 0.0f);
-
-    UE_LOG(LogBetaHub, Log, TEXT("Uploading %s (%d of %d)"),
-        *Task.Description, CurrentUploadIndex + 1, UploadQueue.Num());
+        // Track success by media type
+        switch (Task.MediaType)
+        {
+            case EBH_MediaType::Video:
+                UploadResult.VideosUploaded++;
+                break;
+            case EBH_MediaType::Screenshot:
+                UploadResult.ScreenshotsUploaded++;
+                break;
+            case EBH_MediaType::LogFile:
+                UploadResult.LogsUploaded++;
+                break;
+            case EBH_MediaType::Bundle:
+                // Files of a bundle are counted by their own type
+                break;
+        }
 
-    // Perform upload
-    BH_S3Uploader::FOnUploadComplete UploadDelegate;
-    UploadDelegate.BindLambda([this, Task](const BH_S3Uploader::FUploadResult& Result)
+        UploadResult.TotalFilesUploaded++;
+    }
+    else
     {
-        if (Result.bSuccess)
-        {
-            UE_LOG(LogBetaHub, Log, TEXT("%s uploaded successfully"), *Task.Description);
+        UE_LOG(LogBetaHub, Error, TEXT("Failed to upload %s: %s"),
+            *Task.Description, *Result.ErrorMessage);
 
-            // Track success by media type
-            switch (Task.MediaType)
-            {
-                case EBH_MediaType::Video:
-                    UploadResult.VideosUploaded++;
-                    break;
-                case EBH_MediaType::Screenshot:
-                    UploadResult.ScreenshotsUploaded++;
-                    break;
-                case EBH_MediaType::LogFile:
-                    UploadResult.LogsUploaded++;
-                    break;
-            }
+        UploadResult.Errors.Add(FString::Printf(TEXT("%s: %s"),
+            *Task.Description, *Result.ErrorMessage));
+    }
 
-            UploadResult.TotalFilesUploaded++;
-        }
-        else
-        {
-            UE_LOG(LogBetaHub, Error, TEXT("Failed to upload %s: %s"),
-                *Task.Description, *Result.ErrorMessage);
+    FileCompleteCallback.ExecuteIfBound(Task.SourcePath, Result);
 
-            UploadResult.Errors.Add(FString::Printf(TEXT("%s: %s"),
-                *Task.Description, *Result.ErrorMessage));
-        }
+    // The content is no longer needed, the task itself stays for the final summary
+    UploadQueue[TaskIndex].Content.Reset();
 
-        // Clean up temp file if needed
-        if (Task.bIsTempFile && FPaths::FileExists(Task.FilePath))
-        {
-            IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-            PlatformFile.DeleteFile(*Task.FilePath);
-        }
+    InFlightBytes.Remove(TaskIndex);
+    CompletedBytes += Task.FileSize;
+    CompletedFiles++;
 
-        // Move to next upload
-        CurrentUploadIndex++;
-        ProcessNextUpload();
-    });
-
-    // Convert enum to API endpoint string for S3 uploader
-    FString MediaEndpoint = BH_MediaTypeHelper::GetAPIEndpoint(Task.MediaType);
-
-    S3Uploader->UploadFileToS3(
-        CurrentBaseUrl,
-        CurrentProjectId,
-        CurrentIssueId,
-        CurrentApiToken,
-        MediaEndpoint,
-        Task.FilePath,
-        Task.ContentType,
-        Task.CustomName,
-        UploadDelegate
-    );
+    if (CompletedFiles >= UploadQueue.Num())
+    {
+        CompleteUpload();
+    }
+    else
+    {
+        UpdateProgress(TaskIndex, 0);
+    }
 }
 
-void BH_MediaUploadManager::UpdateProgress(const FString& CurrentFile, float Percent)
+void BH_MediaUploadManager::UpdateProgress(int32 TaskIndex, int64 TaskBytesSent)
 {
+    if (TaskBytesSent > 0)
+    {
+        InFlightBytes.Add(TaskIndex, TaskBytesSent);
+    }
+
+    int64 InFlightTotal = 0;
+    for (const TPair<int32, int64>& Pair : InFlightBytes)
+    {
+        InFlightTotal += Pair.Value;
+    }
+
     FUploadProgress Progress;
     Progress.TotalFiles = UploadQueue.Num();
-    Progress.CompletedFiles = CurrentUploadIndex;
-    Progress.CurrentFile = CurrentFile;
-    Progress.ProgressPercent = ((float)CurrentUploadIndex + Percent) / (float)UploadQueue.Num() * 100.0f;
+    Progress.CompletedFiles = CompletedFiles;
+    Progress.CurrentFile = UploadQueue[TaskIndex].Description;
+    Progress.BytesSent = CompletedBytes + InFlightTotal;
+    Progress.TotalBytes = TotalBytes;
+
+    if (TotalBytes > 0)
+    {
+        Progress.ProgressPercent = FMath::Min((float)((double)Progress.BytesSent / (double)TotalBytes * 100.0), 100.0f);
+    }
+    else
+    {
+        Progress.ProgressPercent = (float)CompletedFiles / (float)UploadQueue.Num() * 100.0f;
+    }
 
     ProgressCallback.ExecuteIfBound(Progress);
 }
 
 void BH_MediaUploadManager::CompleteUpload()
 {
-    // Clean up any temporary files
-    CleanupTempFiles();
-
     // Determine overall success (at least one file uploaded successfully)
     UploadResult.bSuccess = (UploadResult.TotalFilesUploaded > 0) ||
                             (UploadQueue.Num() == 0); // Success if no files to upload
@@ -510,7 +632,11 @@ void BH_MediaUploadManager::CompleteUpload()
 
 void BH_MediaUploadManager::CancelUploads()
 {
-    bCancelRequested = true;
+    // Every outstanding file completes as cancelled through OnTaskComplete
+    if (GroupId != INDEX_NONE)
+    {
+        BH_UploadScheduler::Get().CancelGroup(GroupId);
+    }
 }
 
 FString BH_MediaUploadManager::GetContentTypeForFile(const FString& FilePath)
@@ -521,56 +647,3 @@ FString BH_MediaUploadManager::GetContentTypeForFile(const FString& FilePath)
         FilePath
     );
 }
-
-FString BH_MediaUploadManager::CreateTempFile(const FString& Contents, const FString& Extension, int32 Index, const FString& CustomName)
-{
-    // Generate unique temp file name
-    FString TempDir = FPaths::ProjectSavedDir() / TEXT("BetaHub") / TEXT("Temp");
-    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-
-    // Create temp directory if it doesn't exist
-    if (!PlatformFile.DirectoryExists(*TempDir))
-    {
-        PlatformFile.CreateDirectoryTree(*TempDir);
-    }
-
-    // Create filename - use GUID for local file safety (custom name is sent to server only)
-    FString Filename;
-    if (Index > 0)
-    {
-        Filename = FString::Printf(TEXT("betahub_%s_%d.%s"),
-            *FGuid::NewGuid().ToString(), Index, *Extension);
-    }
-    else
-    {
-        Filename = FString::Printf(TEXT("betahub_%s.%s"),
-            *FGuid::NewGuid().ToString(), *Extension);
-    }
-
-    FString FilePath = TempDir / Filename;
-
-    // Write contents to file
-    if (FFileHelper::SaveStringToFile(Contents, *FilePath))
-    {
-        return FilePath;
-    }
-
-    UE_LOG(LogBetaHub, Error, TEXT("Failed to create temp file: %s"), *FilePath);
-    return FString();
-}
-
-void BH_MediaUploadManager::CleanupTempFiles()
-{
-    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-
-    for (const FString& TempFile : TempFilesToCleanup)
-    {
-        if (PlatformFile.FileExists(*TempFile))
-        {
-            PlatformFile.DeleteFile(*TempFile);
-            UE_LOG(LogBetaHub, Verbose, TEXT("Deleted temp file: %s"), *TempFile);
-        }
-    }
-
-    TempFilesToCleanup.Empty();
-}
\ No newline at end of file
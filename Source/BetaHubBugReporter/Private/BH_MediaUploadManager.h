@@ -3,11 +3,13 @@
 
 #include "CoreMinimal.h"
 #include "BH_S3Uploader.h"
+#include "BH_UploadScheduler.h"
 #include "BH_MediaTypes.h"
 
 /**
- * Manages sequential upload of multiple media files to BetaHub
+ * Manages the upload of the media files of one report to BetaHub
  * Supports multiple files of each type (screenshots, videos, logs)
+ * The files are uploaded in parallel by BH_UploadScheduler, this class aggregates their results
  */
 class BH_MediaUploadManager
 {
@@ -24,6 +26,8 @@ public:
         int32 CompletedFiles;
         FString CurrentFile;
         float ProgressPercent;
+        int64 BytesSent;               // Bytes uploaded so far across all files
+        int64 TotalBytes;              // Bytes of all files in the upload
     };
 
     /**
@@ -46,7 +50,31 @@ public:
     DECLARE_DELEGATE_OneParam(FOnUploadComplete, const FMediaUploadResult&);
 
     /**
-     * Upload multiple media files sequentially with custom names (recommended)
+     * Per-file callbacks, the file is identified by the FilePath of its FBH_MediaFile
+     */
+    DECLARE_DELEGATE_ThreeParams(FOnFileStage, const FString& /* FilePath */, EBH_UploadStage, const FString& /* BlobSignedId */);
+    DECLARE_DELEGATE_TwoParams(FOnFileComplete, const FString& /* FilePath */, const BH_S3Uploader::FUploadResult&);
+
+    /**
+     * Set before UploadMediaFiles to follow the progress of each file, e.g. to resume it later
+     */
+    void SetFileCallbacks(const FOnFileStage& OnStage, const FOnFileComplete& OnComplete);
+
+    /**
+     * Files already uploaded to S3 (keyed by FilePath, with their blob) that only need confirming.
+     * Set before UploadMediaFiles.
+     */
+    void SetUploadedBlobs(const TMap<FString, FString>& InUploadedBlobs);
+
+    /**
+     * Uploads the files to S3 without attaching them to the issue, e.g. while the report is not submitted yet.
+     * Each file completes after its Uploaded stage and is confirmed by a later upload with SetUploadedBlobs.
+     * Set before UploadMediaFiles.
+     */
+    void SetHoldConfirmations(bool bInHoldConfirmations);
+
+    /**
+     * Upload multiple media files with custom names (recommended)
      *
      * @param BaseUrl               BetaHub API base URL
      * @param ProjectId             Project identifier
@@ -71,7 +99,7 @@ public:
     );
 
     /**
-     * Upload multiple media files sequentially (supports multiple files per type)
+     * Upload multiple media files (supports multiple files per type)
      *
      * @deprecated Use the overload accepting TArray<FBH_MediaFile> instead for custom file names
      *
@@ -118,7 +146,7 @@ public:
     );
 
     /**
-     * Cancel ongoing uploads
+     * Cancel ongoing uploads, in-flight requests are aborted and the completion callback is called right away
      */
     void CancelUploads();
 
@@ -130,37 +158,32 @@ public:
 
 private:
     /**
-     * Process next file in queue
-     */
-    void ProcessNextUpload();
-
-    /**
-     * Update progress and notify
+     * Queues the small files of the report as one archive, each of them completes with it
      */
-    void UpdateProgress(const FString& CurrentFile, float Percent);
+    void EnqueueBundle(
+        const FString& BaseUrl,
+        const FString& ProjectId,
+        const FString& IssueId,
+        const FString& ApiToken,
+        const TArray<int32>& TaskIndices
+    );
 
     /**
-     * Complete the upload process
+     * Record the result of one file and complete the upload when it was the last one
      */
-    void CompleteUpload();
+    void OnTaskComplete(int32 TaskIndex, const BH_S3Uploader::FUploadResult& Result);
 
     /**
-     * Create a temporary file from string contents (for log files)
-     * @param Contents      String content to write to file
-     * @param Extension     File extension (e.g., "log", "txt")
-     * @param Index         Numeric index for unique filename generation
-     * @param CustomName    Optional custom name to use for the filename
+     * Update progress and notify
      */
-    FString CreateTempFile(const FString& Contents, const FString& Extension, int32 Index = 0, const FString& CustomName = TEXT(""));
+    void UpdateProgress(int32 TaskIndex, int64 TaskBytesSent);
 
     /**
-     * Clean up temporary files
+     * Complete the upload process
      */
-    void CleanupTempFiles();
+    void CompleteUpload();
 
 private:
-    TSharedPtr<BH_S3Uploader> S3Uploader;
-
     // Upload queue management
     struct FUploadTask
     {
@@ -169,26 +192,36 @@ private:
         FString ContentType;
         FString Description;        // Human-readable description like "Screenshot 2 of 5"
         FString CustomName;         // Optional custom display name for BetaHub
-        bool bIsTempFile;
+        TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> Content;     // UTF-8 log content uploaded from memory, FilePath is only its name
+        int64 FileSize;
+        FString SourcePath;         // FilePath of the FBH_MediaFile, empty for content
     };
 
     TArray<FUploadTask> UploadQueue;
-    int32 CurrentUploadIndex;
+    int32 CompletedFiles;
 
-    // Upload state
-    FString CurrentBaseUrl;
-    FString CurrentProjectId;
-    FString CurrentIssueId;
-    FString CurrentApiToken;
+    // Scheduler group of this report's uploads
+    int32 GroupId;
+
+    // Byte progress
+    int64 TotalBytes;
+    int64 CompletedBytes;
+    TMap<int32, int64> InFlightBytes;
 
     // Results tracking
     FMediaUploadResult UploadResult;
-    TArray<FString> TempFilesToCleanup;
 
     // Callbacks
     FOnProgressUpdate ProgressCallback;
     FOnUploadComplete CompleteCallback;
+    FOnFileStage FileStageCallback;
+    FOnFileComplete FileCompleteCallback;
+
+    TMap<FString, FString> UploadedBlobs;
+
+    // Screenshots and logs are uploaded as one archive (bBundleSmallAttachments)
+    bool bBundleSmallFiles;
 
-    // Cancellation flag
-    bool bCancelRequested;
+    // Files are not confirmed, see SetHoldConfirmations
+    bool bHoldConfirmations;
 };
\ No newline at end of file
@@ -0,0 +1,796 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "BH_MockServer.h"
+
+#if BH_WITH_MOCK_SERVER
+
+#include "BH_BugReport.h"
+#include "BH_FeatureRequest.h"
+#include "BH_PluginSettings.h"
+#include "BH_StorageManager.h"
+#include "BH_UploadJournal.h"
+#include "BH_Log.h"
+#include "HttpServerModule.h"
+#include "IHttpRouter.h"
+#include "HttpPath.h"
+#include "HttpServerRequest.h"
+#include "HttpServerResponse.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "UObject/Package.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+namespace
+{
+    const uint32 DefaultMockPort = 8787;
+    const TCHAR* MockProjectId = TEXT("pr-mock");
+    const TCHAR* MockProjectToken = TEXT("tkn-mock");
+
+    FString ToJsonString(const TSharedRef<FJsonObject>& Object)
+    {
+        FString JsonString;
+        TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+        FJsonSerializer::Serialize(Object, Writer);
+        return JsonString;
+    }
+
+    // Form bodies do not parse and give an empty object, the mock needs fields of JSON calls only
+    TSharedPtr<FJsonObject> ParseJsonBody(const FHttpServerRequest& Request)
+    {
+        TSharedPtr<FJsonObject> Object;
+        if (Request.Body.Num() > 0)
+        {
+            FUTF8ToTCHAR Convert((const ANSICHAR*)Request.Body.GetData(), Request.Body.Num());
+            TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FString(Convert.Length(), Convert.Get()));
+            FJsonSerializer::Deserialize(Reader, Object);
+        }
+        return Object.IsValid() ? Object : MakeShared<FJsonObject>();
+    }
+
+    const TCHAR* VerbToString(EHttpServerRequestVerbs Verb)
+    {
+        switch (Verb)
+        {
+        case EHttpServerRequestVerbs::VERB_GET:     return TEXT("GET");
+        case EHttpServerRequestVerbs::VERB_POST:    return TEXT("POST");
+        case EHttpServerRequestVerbs::VERB_PUT:     return TEXT("PUT");
+        case EHttpServerRequestVerbs::VERB_PATCH:   return TEXT("PATCH");
+        case EHttpServerRequestVerbs::VERB_DELETE:  return TEXT("DELETE");
+        default:                                    return TEXT("OTHER");
+        }
+    }
+}
+
+BH_MockServer& BH_MockServer::Get()
+{
+    static BH_MockServer Instance;
+    return Instance;
+}
+
+BH_MockServer::BH_MockServer()
+    : Port(0)
+    , NextId(1)
+{
+}
+
+bool BH_MockServer::Start(uint32 InPort, const FConditions& InConditions)
+{
+    check(IsInGameThread());
+
+    Stop();
+
+    Router = FHttpServerModule::Get().GetHttpRouter(InPort, true);
+    if (!Router.IsValid())
+    {
+        UE_LOG(LogBetaHub, Error, TEXT("Mock server cannot listen on port %u"), InPort);
+        return false;
+    }
+
+    Port = InPort;
+    Conditions = InConditions;
+    ResetStats();
+
+    const EHttpServerRequestVerbs Verbs = EHttpServerRequestVerbs::VERB_GET | EHttpServerRequestVerbs::VERB_POST
+        | EHttpServerRequestVerbs::VERB_PUT | EHttpServerRequestVerbs::VERB_PATCH | EHttpServerRequestVerbs::VERB_DELETE;
+
+    for (bool bStorage : { false, true })
+    {
+        auto Handler = [this, bStorage](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+        {
+            return HandleRequest(Request, OnComplete, bStorage);
+        };
+
+        const FHttpPath Path(bStorage ? TEXT("/s3") : TEXT("/projects"));
+#if ENGINE_MINOR_VERSION >= 4
+        Routes.Add(Router->BindRoute(Path, Verbs, FHttpRequestHandler::CreateLambda(Handler)));
+#else
+        Routes.Add(Router->BindRoute(Path, Verbs, Handler));
+#endif
+    }
+
+    FHttpServerModule::Get().StartAllListeners();
+
+    UE_LOG(LogBetaHub, Display, TEXT("Mock server listening at %s (latency %.0f ms, bandwidth %d kbps, failures %.0f%%)"),
+        *GetBaseUrl(), Conditions.LatencySeconds * 1000.0f, Conditions.BandwidthKbps, Conditions.FailureRate * 100.0f);
+    return true;
+}
+
+void BH_MockServer::Stop()
+{
+    check(IsInGameThread());
+
+    if (!Router.IsValid())
+    {
+        return;
+    }
+
+    // Nothing sent here may outlive the server: the journal would retry it against a closed port on every launch
+    BH_UploadJournal::Get().DiscardReports(GetBaseUrl());
+    OpenIssues.Empty();
+
+    for (const FHttpRouteHandle& Route : Routes)
+    {
+        Router->UnbindRoute(Route);
+    }
+    Routes.Empty();
+    Router.Reset();
+    Port = 0;
+
+    UE_LOG(LogBetaHub, Display, TEXT("Mock server stopped"));
+}
+
+bool BH_MockServer::IsRunning() const
+{
+    return Router.IsValid();
+}
+
+FString BH_MockServer::GetBaseUrl() const
+{
+    return FString::Printf(TEXT("http://127.0.0.1:%u"), Port);
+}
+
+UBH_PluginSettings* BH_MockServer::CreateSettings() const
+{
+    // Initialized from the class default object, which holds the project's configuration
+    UBH_PluginSettings* Settings = NewObject<UBH_PluginSettings>(GetTransientPackage());
+    Settings->ApiEndpoint = GetBaseUrl();
+    Settings->ProjectId = MockProjectId;
+    Settings->ProjectToken = MockProjectToken;
+    return Settings;
+}
+
+void BH_MockServer::AddOpenIssue(const FString& Signature, const FString& IssueId)
+{
+    OpenIssues.Add(Signature, IssueId);
+}
+
+const BH_MockServer::FStats& BH_MockServer::GetStats() const
+{
+    return Stats;
+}
+
+void BH_MockServer::ResetStats()
+{
+    // Responses still waiting for their delay are counted until they are sent
+    const int32 PendingResponses = Stats.PendingResponses;
+    Stats = FStats();
+    Stats.PendingResponses = PendingResponses;
+}
+
+bool BH_MockServer::HandleRequest(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete, bool bStorage)
+{
+    Stats.Requests++;
+    Stats.BytesReceived += Request.Body.Num();
+
+    // Depending on the engine version the path is given with or without the route, the route is dropped
+    TArray<FString> Segments;
+    Request.RelativePath.GetPath().ParseIntoArray(Segments, TEXT("/"));
+    if (Segments.Num() > 0 && Segments[0] == (bStorage ? TEXT("s3") : TEXT("projects")))
+    {
+        Segments.RemoveAt(0);
+    }
+
+    if (bStorage)
+    {
+        Stats.Calls.Add(FString::Printf(TEXT("%s s3"), VerbToString(Request.Verb)));
+    }
+    else
+    {
+        // Without the project id
+        const FString Path = Segments.Num() > 1
+            ? FString::Join(TArray<FString>(Segments.GetData() + 1, Segments.Num() - 1), TEXT("/"))
+            : FString();
+        Stats.Calls.Add(FString::Printf(TEXT("%s %s"), VerbToString(Request.Verb), *Path));
+    }
+
+    int32 Code = 404;
+    FString Body;
+    if (Conditions.FailureRate > 0.0f && FMath::FRand() < Conditions.FailureRate)
+    {
+        Stats.FailedRequests++;
+        Code = 503;
+        Body = TEXT("{\"error\":\"Simulated failure\"}");
+    }
+    else if (bStorage)
+    {
+        // Anything put to a presigned URL is accepted, the content is only counted
+        if (Request.Verb == EHttpServerRequestVerbs::VERB_PUT)
+        {
+            Stats.BytesUploadedToS3 += Request.Body.Num();
+            Code = 200;
+        }
+    }
+    else if (Segments.Num() >= 2)
+    {
+        // Segments after the project id
+        Segments.RemoveAt(0);
+        Body = HandleApiCall(Request, Segments, Code);
+    }
+
+    // The response waits for the latency plus the time the body would take to arrive
+    float Delay = Conditions.LatencySeconds;
+    if (Conditions.BandwidthKbps > 0)
+    {
+        Delay += Request.Body.Num() * 8.0f / (Conditions.BandwidthKbps * 1000.0f);
+    }
+
+    const bool bIsStorageUpload = bStorage && Code == 200;
+    auto Respond = [OnComplete, Code, Body, bIsStorageUpload]()
+    {
+        TUniquePtr<FHttpServerResponse> Response = FHttpServerResponse::Create(Body.IsEmpty() ? TEXT("{}") : Body, TEXT("application/json"));
+        Response->Code = (EHttpServerResponseCodes)Code;
+        if (bIsStorageUpload)
+        {
+            Response->Headers.Add(TEXT("ETag"), TArray<FString>{ FString::Printf(TEXT("\"%s\""), *FGuid::NewGuid().ToString(EGuidFormats::Digits)) });
+        }
+        OnComplete(MoveTemp(Response));
+    };
+
+    if (Delay <= 0.0f)
+    {
+        Respond();
+        return true;
+    }
+
+    Stats.PendingResponses++;
+    FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this, Respond](float DeltaTime)
+    {
+        Stats.PendingResponses--;
+        Respond();
+        return false;
+    }), Delay);
+    return true;
+}
+
+FString BH_MockServer::HandleApiCall(const FHttpServerRequest& Request, const TArray<FString>& Segments, int32& OutCode)
+{
+    OutCode = 404;
+
+    // POST issues.json
+    if (Segments.Num() == 1 && Segments[0] == TEXT("issues.json"))
+    {
+        const int32 Id = NextId++;
+        OutCode = 201;
+        return FString::Printf(TEXT("{\"id\":\"%d\",\"token\":\"tkn-mock-issue-%d\"}"), Id, Id);
+    }
+
+    // POST feature_requests.json, the scoped id is read from the URL
+    if (Segments.Num() == 1 && Segments[0] == TEXT("feature_requests.json"))
+    {
+        const int32 Id = NextId++;
+        OutCode = 201;
+        return FString::Printf(TEXT("{\"id\":\"%d\",\"url\":\"%s/projects/%s/feature_requests/%d\",\"token\":\"tkn-mock-fr-%d\"}"),
+            Id, *GetBaseUrl(), MockProjectId, Id, Id);
+    }
+
+    // POST feature_requests/{id}/publish
+    if (Segments.Num() == 3 && Segments[0] == TEXT("feature_requests") && Segments[2] == TEXT("publish"))
+    {
+        Stats.IssuesPublished++;
+        OutCode = 200;
+        return FString();
+    }
+
+    // GET releases.json, a project without releases
+    if (Segments.Num() == 1 && Segments[0] == TEXT("releases.json"))
+    {
+        OutCode = 200;
+        return TEXT("[]");
+    }
+
+    if (Segments.Num() < 2 || Segments[0] != TEXT("issues"))
+    {
+        return FString();
+    }
+
+    // POST issues/find_by_signature.json, an issue added with AddOpenIssue
+    if (Segments.Num() == 2 && Segments[1] == TEXT("find_by_signature.json"))
+    {
+        FString Signature;
+        ParseJsonBody(Request)->TryGetStringField(TEXT("signature"), Signature);
+        const FString* IssueId = OpenIssues.Find(Signature);
+        if (!IssueId)
+        {
+            return TEXT("{\"error\":\"No open issue with this signature\"}");
+        }
+
+        OutCode = 200;
+        return FString::Printf(TEXT("{\"issue\":{\"id\":\"%s\",\"title\":\"Mock issue %s\"}}"), **IssueId, **IssueId);
+    }
+
+    // PATCH or DELETE issues/{id}
+    if (Segments.Num() == 2)
+    {
+        if (Request.Verb == EHttpServerRequestVerbs::VERB_PATCH || Request.Verb == EHttpServerRequestVerbs::VERB_DELETE)
+        {
+            OutCode = 200;
+        }
+        return FString();
+    }
+
+    const FString& Action = Segments.Last();
+
+    if (Segments.Num() == 3 && Action == TEXT("publish"))
+    {
+        Stats.IssuesPublished++;
+        OutCode = 200;
+        return FString();
+    }
+
+    if (Segments.Num() == 4 && Action == TEXT("presigned_upload"))
+    {
+        OutCode = 200;
+        return ToJsonString(CreateUploadTarget(ParseJsonBody(Request)));
+    }
+
+    if (Segments.Num() == 4 && Action == TEXT("confirm_upload"))
+    {
+        OutCode = 200;
+        return FString();
+    }
+
+    if (Segments.Num() == 4 && Action == TEXT("presigned_multipart_upload"))
+    {
+        OutCode = 200;
+        return ToJsonString(CreateMultipartTarget(ParseJsonBody(Request)));
+    }
+
+    // POST {media}/complete_multipart_upload, rejected unless every part came back with its ETag
+    if (Segments.Num() == 4 && Action == TEXT("complete_multipart_upload"))
+    {
+        const TArray<TSharedPtr<FJsonValue>>* Parts = nullptr;
+        if (!ParseJsonBody(Request)->TryGetArrayField(TEXT("parts"), Parts) || Parts->Num() == 0)
+        {
+            OutCode = 422;
+            return TEXT("{\"error\":\"Missing parts\"}");
+        }
+
+        for (const TSharedPtr<FJsonValue>& Part : *Parts)
+        {
+            FString ETag;
+            if (!Part.IsValid() || !Part->AsObject().IsValid() || !Part->AsObject()->TryGetStringField(TEXT("etag"), ETag) || ETag.IsEmpty())
+            {
+                OutCode = 422;
+                return TEXT("{\"error\":\"Missing part ETag\"}");
+            }
+        }
+
+        OutCode = 200;
+        return FString();
+    }
+
+    // POST issues/g-{id}/occurrences.json, a duplicate report added to an open issue
+    if (Segments.Num() == 3 && Action == TEXT("occurrences.json"))
+    {
+        OutCode = 201;
+        return FString();
+    }
+
+    // Batched calls answer each upload in order
+    if (Segments.Num() == 3 && (Action == TEXT("presigned_uploads") || Action == TEXT("confirm_uploads")))
+    {
+        const TArray<TSharedPtr<FJsonValue>>* Uploads = nullptr;
+        if (!ParseJsonBody(Request)->TryGetArrayField(TEXT("uploads"), Uploads))
+        {
+            OutCode = 422;
+            return TEXT("{\"error\":\"Missing uploads\"}");
+        }
+
+        TArray<TSharedPtr<FJsonValue>> Results;
+        for (const TSharedPtr<FJsonValue>& Upload : *Uploads)
+        {
+            TSharedRef<FJsonObject> Result = Action == TEXT("presigned_uploads")
+                ? CreateUploadTarget(Upload.IsValid() ? Upload->AsObject() : nullptr)
+                : MakeShared<FJsonObject>();
+            Results.Add(MakeShared<FJsonValueObject>(Result));
+        }
+
+        TSharedRef<FJsonObject> Response = MakeShared<FJsonObject>();
+        Response->SetArrayField(TEXT("uploads"), Results);
+        OutCode = 200;
+        return ToJsonString(Response);
+    }
+
+    return FString();
+}
+
+TSharedRef<FJsonObject> BH_MockServer::CreateUploadTarget(const TSharedPtr<FJsonObject>& Upload)
+{
+    FString ContentType = TEXT("application/octet-stream");
+    if (Upload.IsValid())
+    {
+        Upload->TryGetStringField(TEXT("content_type"), ContentType);
+    }
+
+    const int32 Id = NextId++;
+
+    TSharedRef<FJsonObject> Headers = MakeShared<FJsonObject>();
+    Headers->SetStringField(TEXT("Content-Type"), ContentType);
+
+    TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("blob_signed_id"), FString::Printf(TEXT("mock-blob-%d"), Id));
+    Result->SetStringField(TEXT("direct_upload_url"), FString::Printf(TEXT("%s/s3/blob-%d"), *GetBaseUrl(), Id));
+    Result->SetObjectField(TEXT("headers"), Headers);
+    return Result;
+}
+
+TSharedRef<FJsonObject> BH_MockServer::CreateMultipartTarget(const TSharedPtr<FJsonObject>& Upload)
+{
+    // A resumed upload keeps its id and only asks for the parts it is missing
+    FString UploadId;
+    TArray<int32> PartNumbers;
+    const TArray<TSharedPtr<FJsonValue>>* RequestedParts = nullptr;
+    if (Upload->TryGetStringField(TEXT("upload_id"), UploadId) && Upload->TryGetArrayField(TEXT("part_numbers"), RequestedParts))
+    {
+        for (const TSharedPtr<FJsonValue>& PartNumber : *RequestedParts)
+        {
+            PartNumbers.Add((int32)PartNumber->AsNumber());
+        }
+    }
+    else
+    {
+        int32 PartCount = 0;
+        Upload->TryGetNumberField(TEXT("part_count"), PartCount);
+        for (int32 PartNumber = 1; PartNumber <= PartCount; ++PartNumber)
+        {
+            PartNumbers.Add(PartNumber);
+        }
+    }
+
+    const int32 Id = NextId++;
+    if (UploadId.IsEmpty())
+    {
+        UploadId = FString::Printf(TEXT("mock-upload-%d"), Id);
+    }
+
+    TArray<TSharedPtr<FJsonValue>> Parts;
+    for (int32 PartNumber : PartNumbers)
+    {
+        TSharedRef<FJsonObject> Part = MakeShared<FJsonObject>();
+        Part->SetNumberField(TEXT("part_number"), PartNumber);
+        Part->SetStringField(TEXT("url"), FString::Printf(TEXT("%s/s3/%s/part-%d"), *GetBaseUrl(), *UploadId, PartNumber));
+        Parts.Add(MakeShared<FJsonValueObject>(Part));
+    }
+
+    TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField(TEXT("upload_id"), UploadId);
+    Result->SetStringField(TEXT("blob_signed_id"), FString::Printf(TEXT("mock-blob-%d"), Id));
+    Result->SetObjectField(TEXT("headers"), MakeShared<FJsonObject>());
+    Result->SetArrayField(TEXT("parts"), Parts);
+    return Result;
+}
+
+namespace
+{
+    struct FBenchmarkShape
+    {
+        const TCHAR* Name;
+        int64 ScreenshotBytes;
+        int64 LogBytes;
+        int64 VideoBytes;
+        bool bSuggestion;
+    };
+
+    const FBenchmarkShape BenchmarkShapes[] =
+    {
+        { TEXT("text"),       0,          0,               0,                false },
+        { TEXT("screenshot"), 512 * 1024, 0,               0,                false },
+        { TEXT("logs"),       0,          2 * 1024 * 1024, 0,                false },
+        { TEXT("full"),       512 * 1024, 2 * 1024 * 1024, 16 * 1024 * 1024, false },
+        { TEXT("suggestion"), 512 * 1024, 0,               0,                true },
+    };
+
+    // Uploads after publishing (videos) are done once the server saw no request for this long
+    const double SettleSeconds = 1.0;
+
+    /**
+     * Submits reports of each shape to the mock server one after another and logs what each one cost
+     */
+    class FBH_SubmissionBenchmark : public TSharedFromThis<FBH_SubmissionBenchmark>
+    {
+    public:
+        FBH_SubmissionBenchmark(TArray<FBenchmarkShape>&& InShapes)
+            : Shapes(MoveTemp(InShapes))
+            , ShapeIndex(INDEX_NONE)
+            , StartTime(0.0)
+            , PublishTime(0.0)
+            , LastRequestTime(0.0)
+            , LastRequests(0)
+            , BaselineMemory(0)
+            , PeakMemory(0)
+            , Settings(nullptr)
+            , BugReport(nullptr)
+            , FeatureRequest(nullptr)
+        {
+        }
+
+        bool IsRunning() const
+        {
+            return ShapeIndex < Shapes.Num();
+        }
+
+        void Run()
+        {
+            // Reports go to the mock server through a copy of the settings, the project's are left alone
+            Settings = BH_MockServer::Get().CreateSettings();
+            Settings->AddToRoot();
+
+            BugReport = NewObject<UBH_BugReport>();
+            BugReport->AddToRoot();
+            FeatureRequest = NewObject<UBH_FeatureRequest>();
+            FeatureRequest->AddToRoot();
+
+            TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FBH_SubmissionBenchmark::Tick));
+            NextShape();
+        }
+
+    private:
+        void NextShape()
+        {
+            DeleteFiles();
+
+            if (++ShapeIndex >= Shapes.Num())
+            {
+                Finish();
+                return;
+            }
+
+            const FBenchmarkShape& Shape = Shapes[ShapeIndex];
+
+            // Random content per run, so uploads cached by earlier runs are not reused
+            TArray<FBH_MediaFile> Screenshots;
+            TArray<FBH_MediaFile> Logs;
+            TArray<FBH_MediaFile> Videos;
+            if (Shape.ScreenshotBytes > 0)
+            {
+                Screenshots.Add(FBH_MediaFile(WriteRandomFile(TEXT("png"), Shape.ScreenshotBytes), TEXT("Screenshot")));
+            }
+            if (Shape.VideoBytes > 0)
+            {
+                Videos.Add(FBH_MediaFile(WriteRandomFile(TEXT("mp4"), Shape.VideoBytes), TEXT("Gameplay")));
+            }
+            if (Shape.LogBytes > 0)
+            {
+                FBH_MediaFile Log;
+                Log.Content = MakeLogContent(Shape.LogBytes);
+                Log.Name = TEXT("Game.log");
+                Logs.Add(Log);
+            }
+
+            BH_MockServer::Get().ResetStats();
+            BaselineMemory = PeakMemory = FPlatformMemory::GetStats().UsedPhysical;
+            LastRequests = 0;
+            PublishTime = 0.0;
+            StartTime = LastRequestTime = FPlatformTime::Seconds();
+
+            TWeakPtr<FBH_SubmissionBenchmark> WeakThis = AsShared();
+            auto OnSuccess = [WeakThis]()
+            {
+                if (TSharedPtr<FBH_SubmissionBenchmark> This = WeakThis.Pin())
+                {
+                    This->PublishTime = FPlatformTime::Seconds();
+                }
+            };
+            auto OnFailure = [WeakThis](const FString& Error)
+            {
+                if (TSharedPtr<FBH_SubmissionBenchmark> This = WeakThis.Pin())
+                {
+                    UE_LOG(LogBetaHub, Warning, TEXT("Benchmark %s failed: %s"), This->Shapes[This->ShapeIndex].Name, *Error);
+                    This->NextShape();
+                }
+            };
+
+            const FString Description = FString::Printf(TEXT("Submission benchmark: %s"), Shape.Name);
+            if (Shape.bSuggestion)
+            {
+                const FString ScreenshotPath = Screenshots.Num() > 0 ? Screenshots[0].FilePath : FString();
+                FeatureRequest->SubmitFeatureRequest(Settings, Description, ScreenshotPath, !ScreenshotPath.IsEmpty(), OnSuccess, OnFailure);
+            }
+            else
+            {
+                BugReport->SubmitReportWithMedia(Settings, nullptr, Description, TEXT("Run BetaHub.BenchmarkSubmission"),
+                    Videos, Screenshots, Logs, OnSuccess, OnFailure);
+            }
+        }
+
+        bool Tick(float DeltaTime)
+        {
+            if (ShapeIndex == INDEX_NONE || ShapeIndex >= Shapes.Num())
+            {
+                return true;
+            }
+
+            PeakMemory = FMath::Max(PeakMemory, (uint64)FPlatformMemory::GetStats().UsedPhysical);
+
+            const BH_MockServer::FStats& Stats = BH_MockServer::Get().GetStats();
+            const double Now = FPlatformTime::Seconds();
+            if (Stats.Requests != LastRequests || Stats.PendingResponses > 0)
+            {
+                LastRequests = Stats.Requests;
+                LastRequestTime = Now;
+            }
+
+            if (PublishTime > 0.0 && Now - LastRequestTime >= SettleSeconds)
+            {
+                UE_LOG(LogBetaHub, Display, TEXT("%-10s published %7.1f ms, settled %7.1f ms, %3d requests (%d failed), %8.1f KB sent, %8.1f KB to S3, peak RAM +%.1f MB"),
+                    Shapes[ShapeIndex].Name,
+                    (PublishTime - StartTime) * 1000.0,
+                    (LastRequestTime - StartTime) * 1000.0,
+                    Stats.Requests, Stats.FailedRequests,
+                    Stats.BytesReceived / 1024.0,
+                    Stats.BytesUploadedToS3 / 1024.0,
+                    (double)(PeakMemory - BaselineMemory) / (1024.0 * 1024.0));
+                NextShape();
+            }
+            return true;
+        }
+
+        void Finish()
+        {
+            FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+
+            // Reports that failed against the mock server must not be retried on the next launch
+            if (BH_MockServer::Get().IsRunning())
+            {
+                BH_UploadJournal::Get().DiscardReports(BH_MockServer::Get().GetBaseUrl());
+            }
+
+            Settings->RemoveFromRoot();
+            BugReport->RemoveFromRoot();
+            FeatureRequest->RemoveFromRoot();
+
+            UE_LOG(LogBetaHub, Display, TEXT("Submission benchmark finished"));
+        }
+
+        FString WriteRandomFile(const TCHAR* Extension, int64 Size)
+        {
+            TArray<uint8> Data;
+            Data.SetNumUninitialized(Size);
+            for (int64 Index = 0; Index < Size; ++Index)
+            {
+                Data[Index] = (uint8)FMath::Rand();
+            }
+
+            const FString Path = BH_StorageManager::GetTempDir() / FString::Printf(TEXT("benchmark_%s.%s"),
+                *FGuid::NewGuid().ToString(EGuidFormats::Digits), Extension);
+            FFileHelper::SaveArrayToFile(Data, *Path);
+            Files.Add(Path);
+            return Path;
+        }
+
+        static FString MakeLogContent(int64 Size)
+        {
+            // Repetitive like a real log, so it compresses like one
+            FString Content = FString::Printf(TEXT("Benchmark run %s\n"), *FGuid::NewGuid().ToString());
+            int32 Line = 0;
+            while (Content.Len() < Size)
+            {
+                Content += FString::Printf(TEXT("[2026.01.01-00.00.00:%03d][%3d]LogTemp: Display: Benchmark line %d, value %d\n"),
+                    Line % 1000, Line % 100, Line, FMath::Rand());
+                ++Line;
+            }
+            return Content;
+        }
+
+        void DeleteFiles()
+        {
+            for (const FString& Path : Files)
+            {
+                IFileManager::Get().Delete(*Path, false, false, true);
+            }
+            Files.Empty();
+        }
+
+        TArray<FBenchmarkShape> Shapes;
+        int32 ShapeIndex;
+
+        double StartTime;
+        double PublishTime;
+        double LastRequestTime;
+        int32 LastRequests;
+        uint64 BaselineMemory;
+        uint64 PeakMemory;
+
+        UBH_PluginSettings* Settings;
+        UBH_BugReport* BugReport;
+        UBH_FeatureRequest* FeatureRequest;
+        TArray<FString> Files;
+        FTSTicker::FDelegateHandle TickHandle;
+    };
+
+    TSharedPtr<FBH_SubmissionBenchmark> RunningBenchmark;
+}
+
+// BetaHub.MockServer.Start [Port] [LatencyMs] [BandwidthKbps] [FailurePercent]
+static FAutoConsoleCommand StartMockServerCommand(
+    TEXT("BetaHub.MockServer.Start"),
+    TEXT("Starts a local stand-in for the BetaHub API and S3. Optional arguments: port (default 8787), latency in ms (default 50), bandwidth in kbps (default unlimited), failure percentage (default 0)."),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        BH_MockServer::FConditions Conditions;
+        const uint32 Port = Args.Num() > 0 ? (uint32)FCString::Atoi(*Args[0]) : DefaultMockPort;
+        if (Args.Num() > 1)
+        {
+            Conditions.LatencySeconds = FMath::Max(FCString::Atof(*Args[1]), 0.0f) / 1000.0f;
+        }
+        if (Args.Num() > 2)
+        {
+            Conditions.BandwidthKbps = FMath::Max(FCString::Atoi(*Args[2]), 0);
+        }
+        if (Args.Num() > 3)
+        {
+            Conditions.FailureRate = FMath::Clamp(FCString::Atof(*Args[3]), 0.0f, 100.0f) / 100.0f;
+        }
+        BH_MockServer::Get().Start(Port, Conditions);
+    }));
+
+static FAutoConsoleCommand StopMockServerCommand(
+    TEXT("BetaHub.MockServer.Stop"),
+    TEXT("Stops the local stand-in for the BetaHub API and S3."),
+    FConsoleCommandDelegate::CreateLambda([]()
+    {
+        BH_MockServer::Get().Stop();
+    }));
+
+// BetaHub.BenchmarkSubmission [text|screenshot|logs|full|suggestion|all]
+static FAutoConsoleCommand BenchmarkSubmissionCommand(
+    TEXT("BetaHub.BenchmarkSubmission"),
+    TEXT("Submits reports to the mock server (started with default conditions if not running) and logs time to publish, requests, bytes sent and peak memory. Optional argument: text, screenshot, logs, full, suggestion or all (default)."),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        if (RunningBenchmark.IsValid() && RunningBenchmark->IsRunning())
+        {
+            UE_LOG(LogBetaHub, Warning, TEXT("A submission benchmark is already running"));
+            return;
+        }
+
+        const FString ShapeName = Args.Num() > 0 ? Args[0] : TEXT("all");
+        TArray<FBenchmarkShape> Shapes;
+        for (const FBenchmarkShape& Shape : BenchmarkShapes)
+        {
+            if (ShapeName == TEXT("all") || ShapeName == Shape.Name)
+            {
+                Shapes.Add(Shape);
+            }
+        }
+        if (Shapes.Num() == 0)
+        {
+            UE_LOG(LogBetaHub, Error, TEXT("Unknown benchmark shape %s"), *ShapeName);
+            return;
+        }
+
+        if (!BH_MockServer::Get().IsRunning() && !BH_MockServer::Get().Start(DefaultMockPort, BH_MockServer::FConditions()))
+        {
+            return;
+        }
+
+        RunningBenchmark = MakeShared<FBH_SubmissionBenchmark>(MoveTemp(Shapes));
+        RunningBenchmark->Run();
+    }));
+
+#endif
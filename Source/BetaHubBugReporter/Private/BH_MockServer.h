@@ -0,0 +1,119 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if BH_WITH_MOCK_SERVER
+
+#include "HttpRouteHandle.h"
+#include "HttpResultCallback.h"
+
+class IHttpRouter;
+class FJsonObject;
+class UBH_PluginSettings;
+struct FHttpServerRequest;
+
+/**
+ * Local stand-in for the BetaHub API and S3, so the submission path can be measured without the live service.
+ * Serves the endpoints the plugin uses (draft issues, presigned, batched and multipart uploads, the S3 PUT targets,
+ * confirmation, publishing, signature lookups and occurrences, suggestions and releases) on 127.0.0.1, with
+ * simulated latency, bandwidth and failures.
+ *
+ * Development builds only, game thread only. Started with BetaHub.MockServer.Start, used by BetaHub.BenchmarkSubmission
+ * and the BetaHub.Submission automation tests.
+ */
+class BH_MockServer
+{
+public:
+    struct FConditions
+    {
+        float LatencySeconds = 0.05f;       // Added to every response
+        int32 BandwidthKbps = 0;            // Request bodies take this long to "arrive", 0 is unlimited
+        float FailureRate = 0.0f;           // Share of requests answered with 503, 0-1
+    };
+
+    struct FStats
+    {
+        int32 Requests = 0;
+        int32 FailedRequests = 0;
+        int64 BytesReceived = 0;
+        int64 BytesUploadedToS3 = 0;
+        int32 IssuesPublished = 0;
+        int32 PendingResponses = 0;         // Requests answered after a simulated delay
+
+        // Each request in the order received, "POST issues/1/publish" for the API and "PUT s3" for storage
+        TArray<FString> Calls;
+    };
+
+    static BH_MockServer& Get();
+
+    /**
+     * @return              False if the port cannot be bound
+     */
+    bool Start(uint32 Port, const FConditions& InConditions);
+
+    /**
+     * Also discards the reports sent to the server, so they are not resumed against it on the next launch
+     */
+    void Stop();
+
+    bool IsRunning() const;
+
+    /**
+     * API base URL to use as the plugin's ApiEndpoint while the server runs
+     */
+    FString GetBaseUrl() const;
+
+    /**
+     * A copy of the project's plugin settings that sends reports to the server. The project's settings are not
+     * changed, reports submitted meanwhile by the game still go to BetaHub. The caller keeps the copy alive.
+     */
+    UBH_PluginSettings* CreateSettings() const;
+
+    /**
+     * An open issue returned when a report with this signature is looked up, until the server stops
+     */
+    void AddOpenIssue(const FString& Signature, const FString& IssueId);
+
+    const FStats& GetStats() const;
+    void ResetStats();
+
+private:
+    BH_MockServer();
+
+    /**
+     * @param bStorage      Whether the request came to the S3 stand-in rather than the API
+     */
+    bool HandleRequest(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete, bool bStorage);
+
+    /**
+     * Builds the response of an API call
+     *
+     * @param Segments      Path segments after /projects/{ProjectId}
+     * @param OutCode       HTTP status code
+     * @return              JSON body
+     */
+    FString HandleApiCall(const FHttpServerRequest& Request, const TArray<FString>& Segments, int32& OutCode);
+
+    /**
+     * Presigned upload response for one file: a new blob and its S3 stand-in URL
+     */
+    TSharedRef<FJsonObject> CreateUploadTarget(const TSharedPtr<FJsonObject>& Upload);
+
+    /**
+     * Multipart presign response: a new upload and a storage URL for each requested part
+     */
+    TSharedRef<FJsonObject> CreateMultipartTarget(const TSharedPtr<FJsonObject>& Upload);
+
+    TSharedPtr<IHttpRouter> Router;
+    TArray<FHttpRouteHandle> Routes;
+    uint32 Port;
+    FConditions Conditions;
+    FStats Stats;
+    int32 NextId;
+
+    // Issue ids by signature, see AddOpenIssue
+    TMap<FString, FString> OpenIssues;
+};
+
+#endif
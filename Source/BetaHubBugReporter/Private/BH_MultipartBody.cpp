@@ -0,0 +1,168 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "BH_MultipartBody.h"
+#include "BH_FileRangeArchive.h"
+#include "HAL/FileManager.h"
+
+FBH_MultipartBody::FBH_MultipartBody()
+    : Size(0)
+    , Position(0)
+    , OpenSegment(INDEX_NONE)
+{
+    SetIsLoading(true);
+    SetIsPersistent(true);
+}
+
+FBH_MultipartBody::~FBH_MultipartBody()
+{
+    Close();
+}
+
+void FBH_MultipartBody::AppendText(const FString& Text)
+{
+    FTCHARToUTF8 Convert(*Text, Text.Len());
+    AppendBytes((const uint8*)Convert.Get(), Convert.Length());
+}
+
+void FBH_MultipartBody::AppendText(const ANSICHAR* Text)
+{
+    AppendBytes((const uint8*)Text, FCStringAnsi::Strlen(Text));
+}
+
+bool FBH_MultipartBody::AppendFile(const FString& FilePath)
+{
+    const int64 FileSize = IFileManager::Get().FileSize(*FilePath);
+    if (FileSize < 0)
+    {
+        return false;
+    }
+
+    if (FileSize > 0)
+    {
+        FSegment& Segment = Segments.AddDefaulted_GetRef();
+        Segment.Offset = Size;
+        Segment.Size = FileSize;
+        Segment.FilePath = FilePath;
+        Size += FileSize;
+    }
+    return true;
+}
+
+void FBH_MultipartBody::AppendBytes(const uint8* Data, int64 Length)
+{
+    if (Length <= 0)
+    {
+        return;
+    }
+
+    // Consecutive text goes into one segment
+    if (Segments.Num() == 0 || !Segments.Last().FilePath.IsEmpty())
+    {
+        FSegment& Segment = Segments.AddDefaulted_GetRef();
+        Segment.Offset = Size;
+        Segment.Size = 0;
+    }
+
+    FSegment& Segment = Segments.Last();
+    Segment.Bytes.Append(Data, (int32)Length);
+    Segment.Size += Length;
+    Size += Length;
+}
+
+int32 FBH_MultipartBody::FindSegment(int64 Pos) const
+{
+    // Bodies have a handful of segments and are read front to back
+    for (int32 Index = 0; Index < Segments.Num(); ++Index)
+    {
+        if (Pos < Segments[Index].Offset + Segments[Index].Size)
+        {
+            return Index;
+        }
+    }
+    return INDEX_NONE;
+}
+
+void FBH_MultipartBody::Serialize(void* Data, int64 Length)
+{
+    if (Length < 0 || Position + Length > Size)
+    {
+        SetError();
+        return;
+    }
+
+    uint8* Out = (uint8*)Data;
+    while (Length > 0)
+    {
+        const int32 Index = FindSegment(Position);
+        check(Index != INDEX_NONE);
+
+        const FSegment& Segment = Segments[Index];
+        const int64 SegmentPos = Position - Segment.Offset;
+        const int64 Count = FMath::Min(Length, Segment.Size - SegmentPos);
+
+        if (Segment.FilePath.IsEmpty())
+        {
+            FMemory::Memcpy(Out, Segment.Bytes.GetData() + SegmentPos, Count);
+        }
+        else
+        {
+            // Read as the request is sent, the request is paced by the bandwidth limiter before it starts
+            if (OpenSegment != Index)
+            {
+                OpenFile = MakeUnique<FBH_FileRangeArchive>(Segment.FilePath, 0, Segment.Size);
+                OpenSegment = Index;
+            }
+
+            if (OpenFile->IsValid() && OpenFile->Tell() != SegmentPos)
+            {
+                OpenFile->Seek(SegmentPos);
+            }
+            if (OpenFile->IsValid())
+            {
+                OpenFile->Serialize(Out, Count);
+            }
+
+            // The file was removed or truncated since it was added
+            if (!OpenFile->IsValid() || OpenFile->IsError())
+            {
+                SetError();
+                return;
+            }
+        }
+
+        Out += Count;
+        Position += Count;
+        Length -= Count;
+    }
+}
+
+void FBH_MultipartBody::Seek(int64 InPos)
+{
+    if (InPos < 0 || InPos > Size)
+    {
+        SetError();
+        return;
+    }
+    Position = InPos;
+}
+
+int64 FBH_MultipartBody::Tell()
+{
+    return Position;
+}
+
+int64 FBH_MultipartBody::TotalSize()
+{
+    return Size;
+}
+
+bool FBH_MultipartBody::Close()
+{
+    OpenFile.Reset();
+    OpenSegment = INDEX_NONE;
+    return !IsError();
+}
+
+FString FBH_MultipartBody::GetArchiveName() const
+{
+    return FString::Printf(TEXT("Multipart body (%d segments, %lld bytes)"), Segments.Num(), Size);
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+
+class FBH_FileRangeArchive;
+
+/**
+ * Read-only archive over a multipart/form-data body, used as a streamed HTTP request body.
+ * The body is a list of segments: text written by the request (boundaries, part headers, field values)
+ * is kept in memory, attached files are referenced by path and read from disk while the body is sent.
+ * The full size is known before sending, so the request gets an exact Content-Length.
+ *
+ * Built on the game thread, read by the HTTP thread once it is set as the request content.
+ */
+class FBH_MultipartBody : public FArchive
+{
+public:
+    FBH_MultipartBody();
+    virtual ~FBH_MultipartBody();
+
+    /**
+     * Appends text encoded as UTF-8
+     */
+    void AppendText(const FString& Text);
+    void AppendText(const ANSICHAR* Text);
+
+    /**
+     * Appends the content of a file without reading it
+     *
+     * @return              False if the file does not exist
+     */
+    bool AppendFile(const FString& FilePath);
+
+    virtual void Serialize(void* Data, int64 Length) override;
+    virtual void Seek(int64 InPos) override;
+    virtual int64 Tell() override;
+    virtual int64 TotalSize() override;
+    virtual bool Close() override;
+    virtual FString GetArchiveName() const override;
+
+private:
+    struct FSegment
+    {
+        int64 Offset;
+        int64 Size;
+
+        // In-memory segments hold their bytes, file segments their path
+        TArray<uint8> Bytes;
+        FString FilePath;
+    };
+
+    void AppendBytes(const uint8* Data, int64 Length);
+
+    /**
+     * Index of the segment containing Pos, which must be inside the body
+     */
+    int32 FindSegment(int64 Pos) const;
+
+    TArray<FSegment> Segments;
+    int64 Size;
+    int64 Position;
+
+    // The file being read, kept open until the body moves to another file
+    TUniquePtr<FBH_FileRangeArchive> OpenFile;
+    int32 OpenSegment;
+};
@@ -0,0 +1,646 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "BH_MultipartUpload.h"
+#include "BH_FileRangeArchive.h"
+#include "BH_BandwidthLimiter.h"
+#include "BH_StorageManager.h"
+#include "BH_Log.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "HAL/FileManager.h"
+#include "Containers/Ticker.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+// S3 does not accept more parts per upload
+static const int32 MaxMultipartParts = 10000;
+
+BH_MultipartUpload::BH_MultipartUpload(
+    const FString& InEndpointBase,
+    const FString& InApiToken,
+    const FString& InFilePath,
+    const TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>& InData,
+    int64 InFileSize,
+    const FString& InChecksum,
+    const FString& InChecksumAlgorithm,
+    const FString& InContentType,
+    const FString& InContentEncoding,
+    const FSettings& InSettings)
+    : EndpointBase(InEndpointBase)
+    , ApiToken(InApiToken)
+    , FilePath(InFilePath)
+    , Data(InData)
+    , FileSize(InFileSize)
+    , Checksum(InChecksum)
+    , ChecksumAlgorithm(InChecksumAlgorithm)
+    , ContentType(InContentType)
+    , ContentEncoding(InContentEncoding)
+    , Settings(InSettings)
+    , RunningParts(0)
+    , bFinished(false)
+{
+    Settings.PartSize = FMath::Max(Settings.PartSize, FMath::DivideAndRoundUp(FileSize, (int64)MaxMultipartParts));
+    Settings.MaxConcurrentParts = FMath::Max(Settings.MaxConcurrentParts, 1);
+    Settings.MaxPartAttempts = FMath::Max(Settings.MaxPartAttempts, 1);
+}
+
+void BH_MultipartUpload::Start(const FTrackRequest& InTrackRequest, const FOnProgress& InOnProgress, const FOnComplete& InOnComplete)
+{
+    TrackRequest = InTrackRequest;
+    OnProgress = InOnProgress;
+    OnComplete = InOnComplete;
+
+    InitializeParts();
+    LoadJournal();
+
+    const int32 DoneParts = Parts.FilterByPredicate([](const FPart& Part) { return !Part.ETag.IsEmpty(); }).Num();
+
+    UE_LOG(LogBetaHub, Log, TEXT("Multipart upload of %s: %d parts of %lld bytes, %d already uploaded"),
+        *FPaths::GetCleanFilename(FilePath), Parts.Num(), Settings.PartSize, DoneParts);
+
+    if (DoneParts == Parts.Num())
+    {
+        // Interrupted after the last part, only the completion is missing
+        CompleteMultipartUpload();
+        return;
+    }
+
+    ReportProgress();
+    RequestPresignedParts();
+}
+
+void BH_MultipartUpload::InitializeParts()
+{
+    Parts.Reset();
+
+    for (int64 Offset = 0; Offset < FileSize; Offset += Settings.PartSize)
+    {
+        FPart& Part = Parts.AddDefaulted_GetRef();
+        Part.PartNumber = Parts.Num();
+        Part.Offset = Offset;
+        Part.Size = FMath::Min(Settings.PartSize, FileSize - Offset);
+        Part.Attempts = 0;
+        Part.BytesSent = 0;
+        Part.bInFlight = false;
+    }
+}
+
+void BH_MultipartUpload::RequestPresignedParts()
+{
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    Request->SetURL(EndpointBase / TEXT("presigned_multipart_upload"));
+    Request->SetVerb(TEXT("POST"));
+    Request->SetHeader(TEXT("Accept"), TEXT("application/json"));
+    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+    Request->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *ApiToken));
+
+    TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
+    JsonObject->SetStringField(TEXT("filename"), FPaths::GetCleanFilename(FilePath));
+    JsonObject->SetNumberField(TEXT("byte_size"), FileSize);
+    JsonObject->SetStringField(TEXT("checksum"), Checksum);
+    if (!ChecksumAlgorithm.IsEmpty())
+    {
+        JsonObject->SetStringField(TEXT("checksum_algorithm"), ChecksumAlgorithm);
+    }
+    JsonObject->SetStringField(TEXT("content_type"), ContentType);
+    if (!ContentEncoding.IsEmpty())
+    {
+        // Set when the multipart upload is created, parts carry no headers of their own
+        JsonObject->SetStringField(TEXT("content_encoding"), ContentEncoding);
+    }
+    JsonObject->SetNumberField(TEXT("part_size"), Settings.PartSize);
+    JsonObject->SetNumberField(TEXT("part_count"), Parts.Num());
+
+    const bool bResuming = !UploadId.IsEmpty();
+    if (bResuming)
+    {
+        // Only the parts without an ETag need a URL
+        TArray<TSharedPtr<FJsonValue>> PartNumbers;
+        for (const FPart& Part : Parts)
+        {
+            if (Part.ETag.IsEmpty())
+            {
+                PartNumbers.Add(MakeShareable(new FJsonValueNumber(Part.PartNumber)));
+            }
+        }
+
+        JsonObject->SetStringField(TEXT("upload_id"), UploadId);
+        JsonObject->SetArrayField(TEXT("part_numbers"), PartNumbers);
+    }
+
+    FString JsonString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+    FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
+    Request->SetContentAsString(JsonString);
+
+    TSharedRef<BH_MultipartUpload> This = SharedThis(this);
+    Request->OnProcessRequestComplete().BindLambda(
+        [This, bResuming](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
+        {
+            if (This->bFinished)
+            {
+                return;
+            }
+
+            if (!bWasSuccessful || !HttpResponse.IsValid())
+            {
+                This->Finish(false, TEXT("Multipart presign network request failed"));
+                return;
+            }
+
+            const int32 ResponseCode = HttpResponse->GetResponseCode();
+            if (bResuming && ResponseCode >= 400 && ResponseCode < 500)
+            {
+                // The upload expired or was aborted on the server, start over
+                UE_LOG(LogBetaHub, Warning, TEXT("Cannot resume multipart upload of %s (HTTP %d), restarting it"),
+                    *This->FilePath, ResponseCode);
+                This->DeleteJournal();
+                This->UploadId.Empty();
+                This->BlobSignedId.Empty();
+                This->InitializeParts();
+                This->ReportProgress();
+                This->RequestPresignedParts();
+                return;
+            }
+
+            if (ResponseCode != 200 && ResponseCode != 201)
+            {
+                This->Finish(false, FString::Printf(TEXT("Multipart presign failed with HTTP %d: %s"),
+                    ResponseCode, *HttpResponse->GetContentAsString()));
+                return;
+            }
+
+            TSharedPtr<FJsonObject> JsonResponse;
+            TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(HttpResponse->GetContentAsString());
+            FString Error;
+            if (!FJsonSerializer::Deserialize(Reader, JsonResponse) || !This->ParsePresignedParts(JsonResponse, Error))
+            {
+                This->Finish(false, Error.IsEmpty() ? TEXT("Invalid multipart presign response") : Error);
+                return;
+            }
+
+            This->SaveJournal();
+            This->StartPendingParts();
+        }
+    );
+
+    Request->SetTimeout(30.0f);
+
+    if (!TrackRequest(Request))
+    {
+        // Cancelled, the owner has already reported the result
+        bFinished = true;
+        return;
+    }
+
+    Request->ProcessRequest();
+}
+
+bool BH_MultipartUpload::ParsePresignedParts(const TSharedPtr<FJsonObject>& Response, FString& OutError)
+{
+    if (!Response.IsValid())
+    {
+        return false;
+    }
+
+    FString NewUploadId;
+    if (!Response->TryGetStringField(TEXT("upload_id"), NewUploadId))
+    {
+        OutError = TEXT("Missing upload_id in multipart presign response");
+        return false;
+    }
+
+    if (!Response->TryGetStringField(TEXT("blob_signed_id"), BlobSignedId))
+    {
+        OutError = TEXT("Missing blob_signed_id in multipart presign response");
+        return false;
+    }
+
+    UploadId = NewUploadId;
+
+    const TSharedPtr<FJsonObject>* HeadersObj;
+    if (Response->TryGetObjectField(TEXT("headers"), HeadersObj))
+    {
+        PartHeaders = *HeadersObj;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* PartUrls;
+    if (!Response->TryGetArrayField(TEXT("parts"), PartUrls))
+    {
+        OutError = TEXT("Missing parts in multipart presign response");
+        return false;
+    }
+
+    for (const TSharedPtr<FJsonValue>& PartValue : *PartUrls)
+    {
+        const TSharedPtr<FJsonObject>* PartObj;
+        int32 PartNumber = 0;
+        FString Url;
+        if (!PartValue->TryGetObject(PartObj)
+            || !(*PartObj)->TryGetNumberField(TEXT("part_number"), PartNumber)
+            || !(*PartObj)->TryGetStringField(TEXT("url"), Url)
+            || !Parts.IsValidIndex(PartNumber - 1))
+        {
+            OutError = TEXT("Invalid part in multipart presign response");
+            return false;
+        }
+
+        Parts[PartNumber - 1].Url = Url;
+    }
+
+    for (const FPart& Part : Parts)
+    {
+        if (Part.ETag.IsEmpty() && Part.Url.IsEmpty())
+        {
+            OutError = FString::Printf(TEXT("No upload URL for part %d"), Part.PartNumber);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void BH_MultipartUpload::StartPendingParts()
+{
+    if (bFinished)
+    {
+        return;
+    }
+
+    bool bAllUploaded = true;
+    for (int32 PartIndex = 0; PartIndex < Parts.Num(); PartIndex++)
+    {
+        FPart& Part = Parts[PartIndex];
+        if (!Part.ETag.IsEmpty())
+        {
+            continue;
+        }
+
+        bAllUploaded = false;
+
+        if (!Part.bInFlight && RunningParts < Settings.MaxConcurrentParts)
+        {
+            Part.bInFlight = true;
+            RunningParts++;
+            UploadPart(PartIndex);
+        }
+    }
+
+    if (bAllUploaded && RunningParts == 0)
+    {
+        CompleteMultipartUpload();
+    }
+}
+
+void BH_MultipartUpload::UploadPart(int32 PartIndex)
+{
+    // Paced before the request starts, the part keeps its slot while it waits
+    TSharedRef<BH_MultipartUpload> This = SharedThis(this);
+    BH_BandwidthLimiter::Get().WhenAvailable(Parts[PartIndex].Size, [This, PartIndex]()
+    {
+        if (!This->bFinished)
+        {
+            This->SendPart(PartIndex);
+        }
+    });
+}
+
+void BH_MultipartUpload::SendPart(int32 PartIndex)
+{
+    FPart& Part = Parts[PartIndex];
+    Part.Attempts++;
+    Part.BytesSent = 0;
+
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    Request->SetURL(Part.Url);
+    Request->SetVerb(TEXT("PUT"));
+
+    if (PartHeaders.IsValid())
+    {
+        for (const auto& Pair : PartHeaders->Values)
+        {
+            FString HeaderValue;
+            if (Pair.Value->TryGetString(HeaderValue))
+            {
+                Request->SetHeader(Pair.Key, HeaderValue);
+            }
+        }
+    }
+
+    if (Data.IsValid())
+    {
+        Request->SetContent(TArray<uint8>(Data->GetData() + Part.Offset, (int32)Part.Size));
+    }
+    else
+    {
+        TSharedRef<FBH_FileRangeArchive, ESPMode::ThreadSafe> Body =
+            MakeShared<FBH_FileRangeArchive, ESPMode::ThreadSafe>(FilePath, Part.Offset, Part.Size);
+        if (!Body->IsValid())
+        {
+            Finish(false, FString::Printf(TEXT("Failed to read part %d of %s"), Part.PartNumber, *FilePath));
+            return;
+        }
+        Request->SetContentFromStream(Body);
+    }
+
+    TSharedRef<BH_MultipartUpload> This = SharedThis(this);
+
+#if ENGINE_MINOR_VERSION >= 4
+    Request->OnRequestProgress64().BindLambda(
+        [This, PartIndex](FHttpRequestPtr HttpRequest, uint64 BytesSent, uint64 BytesReceived)
+        {
+            BH_BandwidthLimiter::Get().AddSentBytes((int64)BytesSent - This->Parts[PartIndex].BytesSent);
+            This->Parts[PartIndex].BytesSent = (int64)BytesSent;
+            This->ReportProgress();
+        }
+    );
+#else
+    Request->OnRequestProgress().BindLambda(
+        [This, PartIndex](FHttpRequestPtr HttpRequest, int32 BytesSent, int32 BytesReceived)
+        {
+            BH_BandwidthLimiter::Get().AddSentBytes((int64)(uint32)BytesSent - This->Parts[PartIndex].BytesSent);
+            This->Parts[PartIndex].BytesSent = (int64)(uint32)BytesSent;
+            This->ReportProgress();
+        }
+    );
+#endif
+
+    Request->OnProcessRequestComplete().BindLambda(
+        [This, PartIndex](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
+        {
+            This->PartRequests.Remove(PartIndex);
+
+            if (This->bFinished)
+            {
+                return;
+            }
+
+            if (!bWasSuccessful || !HttpResponse.IsValid())
+            {
+                This->OnPartFailed(PartIndex, TEXT("network request failed"), true);
+                return;
+            }
+
+            const int32 ResponseCode = HttpResponse->GetResponseCode();
+            if (ResponseCode != 200)
+            {
+                // Expired or rejected URLs do not get better by retrying, the journal resumes with new ones later
+                const bool bRetryable = ResponseCode >= 500 || ResponseCode == 408 || ResponseCode == 429;
+                This->OnPartFailed(PartIndex, FString::Printf(TEXT("HTTP %d"), ResponseCode), bRetryable);
+                return;
+            }
+
+            const FString ETag = HttpResponse->GetHeader(TEXT("ETag"));
+            if (ETag.IsEmpty())
+            {
+                This->OnPartFailed(PartIndex, TEXT("no ETag in response"), false);
+                return;
+            }
+
+            FPart& CompletedPart = This->Parts[PartIndex];
+            CompletedPart.ETag = ETag;
+            CompletedPart.bInFlight = false;
+            This->RunningParts--;
+
+            This->SaveJournal();
+            This->ReportProgress();
+            This->StartPendingParts();
+        }
+    );
+
+    // Scale the timeout with the part, a part is much smaller than a whole video
+    Request->SetTimeout(FMath::Max(60.0f, (float)(Part.Size / (64 * 1024))));
+
+    if (!TrackRequest(Request))
+    {
+        // Cancelled, the owner has already reported the result
+        bFinished = true;
+        return;
+    }
+
+    PartRequests.Add(PartIndex, Request);
+    Request->ProcessRequest();
+}
+
+void BH_MultipartUpload::OnPartFailed(int32 PartIndex, const FString& Error, bool bRetryable)
+{
+    FPart& Part = Parts[PartIndex];
+
+    if (!bRetryable || Part.Attempts >= Settings.MaxPartAttempts)
+    {
+        Finish(false, FString::Printf(TEXT("Part %d of %d failed after %d attempts: %s"),
+            Part.PartNumber, Parts.Num(), Part.Attempts, *Error));
+        return;
+    }
+
+    const float Delay = FMath::Pow(2.0f, (float)(Part.Attempts - 1));
+    UE_LOG(LogBetaHub, Warning, TEXT("Part %d of %s failed (%s), retrying in %.0f s"),
+        Part.PartNumber, *FPaths::GetCleanFilename(FilePath), *Error, Delay);
+
+    Part.BytesSent = 0;
+    ReportProgress();
+
+    // The part keeps its slot while it waits
+    TSharedRef<BH_MultipartUpload> This = SharedThis(this);
+    FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([This, PartIndex](float DeltaTime)
+    {
+        if (!This->bFinished)
+        {
+            This->UploadPart(PartIndex);
+        }
+        return false;
+    }), Delay);
+}
+
+void BH_MultipartUpload::CompleteMultipartUpload()
+{
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    Request->SetURL(EndpointBase / TEXT("complete_multipart_upload"));
+    Request->SetVerb(TEXT("POST"));
+    Request->SetHeader(TEXT("Accept"), TEXT("application/json"));
+    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+    Request->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *ApiToken));
+
+    TArray<TSharedPtr<FJsonValue>> PartValues;
+    for (const FPart& Part : Parts)
+    {
+        TSharedPtr<FJsonObject> PartObject = MakeShareable(new FJsonObject);
+        PartObject->SetNumberField(TEXT("part_number"), Part.PartNumber);
+        PartObject->SetStringField(TEXT("etag"), Part.ETag);
+        PartValues.Add(MakeShareable(new FJsonValueObject(PartObject)));
+    }
+
+    TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
+    JsonObject->SetStringField(TEXT("upload_id"), UploadId);
+    JsonObject->SetStringField(TEXT("blob_signed_id"), BlobSignedId);
+    JsonObject->SetArrayField(TEXT("parts"), PartValues);
+
+    FString JsonString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+    FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
+    Request->SetContentAsString(JsonString);
+
+    TSharedRef<BH_MultipartUpload> This = SharedThis(this);
+    Request->OnProcessRequestComplete().BindLambda(
+        [This](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
+        {
+            if (!bWasSuccessful || !HttpResponse.IsValid())
+            {
+                This->Finish(false, TEXT("Multipart complete network request failed"));
+                return;
+            }
+
+            const int32 ResponseCode = HttpResponse->GetResponseCode();
+            if (ResponseCode != 200 && ResponseCode != 201)
+            {
+                This->Finish(false, FString::Printf(TEXT("Multipart complete failed with HTTP %d: %s"),
+                    ResponseCode, *HttpResponse->GetContentAsString()));
+                return;
+            }
+
+            This->DeleteJournal();
+            This->Finish(true, TEXT(""));
+        }
+    );
+
+    Request->SetTimeout(60.0f); // S3 assembles the parts before answering
+
+    if (!TrackRequest(Request))
+    {
+        // Cancelled, the owner has already reported the result
+        bFinished = true;
+        return;
+    }
+
+    Request->ProcessRequest();
+}
+
+void BH_MultipartUpload::ReportProgress()
+{
+    if (!OnProgress)
+    {
+        return;
+    }
+
+    int64 BytesSent = 0;
+    for (const FPart& Part : Parts)
+    {
+        BytesSent += Part.ETag.IsEmpty() ? FMath::Min(Part.BytesSent, Part.Size) : Part.Size;
+    }
+
+    OnProgress(BytesSent, FileSize);
+}
+
+void BH_MultipartUpload::Finish(bool bSuccess, const FString& Error)
+{
+    if (bFinished)
+    {
+        return;
+    }
+    bFinished = true;
+
+    // The journal is kept on failure, uploading the same file again resumes from it
+    TMap<int32, FHttpRequestPtr> RequestsToCancel = MoveTemp(PartRequests);
+    for (const TPair<int32, FHttpRequestPtr>& Pair : RequestsToCancel)
+    {
+        Pair.Value->CancelRequest();
+    }
+
+    OnComplete(bSuccess, Error, BlobSignedId);
+}
+
+FString BH_MultipartUpload::GetJournalPath() const
+{
+    const FDateTime Timestamp = IFileManager::Get().GetTimeStamp(*FilePath);
+    const FString Key = FString::Printf(TEXT("%s|%lld|%lld|%s"),
+        *FPaths::ConvertRelativePathToFull(FilePath), FileSize, Timestamp.GetTicks(), *EndpointBase);
+
+    return BH_StorageManager::GetUploadStateDir() / FString::Printf(TEXT("multipart_%s.json"), *FMD5::HashAnsiString(*Key));
+}
+
+void BH_MultipartUpload::LoadJournal()
+{
+    // Content in memory is prepared again for the next attempt, there is nothing to resume
+    if (Data.IsValid())
+    {
+        return;
+    }
+
+    FString JsonString;
+    if (!FFileHelper::LoadFileToString(JsonString, *GetJournalPath()))
+    {
+        return;
+    }
+
+    TSharedPtr<FJsonObject> Journal;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+    int64 JournalPartSize = 0;
+    if (!FJsonSerializer::Deserialize(Reader, Journal) || !Journal.IsValid()
+        || !Journal->TryGetNumberField(TEXT("part_size"), JournalPartSize) || JournalPartSize != Settings.PartSize)
+    {
+        // Written with a different part size, the parts do not line up
+        DeleteJournal();
+        return;
+    }
+
+    Journal->TryGetStringField(TEXT("upload_id"), UploadId);
+    Journal->TryGetStringField(TEXT("blob_signed_id"), BlobSignedId);
+
+    const TSharedPtr<FJsonObject>* ETags;
+    if (Journal->TryGetObjectField(TEXT("etags"), ETags))
+    {
+        for (const auto& Pair : (*ETags)->Values)
+        {
+            const int32 PartIndex = FCString::Atoi(*Pair.Key) - 1;
+            FString ETag;
+            if (Parts.IsValidIndex(PartIndex) && Pair.Value->TryGetString(ETag))
+            {
+                Parts[PartIndex].ETag = ETag;
+            }
+        }
+    }
+}
+
+void BH_MultipartUpload::SaveJournal() const
+{
+    if (Data.IsValid())
+    {
+        return;
+    }
+
+    TSharedPtr<FJsonObject> ETags = MakeShareable(new FJsonObject);
+    for (const FPart& Part : Parts)
+    {
+        if (!Part.ETag.IsEmpty())
+        {
+            ETags->SetStringField(FString::FromInt(Part.PartNumber), Part.ETag);
+        }
+    }
+
+    TSharedPtr<FJsonObject> Journal = MakeShareable(new FJsonObject);
+    Journal->SetStringField(TEXT("file"), FilePath);
+    Journal->SetStringField(TEXT("upload_id"), UploadId);
+    Journal->SetStringField(TEXT("blob_signed_id"), BlobSignedId);
+    Journal->SetNumberField(TEXT("part_size"), Settings.PartSize);
+    Journal->SetObjectField(TEXT("etags"), ETags);
+
+    FString JsonString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+    FJsonSerializer::Serialize(Journal.ToSharedRef(), Writer);
+
+    // A crash mid-write must not corrupt the ETags recorded so far
+    BH_StorageManager::SaveStringToFileAtomic(JsonString, GetJournalPath());
+}
+
+void BH_MultipartUpload::DeleteJournal() const
+{
+    if (Data.IsValid())
+    {
+        return;
+    }
+
+    IFileManager::Get().Delete(*GetJournalPath(), false, false, true);
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Dom/JsonObject.h"
+
+/**
+ * Uploads one large file to S3 as a multipart upload: the parts are sent concurrently and retried
+ * individually, and their ETags are journaled so an interrupted upload resumes where it stopped.
+ *
+ * API flow:
+ *   1. POST {media}/presigned_multipart_upload - returns upload_id, blob_signed_id and a presigned URL per part.
+ *      When resuming, upload_id and the missing part_numbers are sent and URLs are returned for those only.
+ *   2. PUT each part to its URL, the ETag response header identifies the part
+ *   3. POST {media}/complete_multipart_upload with the ETags of all parts
+ * The blob is then confirmed like a single-part upload.
+ */
+class BH_MultipartUpload : public TSharedFromThis<BH_MultipartUpload>
+{
+public:
+    struct FSettings
+    {
+        int64 PartSize;
+        int32 MaxConcurrentParts;
+        int32 MaxPartAttempts;
+    };
+
+    // S3 does not accept smaller parts, except the last one
+    static constexpr int64 MinPartSize = 5 * 1024 * 1024;
+
+    /**
+     * Registers a request so cancelling the upload aborts it, returns false if the upload was cancelled
+     */
+    typedef TFunction<bool(const FHttpRequestPtr&)> FTrackRequest;
+
+    typedef TFunction<void(int64 /* BytesSent */, int64 /* TotalBytes */)> FOnProgress;
+
+    typedef TFunction<void(bool /* bSuccess */, const FString& /* Error */, const FString& /* BlobSignedId */)> FOnComplete;
+
+    /**
+     * @param InEndpointBase        Media endpoint of the issue, e.g. {BaseUrl}/projects/{Id}/issues/{Id}/video_clips
+     * @param InData                Content to upload instead of the file, it is not journaled
+     * @param InChecksumAlgorithm   Algorithm of InChecksum as sent to the API, empty for MD5
+     * @param InContentEncoding     Content-Encoding of the file (e.g. gzip), empty if it is not encoded
+     */
+    BH_MultipartUpload(
+        const FString& InEndpointBase,
+        const FString& InApiToken,
+        const FString& InFilePath,
+        const TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>& InData,
+        int64 InFileSize,
+        const FString& InChecksum,
+        const FString& InChecksumAlgorithm,
+        const FString& InContentType,
+        const FString& InContentEncoding,
+        const FSettings& InSettings
+    );
+
+    void Start(const FTrackRequest& InTrackRequest, const FOnProgress& InOnProgress, const FOnComplete& InOnComplete);
+
+private:
+    struct FPart
+    {
+        int32 PartNumber;
+        int64 Offset;
+        int64 Size;
+        FString Url;
+        FString ETag;
+        int32 Attempts;
+        int64 BytesSent;
+        bool bInFlight;             // Uploading or waiting for a retry
+    };
+
+    void InitializeParts();
+    void RequestPresignedParts();
+    bool ParsePresignedParts(const TSharedPtr<FJsonObject>& Response, FString& OutError);
+
+    void StartPendingParts();
+    void UploadPart(int32 PartIndex);
+    void SendPart(int32 PartIndex);
+    void OnPartFailed(int32 PartIndex, const FString& Error, bool bRetryable);
+
+    void CompleteMultipartUpload();
+
+    void ReportProgress();
+    void Finish(bool bSuccess, const FString& Error);
+
+    // The journal is keyed by the file, its size and modification time, and the endpoint it is uploaded to
+    FString GetJournalPath() const;
+    void LoadJournal();
+    void SaveJournal() const;
+    void DeleteJournal() const;
+
+    FString EndpointBase;
+    FString ApiToken;
+    FString FilePath;
+    TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> Data;
+    int64 FileSize;
+    FString Checksum;
+    FString ChecksumAlgorithm;
+    FString ContentType;
+    FString ContentEncoding;
+    FSettings Settings;
+
+    FString UploadId;
+    FString BlobSignedId;
+    TSharedPtr<FJsonObject> PartHeaders;
+    TArray<FPart> Parts;
+    int32 RunningParts;
+    bool bFinished;
+
+    // PUT requests in flight, aborted when a part fails for good
+    TMap<int32, FHttpRequestPtr> PartRequests;
+
+    FTrackRequest TrackRequest;
+    FOnProgress OnProgress;
+    FOnComplete OnComplete;
+};
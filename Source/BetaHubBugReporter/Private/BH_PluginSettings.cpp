@@ -18,6 +18,34 @@ UBH_PluginSettings::UBH_PluginSettings()
     MaxRecordingDuration = 60;
     MaxVideoWidth = 2000;
     MaxVideoHeight = 1200;
+    bRecordTriageProxy = false;
+    TriageProxyHeight = 360;
+    TriageProxyBitrateKbps = 500;
+    bUseIntraFrameCaptureCodec = false;
+    EncoderThreadLimit = 0;
+    EncoderAffinityMask = 0;
+    bLowerEncoderPriority = false;
+    MaxStorageMB = 4096;
+    MinFreeDiskSpaceMB = 2048;
+    UploadChecksumAlgorithm = EBH_ChecksumAlgorithm::MD5;
+    bCompressLogUploads = true;
+    MaxCapturedLogMB = 16;
+    bAttachClipWindowLogs = false;
+    LogLeadInSeconds = 30;
+    MaxConcurrentUploads = 4;
+    bBatchUploadRequests = true;
+    bBundleSmallAttachments = false;
+    UploadCacheHours = 24;
+    MultipartUploadThresholdMB = 64;
+    MultipartPartSizeMB = 8;
+    MaxConcurrentUploadParts = 4;
+    MaxUploadRetryAttempts = 6;
+    UploadBandwidthLimitKbps = 0;
+    IdleUploadBandwidthLimitKbps = 0;
+    bAdaptiveUploadBandwidth = true;
+    bPreUploadWhileFormOpen = false;
+    bUploadVideoAfterPublishing = false;
+    bDetectDuplicateReports = false;
 
     static ConstructorHelpers::FClassFinder<UBH_ReportFormWidget> WidgetClassFinder1(TEXT("/BetaHubBugReporter/BugReportForm"));
     static ConstructorHelpers::FClassFinder<UBH_PopupWidget> WidgetClassFinder2(TEXT("/BetaHubBugReporter/BugReportFormPopup"));
@@ -64,4 +92,104 @@ void UBH_PluginSettings::ValidateSettings()
     {
         MaxVideoHeight = 512;
     }
+
+    if (TriageProxyHeight < 144)
+    {
+        TriageProxyHeight = 144;
+    }
+
+    if (TriageProxyBitrateKbps < 100)
+    {
+        TriageProxyBitrateKbps = 100;
+    }
+
+    if (EncoderThreadLimit < 0)
+    {
+        EncoderThreadLimit = 0;
+    }
+
+    if (MaxStorageMB < 0)
+    {
+        MaxStorageMB = 0;
+    }
+
+    if (MinFreeDiskSpaceMB < 0)
+    {
+        MinFreeDiskSpaceMB = 0;
+    }
+
+    if (MaxCapturedLogMB < 1)
+    {
+        MaxCapturedLogMB = 1;
+    }
+
+    if (MaxCapturedLogMB > 1024)
+    {
+        MaxCapturedLogMB = 1024;
+    }
+
+    if (LogLeadInSeconds < 0)
+    {
+        LogLeadInSeconds = 0;
+    }
+
+    if (MaxConcurrentUploads < 1)
+    {
+        MaxConcurrentUploads = 1;
+    }
+
+    if (MaxConcurrentUploads > 16)
+    {
+        MaxConcurrentUploads = 16;
+    }
+
+    if (MultipartUploadThresholdMB < 0)
+    {
+        MultipartUploadThresholdMB = 0;
+    }
+
+    if (UploadCacheHours < 0)
+    {
+        UploadCacheHours = 0;
+    }
+
+    if (UploadCacheHours > 168)
+    {
+        UploadCacheHours = 168;
+    }
+
+    if (MultipartPartSizeMB < 5)
+    {
+        MultipartPartSizeMB = 5;
+    }
+
+    if (MultipartPartSizeMB > 512)
+    {
+        MultipartPartSizeMB = 512;
+    }
+
+    if (MaxConcurrentUploadParts < 1)
+    {
+        MaxConcurrentUploadParts = 1;
+    }
+
+    if (MaxConcurrentUploadParts > 16)
+    {
+        MaxConcurrentUploadParts = 16;
+    }
+
+    if (MaxUploadRetryAttempts < 0)
+    {
+        MaxUploadRetryAttempts = 0;
+    }
+
+    if (UploadBandwidthLimitKbps < 0)
+    {
+        UploadBandwidthLimitKbps = 0;
+    }
+
+    if (IdleUploadBandwidthLimitKbps < 0)
+    {
+        IdleUploadBandwidthLimitKbps = 0;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,131 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "BH_ReportBundle.h"
+#include "BH_Log.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Compression.h"
+
+namespace
+{
+    const int32 TarBlockSize = 512;
+
+    // Writes an octal number followed by a NUL, left-padded with zeros to fill the field
+    void WriteTarOctal(uint8* Field, int32 FieldSize, int64 Value)
+    {
+        Field[FieldSize - 1] = 0;
+        for (int32 Index = FieldSize - 2; Index >= 0; --Index)
+        {
+            Field[Index] = (uint8)('0' + (Value & 7));
+            Value >>= 3;
+        }
+    }
+}
+
+bool BH_ReportBundle::Build(const TArray<FEntry>& Entries, TArray<uint8>& OutArchive, FString& OutError)
+{
+    const int64 Now = FDateTime::UtcNow().ToUnixTimestamp();
+
+    TArray<uint8> Tar;
+    TArray<TSharedPtr<FJsonValue>> ManifestFiles;
+
+    for (int32 Index = 0; Index < Entries.Num(); ++Index)
+    {
+        const FEntry& Entry = Entries[Index];
+        const FString Filename = FPaths::GetCleanFilename(Entry.FilePath);
+
+        // Indices keep the paths unique and short enough for a tar header, the real name is in the manifest
+        const FString Extension = FPaths::GetExtension(Filename);
+        const FString Path = Extension.IsEmpty()
+            ? FString::Printf(TEXT("files/%d"), Index)
+            : FString::Printf(TEXT("files/%d.%s"), Index, *Extension.Left(16));
+
+        if (Entry.Content.IsValid())
+        {
+            AppendTarFile(Tar, Path, Entry.Content->GetData(), Entry.Content->Num(), Now);
+        }
+        else
+        {
+            TArray<uint8> FileData;
+            if (!FFileHelper::LoadFileToArray(FileData, *Entry.FilePath))
+            {
+                OutError = FString::Printf(TEXT("Failed to read file: %s"), *Filename);
+                return false;
+            }
+            AppendTarFile(Tar, Path, FileData.GetData(), FileData.Num(), Now);
+        }
+
+        TSharedRef<FJsonObject> ManifestFile = MakeShared<FJsonObject>();
+        ManifestFile->SetStringField(TEXT("path"), Path);
+        ManifestFile->SetStringField(TEXT("media_type"), BH_MediaTypeHelper::GetAPIEndpoint(Entry.MediaType));
+        ManifestFile->SetStringField(TEXT("filename"), Filename);
+        ManifestFile->SetStringField(TEXT("content_type"), Entry.ContentType);
+        if (!Entry.Name.IsEmpty())
+        {
+            ManifestFile->SetStringField(TEXT("name"), Entry.Name);
+        }
+        ManifestFiles.Add(MakeShared<FJsonValueObject>(ManifestFile));
+    }
+
+    TSharedRef<FJsonObject> Manifest = MakeShared<FJsonObject>();
+    Manifest->SetNumberField(TEXT("version"), 1);
+    Manifest->SetArrayField(TEXT("files"), ManifestFiles);
+
+    FString ManifestString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ManifestString);
+    FJsonSerializer::Serialize(Manifest, Writer);
+    FTCHARToUTF8 ManifestUtf8(*ManifestString, ManifestString.Len());
+
+    // Written last, once every file is in the archive
+    AppendTarFile(Tar, TEXT("manifest.json"), (const uint8*)ManifestUtf8.Get(), ManifestUtf8.Length(), Now);
+
+    // End of archive: two empty blocks
+    Tar.AddZeroed(TarBlockSize * 2);
+
+    int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Gzip, Tar.Num());
+    OutArchive.SetNumUninitialized(CompressedSize);
+    if (!FCompression::CompressMemory(NAME_Gzip, OutArchive.GetData(), CompressedSize, Tar.GetData(), Tar.Num(), COMPRESS_BiasSpeed))
+    {
+        OutError = TEXT("Failed to compress the report bundle");
+        return false;
+    }
+    OutArchive.SetNum(CompressedSize, false);
+
+    UE_LOG(LogBetaHub, Log, TEXT("Bundled %d files into %d bytes (%d uncompressed)"), Entries.Num(), OutArchive.Num(), Tar.Num());
+    return true;
+}
+
+void BH_ReportBundle::AppendTarFile(TArray<uint8>& Tar, const FString& Path, const uint8* Data, int64 Size, int64 ModifiedTime)
+{
+    // ustar header, see POSIX.1-1988
+    const int32 HeaderOffset = Tar.AddZeroed(TarBlockSize);
+    uint8* Header = Tar.GetData() + HeaderOffset;
+
+    FTCHARToUTF8 PathUtf8(*Path);
+    FMemory::Memcpy(Header, PathUtf8.Get(), FMath::Min(PathUtf8.Length(), 100));
+    WriteTarOctal(Header + 100, 8, 0644);           // mode
+    WriteTarOctal(Header + 108, 8, 0);              // uid
+    WriteTarOctal(Header + 116, 8, 0);              // gid
+    WriteTarOctal(Header + 124, 12, Size);
+    WriteTarOctal(Header + 136, 12, ModifiedTime);
+    Header[156] = '0';                              // regular file
+    FMemory::Memcpy(Header + 257, "ustar", 6);
+    FMemory::Memcpy(Header + 263, "00", 2);
+
+    // The checksum is computed with its own field filled with spaces
+    FMemory::Memset(Header + 148, ' ', 8);
+    uint32 Checksum = 0;
+    for (int32 Index = 0; Index < TarBlockSize; ++Index)
+    {
+        Checksum += Header[Index];
+    }
+    WriteTarOctal(Header + 148, 7, Checksum);
+
+    if (Size > 0)
+    {
+        Tar.Append(Data, (int32)Size);
+        Tar.AddZeroed((int32)((TarBlockSize - Size % TarBlockSize) % TarBlockSize));
+    }
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BH_MediaTypes.h"
+
+/**
+ * Packs the small files of a report (screenshots, logs) into one gzip-compressed tar archive, so they are
+ * uploaded as a single object that BetaHub expands into the report's attachments.
+ *
+ * Archive layout:
+ *   manifest.json      {"version": 1, "files": [{"path": "files/0.jpg", "media_type": "screenshots",
+ *                       "filename": "screenshot.jpg", "content_type": "image/jpeg", "name": "..."}, ...]}
+ *   files/<index>.<extension>
+ */
+class BH_ReportBundle
+{
+public:
+    struct FEntry
+    {
+        EBH_MediaType MediaType;
+        FString FilePath;           // File to pack, for content in memory only the file name is used
+        TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> Content;    // Packed instead of the file when set
+        FString ContentType;
+        FString Name;               // Optional custom display name
+    };
+
+    // Larger files are uploaded on their own
+    static constexpr int64 MaxEntryBytes = 4 * 1024 * 1024;
+
+    static constexpr const TCHAR* Filename = TEXT("report_bundle.tar.gz");
+
+    /**
+     * Builds the archive in memory.
+     * Blocks until done, only call it from a worker thread.
+     *
+     * @param OutError      Why the archive could not be built, e.g. a file that cannot be read
+     * @return              False if the archive could not be built
+     */
+    static bool Build(const TArray<FEntry>& Entries, TArray<uint8>& OutArchive, FString& OutError);
+
+private:
+    static void AppendTarFile(TArray<uint8>& Tar, const FString& Path, const uint8* Data, int64 Size, int64 ModifiedTime);
+};
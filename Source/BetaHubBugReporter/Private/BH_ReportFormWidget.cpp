@@ -8,12 +8,14 @@
 #include "BH_BugReport.h"
 #include "BH_FeatureRequest.h"
 #include "BH_PopupWidget.h"
+#include "BH_LogCapture.h"
 
 // constructor
 UBH_ReportFormWidget::UBH_ReportFormWidget(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer)
     , GameRecorder(nullptr)
     , Settings(nullptr)
+    , SpeculativeReport(nullptr)
     , CurrentReportType(EBH_ReportType::Bug)
     , bCursorStateModified(false)
     , bWasCursorVisible(false)
@@ -49,6 +51,17 @@ void UBH_ReportFormWidget::NativeOnInitialized()
         SuggestionCheckBox->OnCheckStateChanged.AddDynamic(this, &UBH_ReportFormWidget::OnSuggestionCheckBoxChanged);
     }
 
+    if (DuplicateButton)
+    {
+        DuplicateButton->OnClicked.AddDynamic(this, &UBH_ReportFormWidget::OnDuplicateClicked);
+        DuplicateButton->SetVisibility(ESlateVisibility::Collapsed);
+    }
+
+    if (DuplicateLabel)
+    {
+        DuplicateLabel->SetVisibility(ESlateVisibility::Collapsed);
+    }
+
     // Initialize form to default state (Bug Report)
     SetReportType(EBH_ReportType::Bug);
 }
@@ -70,6 +83,52 @@ bool bTryCaptureMouse)
     {
         GameRecorder->StopRecording();
     }
+
+    if (Settings && Settings->bDetectDuplicateReports)
+    {
+        Signature = UBH_BugReport::ComputeSignature(Settings, GetWorld(), LogProblems);
+
+        TWeakObjectPtr<UBH_ReportFormWidget> WeakThis(this);
+        UBH_BugReport::FindDuplicateIssue(Settings, Signature, [WeakThis](const FString& IssueId, const FString& IssueTitle)
+        {
+            UBH_ReportFormWidget* Self = WeakThis.Get();
+            if (!Self || IssueId.IsEmpty())
+            {
+                return;
+            }
+
+            UE_LOG(LogBetaHub, Log, TEXT("Report matches open issue %s: %s"), *IssueId, *IssueTitle);
+            Self->DuplicateIssueId = IssueId;
+
+            if (Self->DuplicateLabel)
+            {
+                Self->DuplicateLabel->SetText(FText::FromString(FString::Printf(TEXT("This looks like a known issue: %s"), *IssueTitle)));
+            }
+            Self->UpdateFormForReportType();
+
+            Self->OnDuplicateIssueFound(IssueTitle);
+        });
+    }
+
+    // Most reports are bug reports with the default attachments, their media is uploaded while the player types
+    if (Settings && Settings->bPreUploadWhileFormOpen)
+    {
+        TArray<FBH_MediaFile> Screenshots;
+        TArray<FBH_MediaFile> Logs;
+
+        if (!ScreenshotPath.IsEmpty())
+        {
+            FBH_MediaFile Screenshot;
+            Screenshot.FilePath = ScreenshotPath;
+            Screenshots.Add(Screenshot);
+        }
+
+        AddLogFile(Logs);
+
+        SpeculativeReport = NewObject<UBH_BugReport>(this);
+        SpeculativeReport->SetSignature(Signature);
+        SpeculativeReport->BeginSpeculativeReport(Settings, GameRecorder, Screenshots, Logs);
+    }
 }
 
 void UBH_ReportFormWidget::SubmitReport()
@@ -92,6 +151,59 @@ void UBH_ReportFormWidget::SubmitReport()
         UE_LOG(LogBetaHub, Log, TEXT("Bug Description: %s"), *Description);
         UE_LOG(LogBetaHub, Log, TEXT("Steps to Reproduce: %s"), *StepsToReproduce);
 
+        // Capture ScreenshotPath for cleanup in callbacks
+        FString ScreenshotPathCopy = ScreenshotPath;
+
+        TFunction<void()> OnSuccess = [WeakThis, ScreenshotPathCopy]()
+        {
+            // Cleanup screenshot file
+            if (!ScreenshotPathCopy.IsEmpty())
+            {
+                IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+                if (PlatformFile.FileExists(*ScreenshotPathCopy))
+                {
+                    PlatformFile.DeleteFile(*ScreenshotPathCopy);
+                }
+            }
+
+            if (UBH_ReportFormWidget* Self = WeakThis.Get())
+            {
+                Self->bSuppressCursorRestore = true;
+                Self->ShowPopup("Success", "Bug report submitted successfully!");
+                Self->RemoveFromParent();
+            }
+        };
+
+        TFunction<void(const FString&)> OnFailure = [WeakThis, ScreenshotPathCopy](const FString& ErrorMessage)
+        {
+            // Cleanup screenshot file even on failure
+            if (!ScreenshotPathCopy.IsEmpty())
+            {
+                IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+                if (PlatformFile.FileExists(*ScreenshotPathCopy))
+                {
+                    PlatformFile.DeleteFile(*ScreenshotPathCopy);
+                }
+            }
+
+            if (UBH_ReportFormWidget* Self = WeakThis.Get())
+            {
+                Self->ShowPopup("Error", ErrorMessage);
+                Self->SubmitLabel->SetText(FText::FromString("Submit"));
+            }
+        };
+
+        // The media is already uploaded, only the text and the choice of attachments are sent
+        if (SpeculativeReport)
+        {
+            UBH_BugReport* BugReport = SpeculativeReport;
+            SpeculativeReport = nullptr;
+            BugReport->FinishSpeculativeReport(Description, StepsToReproduce,
+                IncludeVideoCheckbox->IsChecked(), IncludeScreenshotCheckbox->IsChecked(), IncludeLogsCheckbox->IsChecked(),
+                OnSuccess, OnFailure);
+            return;
+        }
+
         // Build media file arrays
         TArray<FBH_MediaFile> Videos;  // Empty - video is handled via GameRecorder
         TArray<FBH_MediaFile> Screenshots;
@@ -104,65 +216,30 @@ void UBH_ReportFormWidget::SubmitReport()
             Screenshots.Add(Screenshot);
         }
 
-        if (IncludeLogsCheckbox->IsChecked() && !LogFileContents.IsEmpty())
+        if (IncludeLogsCheckbox->IsChecked())
         {
-            FBH_MediaFile Log;
-            Log.Content = LogFileContents;
-            Logs.Add(Log);
+            AddLogFile(Logs);
         }
 
         // Only pass GameRecorder if video checkbox is checked
         UBH_GameRecorder* RecorderToPass = (IncludeVideoCheckbox->IsChecked() && GameRecorder) ? GameRecorder : nullptr;
 
-        // Capture ScreenshotPath for cleanup in callbacks
-        FString ScreenshotPathCopy = ScreenshotPath;
-
         UBH_BugReport* BugReport = NewObject<UBH_BugReport>();
+        BugReport->SetSignature(Signature);
         BugReport->SubmitReportWithMedia(Settings, RecorderToPass, Description, StepsToReproduce,
-            Videos, Screenshots, Logs,
-            [WeakThis, ScreenshotPathCopy]()
-            {
-                // Cleanup screenshot file
-                if (!ScreenshotPathCopy.IsEmpty())
-                {
-                    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-                    if (PlatformFile.FileExists(*ScreenshotPathCopy))
-                    {
-                        PlatformFile.DeleteFile(*ScreenshotPathCopy);
-                    }
-                }
-
-                if (UBH_ReportFormWidget* Self = WeakThis.Get())
-                {
-                    Self->bSuppressCursorRestore = true;
-                    Self->ShowPopup("Success", "Bug report submitted successfully!");
-                    Self->RemoveFromParent();
-                }
-            },
-            [WeakThis, ScreenshotPathCopy](const FString& ErrorMessage)
-            {
-                // Cleanup screenshot file even on failure
-                if (!ScreenshotPathCopy.IsEmpty())
-                {
-                    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-                    if (PlatformFile.FileExists(*ScreenshotPathCopy))
-                    {
-                        PlatformFile.DeleteFile(*ScreenshotPathCopy);
-                    }
-                }
-
-                if (UBH_ReportFormWidget* Self = WeakThis.Get())
-                {
-                    Self->ShowPopup("Error", ErrorMessage);
-                    Self->SubmitLabel->SetText(FText::FromString("Submit"));
-                }
-            }
-        );
+            Videos, Screenshots, Logs, OnSuccess, OnFailure);
     }
     else // EBH_ReportType::Suggestion
     {
         UE_LOG(LogBetaHub, Log, TEXT("Suggestion Description: %s"), *Description);
 
+        // Suggestions are not bug reports, the draft created when the form opened is not needed
+        if (SpeculativeReport)
+        {
+            SpeculativeReport->AbandonSpeculativeReport();
+            SpeculativeReport = nullptr;
+        }
+
         UBH_FeatureRequest* FeatureRequest = NewObject<UBH_FeatureRequest>();
         FeatureRequest->SubmitFeatureRequest(Settings, Description, ScreenshotPath, IncludeScreenshotCheckbox->IsChecked(),
             [WeakThis]()
@@ -186,6 +263,87 @@ void UBH_ReportFormWidget::SubmitReport()
     }
 }
 
+void UBH_ReportFormWidget::SubmitDuplicateReport()
+{
+    if (DuplicateIssueId.IsEmpty())
+    {
+        UE_LOG(LogBetaHub, Warning, TEXT("No existing issue to add the report to, submitting a new one"));
+        SubmitReport();
+        return;
+    }
+
+    // The video and logs are not sent, the draft with them is not needed
+    if (SpeculativeReport)
+    {
+        SpeculativeReport->AbandonSpeculativeReport();
+        SpeculativeReport = nullptr;
+    }
+
+    TWeakObjectPtr<UBH_ReportFormWidget> WeakThis(this);
+    const FString ScreenshotPathCopy = ScreenshotPath;
+    const FString ScreenshotToSend = IncludeScreenshotCheckbox->IsChecked() ? ScreenshotPath : FString();
+
+    UBH_BugReport* BugReport = NewObject<UBH_BugReport>();
+    BugReport->SetSignature(Signature);
+    BugReport->SubmitDuplicateReport(Settings, DuplicateIssueId, BugDescriptionEdit->GetText().ToString(), StepsToReproduceEdit->GetText().ToString(),
+        ScreenshotToSend,
+        [WeakThis, ScreenshotPathCopy]()
+        {
+            if (!ScreenshotPathCopy.IsEmpty())
+            {
+                FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*ScreenshotPathCopy);
+            }
+
+            if (UBH_ReportFormWidget* Self = WeakThis.Get())
+            {
+                // No video was saved, so the report did not restart the recording
+                if (Self->GameRecorder && Self->Settings)
+                {
+                    Self->GameRecorder->StartRecording(Self->Settings->MaxRecordedFrames, Self->Settings->MaxRecordingDuration);
+                }
+
+                Self->bSuppressCursorRestore = true;
+                Self->ShowPopup("Success", "Thank you! Your report was added to the existing issue.");
+                Self->RemoveFromParent();
+            }
+        },
+        [WeakThis](const FString& ErrorMessage)
+        {
+            if (UBH_ReportFormWidget* Self = WeakThis.Get())
+            {
+                Self->ShowPopup("Error", ErrorMessage);
+                Self->SubmitLabel->SetText(FText::FromString("Submit"));
+            }
+        }
+    );
+}
+
+void UBH_ReportFormWidget::SetLogProblems(const TArray<FString>& InLogProblems)
+{
+    LogProblems = InLogProblems;
+}
+
+void UBH_ReportFormWidget::SetLogSnapshot(const TSharedPtr<const FBH_LogSnapshot, ESPMode::ThreadSafe>& InLogSnapshot)
+{
+    LogSnapshot = InLogSnapshot;
+}
+
+void UBH_ReportFormWidget::AddLogFile(TArray<FBH_MediaFile>& Logs) const
+{
+    if (LogSnapshot.IsValid() && !LogSnapshot->IsEmpty())
+    {
+        FBH_MediaFile Log;
+        Log.LogSnapshot = LogSnapshot;
+        Logs.Add(Log);
+    }
+    else if (!LogFileContents.IsEmpty())
+    {
+        FBH_MediaFile Log;
+        Log.Content = LogFileContents;
+        Logs.Add(Log);
+    }
+}
+
 void UBH_ReportFormWidget::SetCursorState()
 {
     if (APlayerController* PlayerController = GetOwningPlayer())
@@ -239,6 +397,13 @@ void UBH_ReportFormWidget::NativeDestruct()
     // Restore cursor state when the widget is destructed (hidden)
     RestoreCursorState();
 
+    // Closed without submitting the bug report
+    if (SpeculativeReport)
+    {
+        SpeculativeReport->AbandonSpeculativeReport();
+        SpeculativeReport = nullptr;
+    }
+
     IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
 
     // We can't delete the screenshot file here as it still could be used by the BugReport to upload the media
@@ -257,6 +422,12 @@ void UBH_ReportFormWidget::OnSubmitButtonClicked()
     SubmitReport();
 }
 
+void UBH_ReportFormWidget::OnDuplicateClicked()
+{
+    SubmitLabel->SetText(FText::FromString("Submitting..."));
+    SubmitDuplicateReport();
+}
+
 void UBH_ReportFormWidget::OnCloseClicked()
 {
     if (GameRecorder && Settings)
@@ -352,4 +523,18 @@ void UBH_ReportFormWidget::UpdateFormForReportType()
     {
         IncludeLogsContainer->SetVisibility(BugReportVisibility);
     }
+
+    // A suggestion is not added to a bug report
+    if (!DuplicateIssueId.IsEmpty())
+    {
+        if (DuplicateButton)
+        {
+            DuplicateButton->SetVisibility(BugReportVisibility);
+        }
+
+        if (DuplicateLabel)
+        {
+            DuplicateLabel->SetVisibility(BugReportVisibility);
+        }
+    }
 }
\ No newline at end of file
@@ -24,8 +24,8 @@ FString FBH_Runnable::RunCommand(const FString& Command, const FString& Params,
     return Runnable.GetBufferedOutput();
 }
 
-FBH_Runnable::FBH_Runnable(const FString& Command, const FString& Params, const FString& WorkingDirectory)
-    : Command(Command), Params(Params), WorkingDirectory(WorkingDirectory), ProcessHandle(nullptr),
+FBH_Runnable::FBH_Runnable(const FString& Command, const FString& Params, const FString& WorkingDirectory, int32 PriorityModifier, uint64 AffinityMask)
+    : Command(Command), Params(Params), WorkingDirectory(WorkingDirectory), PriorityModifier(PriorityModifier), AffinityMask(AffinityMask), ProcessHandle(nullptr),
       StdInReadPipe(nullptr), StdInWritePipe(nullptr), StdOutReadPipe(nullptr), StdOutWritePipe(nullptr), StopTaskCounter(0),
       bTerminateByStdinFlag(false)
 {
@@ -35,7 +35,9 @@ FBH_Runnable::FBH_Runnable(const FString& Command, const FString& Params, const
     // It can happen when the process is about to exit, but we're still trying to write the pipe.
     CreatePipe(StdInReadPipe, StdInWritePipe, true, 64 * 1024 * 1024); // 64MB buffer for stdin
 
-    Thread = FRunnableThread::Create(this, TEXT("FBH_RunnableThread"), 0, TPri_Normal);
+    Thread = FRunnableThread::Create(this, TEXT("FBH_RunnableThread"), 0,
+        PriorityModifier < 0 ? TPri_BelowNormal : TPri_Normal,
+        AffinityMask != 0 ? AffinityMask : FPlatformAffinity::GetNoAffinityMask());
 
     if (!Thread)
     {
@@ -85,13 +87,20 @@ uint32 FBH_Runnable::Run()
 {
     UE_LOG(LogBetaHub, Log, TEXT("Starting process %s %s."), *Command, *Params);
 
-    ProcessHandle = FPlatformProcess::CreateProc(*Command, *Params, false, false, true, nullptr, 0, *WorkingDirectory, StdOutWritePipe, StdInReadPipe);
+    ProcessHandle = FPlatformProcess::CreateProc(*Command, *Params, false, false, true, nullptr, PriorityModifier, *WorkingDirectory, StdOutWritePipe, StdInReadPipe);
     if (!ProcessHandle.IsValid())
     {
         UE_LOG(LogBetaHub, Error, TEXT("Failed to start process."));
         return 1;
     }
 
+#if PLATFORM_WINDOWS
+    if (AffinityMask != 0 && !::SetProcessAffinityMask(ProcessHandle.Get(), (DWORD_PTR)AffinityMask))
+    {
+        UE_LOG(LogBetaHub, Warning, TEXT("Failed to set process affinity mask 0x%llx (error %u)."), AffinityMask, ::GetLastError());
+    }
+#endif
+
     bool bExitedGracefully = false;
 
     while (StopTaskCounter.GetValue() == 0)
@@ -204,6 +213,28 @@ bool FBH_Runnable::IsProcessRunning(int32* ExitCode)
     }
 }
 
+double FBH_Runnable::GetProcessCpuSeconds()
+{
+#if PLATFORM_WINDOWS
+    if (ProcessHandle.IsValid())
+    {
+        FILETIME CreationTime, ExitTime, KernelTime, UserTime;
+        if (::GetProcessTimes(ProcessHandle.Get(), &CreationTime, &ExitTime, &KernelTime, &UserTime))
+        {
+            ULARGE_INTEGER Kernel, User;
+            Kernel.LowPart = KernelTime.dwLowDateTime;
+            Kernel.HighPart = KernelTime.dwHighDateTime;
+            User.LowPart = UserTime.dwLowDateTime;
+            User.HighPart = UserTime.dwHighDateTime;
+
+            // FILETIME is in 100ns units
+            return (Kernel.QuadPart + User.QuadPart) / 10000000.0;
+        }
+    }
+#endif
+    return 0.0;
+}
+
 void FBH_Runnable::WaitForExit()
 {
     if (Thread)
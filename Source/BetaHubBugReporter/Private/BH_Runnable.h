@@ -14,7 +14,10 @@
 class FBH_Runnable : public FRunnable
 {
 public:
-    FBH_Runnable(const FString& Command, const FString& Params = TEXT(""), const FString& WorkingDirectory = FPaths::ProjectDir());
+    // PriorityModifier is passed to FPlatformProcess::CreateProc (-2 idle ... 2 highest), a negative value
+    // also lowers the priority of the pipe reading thread. AffinityMask pins both the process and that
+    // thread to the given logical cores (0 keeps the default affinity).
+    FBH_Runnable(const FString& Command, const FString& Params = TEXT(""), const FString& WorkingDirectory = FPaths::ProjectDir(), int32 PriorityModifier = 0, uint64 AffinityMask = 0);
     virtual ~FBH_Runnable();
 
     virtual uint32 Run() override;
@@ -24,6 +27,9 @@ public:
     bool IsProcessRunning(int32* ExitCode = nullptr);
     void WaitForExit();
 
+    // Total user and kernel CPU time consumed by the process so far, in seconds
+    double GetProcessCpuSeconds();
+
     // static method to run a command and return the output
     static FString RunCommand(const FString& Command, const FString& Params, const FString& WorkingDirectory, int32 &ExitCode);
     static FString RunCommand(const FString& Command, const FString& Params = TEXT(""), const FString& WorkingDirectory = FPaths::ProjectDir());
@@ -32,6 +38,8 @@ private:
     FString Command;
     FString Params;
     FString WorkingDirectory;
+    int32 PriorityModifier;
+    uint64 AffinityMask;
     FProcHandle ProcessHandle;
 
     void* StdInReadPipe;
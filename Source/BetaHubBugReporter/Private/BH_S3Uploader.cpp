@@ -1,6 +1,13 @@
 // Copyright (c) 2024-2026 Upsoft sp. z o. o.
 #include "BH_S3Uploader.h"
 #include "BH_Log.h"
+#include "BH_Checksum.h"
+#include "BH_MultipartUpload.h"
+#include "BH_UploadBatcher.h"
+#include "BH_BandwidthLimiter.h"
+#include "BH_BlobCache.h"
+#include "BH_FileRangeArchive.h"
+#include "BH_PluginSettings.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpResponse.h"
 #include "Dom/JsonObject.h"
@@ -11,16 +18,31 @@
 #include "Misc/Base64.h"
 #include "Misc/SecureHash.h"
 #include "HAL/PlatformFilemanager.h"
+#include "HAL/FileManager.h"
+#include "Async/Async.h"
+#include "Async/AsyncFileHandle.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Compression.h"
+#include "Runtime/Launch/Resources/Version.h"
 
 BH_S3Uploader::BH_S3Uploader()
+    : NextUploadId(1)
+    , Batcher(GetDefault<UBH_PluginSettings>()->bBatchUploadRequests)
 {
+    const UBH_PluginSettings* Settings = GetDefault<UBH_PluginSettings>();
+    ChecksumAlgorithm = Settings->UploadChecksumAlgorithm;
+    bCompressTextUploads = Settings->bCompressLogUploads;
+    MultipartThresholdBytes = (int64)Settings->MultipartUploadThresholdMB * 1024 * 1024;
+    MultipartSettings.PartSize = (int64)Settings->MultipartPartSizeMB * 1024 * 1024;
+    MultipartSettings.MaxConcurrentParts = Settings->MaxConcurrentUploadParts;
+    MultipartSettings.MaxPartAttempts = 4;
 }
 
 BH_S3Uploader::~BH_S3Uploader()
 {
 }
 
-void BH_S3Uploader::UploadFileToS3(
+int32 BH_S3Uploader::UploadFileToS3(
     const FString& BaseUrl,
     const FString& ProjectId,
     const FString& IssueId,
@@ -29,41 +51,401 @@ void BH_S3Uploader::UploadFileToS3(
     const FString& FilePath,
     const FString& ContentType,
     const FString& CustomName,
-    const FOnUploadComplete& OnComplete)
+    const FOnUploadComplete& OnComplete,
+    const FOnUploadProgress& OnProgress,
+    const FOnUploadStage& OnStage)
+{
+    int32 UploadId;
+    FOnUploadComplete Finish = BeginUpload(OnComplete, OnStage, UploadId);
+
+    // The file is never loaded as a whole and never read on the calling thread:
+    // it is hashed in chunks on a worker and streamed to S3. Text files are compressed on the worker first.
+    const FString Filename = FPaths::GetCleanFilename(FilePath);
+    TakePreparedFile(FilePath, ContentType).Next(
+        [this, UploadId, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, Filename, ContentType, CustomName, Finish, OnProgress]
+        (FPreparedFile Prepared)
+        {
+            AsyncTask(ENamedThreads::GameThread,
+                [this, UploadId, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, Filename, ContentType, CustomName, Finish, OnProgress, Prepared]()
+                {
+                    OnFilePrepared(UploadId, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, Filename, Prepared,
+                        ContentType, CustomName, Finish, OnProgress);
+                });
+        });
+
+    return UploadId;
+}
+
+int32 BH_S3Uploader::UploadDataToS3(
+    const FString& BaseUrl,
+    const FString& ProjectId,
+    const FString& IssueId,
+    const FString& ApiToken,
+    const FString& MediaEndpoint,
+    const TSharedRef<TArray<uint8>, ESPMode::ThreadSafe>& Data,
+    const FString& Filename,
+    const FString& ContentType,
+    const FString& CustomName,
+    const FOnUploadComplete& OnComplete,
+    const FOnUploadProgress& OnProgress,
+    const FOnUploadStage& OnStage)
 {
-    // Read file data
-    TArray<uint8> FileData;
-    if (!FFileHelper::LoadFileToArray(FileData, *FilePath))
+    int32 UploadId;
+    FOnUploadComplete Finish = BeginUpload(OnComplete, OnStage, UploadId);
+
+    Async(EAsyncExecution::ThreadPool,
+        [Data, ContentType, Algorithm = ChecksumAlgorithm, bCompress = bCompressTextUploads]()
+        {
+            return PrepareData(Data, ContentType, Algorithm, bCompress);
+        }).Next(
+        [this, UploadId, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, Filename, ContentType, CustomName, Finish, OnProgress]
+        (FPreparedFile Prepared)
+        {
+            AsyncTask(ENamedThreads::GameThread,
+                [this, UploadId, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, Filename, ContentType, CustomName, Finish, OnProgress, Prepared]()
+                {
+                    OnFilePrepared(UploadId, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, Filename, Prepared,
+                        ContentType, CustomName, Finish, OnProgress);
+                });
+        });
+
+    return UploadId;
+}
+
+int32 BH_S3Uploader::UploadBundleToS3(
+    const FString& BaseUrl,
+    const FString& ProjectId,
+    const FString& IssueId,
+    const FString& ApiToken,
+    const TArray<BH_ReportBundle::FEntry>& Entries,
+    const FOnUploadComplete& OnComplete,
+    const FOnUploadProgress& OnProgress)
+{
+    int32 UploadId;
+    FOnUploadComplete Finish = BeginUpload(OnComplete, FOnUploadStage(), UploadId);
+
+    const FString MediaEndpoint = BH_MediaTypeHelper::GetAPIEndpoint(EBH_MediaType::Bundle);
+    const FString Filename = BH_ReportBundle::Filename;
+    const FString ContentType = BH_MediaTypeHelper::GetDefaultContentType(EBH_MediaType::Bundle, Filename);
+
+    Async(EAsyncExecution::ThreadPool,
+        [Entries, ContentType, Algorithm = ChecksumAlgorithm]()
+        {
+            TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> Archive = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+            FString Error;
+            if (!BH_ReportBundle::Build(Entries, *Archive, Error))
+            {
+                // No checksum, the upload fails once it is back on the game thread
+                UE_LOG(LogBetaHub, Error, TEXT("Failed to build the report bundle: %s"), *Error);
+                return FPreparedFile();
+            }
+
+            // Already compressed as a whole
+            return PrepareData(Archive, ContentType, Algorithm, false);
+        }).Next(
+        [this, UploadId, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, Filename, ContentType, Finish, OnProgress]
+        (FPreparedFile Prepared)
+        {
+            AsyncTask(ENamedThreads::GameThread,
+                [this, UploadId, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, Filename, ContentType, Finish, OnProgress, Prepared]()
+                {
+                    OnFilePrepared(UploadId, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, Filename, Prepared,
+                        ContentType, FString(), Finish, OnProgress);
+                });
+        });
+
+    return UploadId;
+}
+
+void BH_S3Uploader::OnFilePrepared(
+    int32 UploadId,
+    const FString& BaseUrl,
+    const FString& ProjectId,
+    const FString& IssueId,
+    const FString& ApiToken,
+    const FString& MediaEndpoint,
+    const FString& Filename,
+    const FPreparedFile& Prepared,
+    const FString& ContentType,
+    const FString& CustomName,
+    const FOnUploadComplete& OnComplete,
+    const FOnUploadProgress& OnProgress)
+{
+    if (!ActiveUploads.Contains(UploadId))
     {
-        UE_LOG(LogBetaHub, Error, TEXT("Failed to read file: %s"), *FilePath);
+        // Cancelled while hashing
+        return;
+    }
+
+    const int64 FileSize = Prepared.Data.IsValid() ? Prepared.Data->Num() : IFileManager::Get().FileSize(*Prepared.FilePath);
+    if (Prepared.Checksum.IsEmpty() || FileSize < 0)
+    {
+        UE_LOG(LogBetaHub, Error, TEXT("Failed to read file: %s"), *Filename);
         FUploadResult Result;
         Result.bSuccess = false;
-        Result.ErrorMessage = FString::Printf(TEXT("Failed to read file: %s"), *FilePath);
+        Result.ErrorMessage = FString::Printf(TEXT("Failed to read file: %s"), *Filename);
         OnComplete.ExecuteIfBound(Result);
         return;
     }
 
-    // Calculate file properties
-    const FString Filename = FPaths::GetCleanFilename(FilePath);
-    const int64 FileSize = FileData.Num();
-    const FString Checksum = CalculateMD5Checksum(FileData);
+    UploadWithChecksum(UploadId, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, Filename, Prepared, FileSize,
+        ContentType, CustomName, OnComplete, OnProgress);
+}
+
+int32 BH_S3Uploader::ConfirmExistingUpload(
+    const FString& BaseUrl,
+    const FString& ProjectId,
+    const FString& IssueId,
+    const FString& ApiToken,
+    const FString& MediaEndpoint,
+    const FString& BlobSignedId,
+    const FString& CustomName,
+    const FOnUploadComplete& OnComplete)
+{
+    int32 UploadId;
+    FOnUploadComplete Finish = BeginUpload(OnComplete, FOnUploadStage(), UploadId);
+
+    const FString IssueUrl = FString::Printf(TEXT("%s/projects/%s/issues/%s"), *BaseUrl, *ProjectId, *IssueId);
+
+    // Deferred like a regular upload, so OnComplete is never called before the id is returned
+    AsyncTask(ENamedThreads::GameThread, [this, UploadId, IssueUrl, MediaEndpoint, ApiToken, BlobSignedId, CustomName, Finish]()
+    {
+        ConfirmUpload(
+            UploadId,
+            IssueUrl,
+            MediaEndpoint,
+            ApiToken,
+            BlobSignedId,
+            CustomName,
+            [Finish, BlobSignedId](bool bConfirmSuccess, const FString& ConfirmError)
+            {
+                FUploadResult Result;
+                Result.bSuccess = bConfirmSuccess;
+                Result.ErrorMessage = bConfirmSuccess ? TEXT("") : ConfirmError;
+                Result.BlobSignedId = BlobSignedId;
+                Finish.ExecuteIfBound(Result);
+            }
+        );
+    });
+
+    return UploadId;
+}
+
+BH_S3Uploader::FOnUploadComplete BH_S3Uploader::BeginUpload(const FOnUploadComplete& OnComplete, const FOnUploadStage& OnStage, int32& OutUploadId)
+{
+    const int32 UploadId = NextUploadId++;
+    OutUploadId = UploadId;
+
+    FActiveUpload& Upload = ActiveUploads.Add(UploadId);
+    Upload.OnComplete = OnComplete;
+    Upload.OnStage = OnStage;
+    Upload.bHoldConfirmation = false;
+
+    // Every path completes through this, so a cancelled upload does not report a second result
+    return FOnUploadComplete::CreateLambda([this, UploadId](const FUploadResult& Result)
+    {
+        FActiveUpload CompletedUpload;
+        if (ActiveUploads.RemoveAndCopyValue(UploadId, CompletedUpload))
+        {
+            CompletedUpload.OnComplete.ExecuteIfBound(Result);
+        }
+    });
+}
+
+void BH_S3Uploader::NotifyStage(int32 UploadId, EBH_UploadStage Stage, const FString& BlobSignedId)
+{
+    if (FActiveUpload* Upload = ActiveUploads.Find(UploadId))
+    {
+        Upload->OnStage.ExecuteIfBound(Stage, BlobSignedId);
+    }
+}
+
+void BH_S3Uploader::PrefetchChecksum(const FString& FilePath, const FString& ContentType)
+{
+    FScopeLock Lock(&ChecksumMutex);
+    if (!ChecksumFutures.Contains(FilePath))
+    {
+        ChecksumFutures.Add(FilePath, Async(EAsyncExecution::ThreadPool,
+            [FilePath, ContentType, Algorithm = ChecksumAlgorithm, bCompress = bCompressTextUploads]()
+            {
+                return PrepareFile(FilePath, ContentType, Algorithm, bCompress);
+            }));
+    }
+}
+
+void BH_S3Uploader::DiscardPreparedFile(const FString& FilePath)
+{
+    // The preparation finishes on its worker thread, only its result is dropped
+    FScopeLock Lock(&ChecksumMutex);
+    ChecksumFutures.Remove(FilePath);
+}
+
+TFuture<BH_S3Uploader::FPreparedFile> BH_S3Uploader::TakePreparedFile(const FString& FilePath, const FString& ContentType)
+{
+    FScopeLock Lock(&ChecksumMutex);
+
+    // Each prefetched file is used once, a later upload of the same path prepares the file again
+    if (ChecksumFutures.Contains(FilePath))
+    {
+        return ChecksumFutures.FindAndRemoveChecked(FilePath);
+    }
 
-    UE_LOG(LogBetaHub, Log, TEXT("Starting S3 upload for %s (size: %lld, checksum: %s)"),
-        *Filename, FileSize, *Checksum);
+    return Async(EAsyncExecution::ThreadPool,
+        [FilePath, ContentType, Algorithm = ChecksumAlgorithm, bCompress = bCompressTextUploads]()
+        {
+            return PrepareFile(FilePath, ContentType, Algorithm, bCompress);
+        });
+}
+
+void BH_S3Uploader::CacheBlob(int32 UploadId, const FString& CacheKey, const FString& BlobSignedId)
+{
+    // A held blob is not attached to the issue yet and may still be discarded with the report
+    const FActiveUpload* Upload = ActiveUploads.Find(UploadId);
+    if (Upload && !Upload->bHoldConfirmation)
+    {
+        BH_BlobCache::Get().Add(CacheKey, BlobSignedId);
+    }
+}
 
-    // Build presigned URL endpoint
-    FString PresignedEndpoint = FString::Printf(TEXT("%s/projects/%s/issues/%s/%s/presigned_upload"),
-        *BaseUrl, *ProjectId, *IssueId, *MediaEndpoint);
+void BH_S3Uploader::HoldConfirmation(int32 UploadId)
+{
+    if (FActiveUpload* Upload = ActiveUploads.Find(UploadId))
+    {
+        Upload->bHoldConfirmation = true;
+    }
+}
+
+void BH_S3Uploader::CancelUpload(int32 UploadId)
+{
+    FActiveUpload Upload;
+    if (!ActiveUploads.RemoveAndCopyValue(UploadId, Upload))
+    {
+        return;
+    }
+
+    // The requests' own completions are ignored, the upload is no longer active
+    for (const FHttpRequestPtr& Request : Upload.Requests)
+    {
+        Request->CancelRequest();
+    }
+
+    FUploadResult Result;
+    Result.bSuccess = false;
+    Result.ErrorMessage = TEXT("Upload cancelled by user");
+    Upload.OnComplete.ExecuteIfBound(Result);
+}
+
+bool BH_S3Uploader::TrackRequest(int32 UploadId, const FHttpRequestPtr& Request)
+{
+    FActiveUpload* Upload = ActiveUploads.Find(UploadId);
+    if (!Upload)
+    {
+        return false;
+    }
+
+    // Multipart uploads have several requests in flight, finished ones need no cancelling
+    Upload->Requests.RemoveAll([](const FHttpRequestPtr& TrackedRequest)
+    {
+        return EHttpRequestStatus::IsFinished(TrackedRequest->GetStatus());
+    });
+    Upload->Requests.Add(Request);
+    return true;
+}
+
+void BH_S3Uploader::UploadWithChecksum(
+    int32 UploadId,
+    const FString& BaseUrl,
+    const FString& ProjectId,
+    const FString& IssueId,
+    const FString& ApiToken,
+    const FString& MediaEndpoint,
+    const FString& Filename,
+    const FPreparedFile& Prepared,
+    int64 FileSize,
+    const FString& ContentType,
+    const FString& CustomName,
+    const FOnUploadComplete& OnComplete,
+    const FOnUploadProgress& OnProgress)
+{
+    UE_LOG(LogBetaHub, Log, TEXT("Starting S3 upload for %s (size: %lld%s%s, %s checksum: %s)"),
+        *Filename, FileSize, Prepared.ContentEncoding.IsEmpty() ? TEXT("") : TEXT(", gzip"), Prepared.Data.IsValid() ? TEXT(", from memory") : TEXT(""),
+        BH_Checksum::GetAlgorithmName(ChecksumAlgorithm), *Prepared.Checksum);
+
+    const FString CacheKey = BH_BlobCache::MakeKey(BaseUrl, ProjectId, MediaEndpoint,
+        BH_Checksum::GetAlgorithmName(ChecksumAlgorithm), Prepared.Checksum, FileSize, Prepared.ContentEncoding);
+
+    // Held uploads are confirmed later, when a rejected blob could no longer be replaced by uploading the file
+    const FActiveUpload* Upload = ActiveUploads.Find(UploadId);
+    const FString CachedBlobSignedId = Upload && !Upload->bHoldConfirmation ? BH_BlobCache::Get().Find(CacheKey) : FString();
+    if (!CachedBlobSignedId.IsEmpty())
+    {
+        UE_LOG(LogBetaHub, Log, TEXT("%s was uploaded with an earlier report, attaching the uploaded copy"), *Filename);
+
+        const FString IssueUrl = FString::Printf(TEXT("%s/projects/%s/issues/%s"), *BaseUrl, *ProjectId, *IssueId);
+        ConfirmUpload(
+            UploadId,
+            IssueUrl,
+            MediaEndpoint,
+            ApiToken,
+            CachedBlobSignedId,
+            CustomName,
+            [this, UploadId, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, Filename, Prepared, FileSize,
+                ContentType, CustomName, OnComplete, OnProgress, CacheKey, CachedBlobSignedId]
+            (bool bConfirmSuccess, const FString& ConfirmError)
+            {
+                if (bConfirmSuccess)
+                {
+                    FUploadResult Result;
+                    Result.bSuccess = true;
+                    Result.BlobSignedId = CachedBlobSignedId;
+                    OnComplete.ExecuteIfBound(Result);
+                    return;
+                }
+
+                // The blob may have been removed on the server, upload the file after all
+                BH_BlobCache::Get().Remove(CacheKey);
+                if (ActiveUploads.Contains(UploadId))
+                {
+                    UE_LOG(LogBetaHub, Warning, TEXT("Uploaded copy of %s was not accepted (%s), uploading it again"), *Filename, *ConfirmError);
+                    UploadWithChecksum(UploadId, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, Filename, Prepared, FileSize,
+                        ContentType, CustomName, OnComplete, OnProgress);
+                }
+            }
+        );
+        return;
+    }
+
+    // A request goes at line speed once the limiter lets it start, so while the rate is limited anything
+    // larger than a part is sent in parts of the smallest size S3 accepts, one at a time
+    const bool bThrottled = BH_BandwidthLimiter::Get().IsLimited() && FileSize > BH_MultipartUpload::MinPartSize;
+    if (bThrottled || (MultipartThresholdBytes > 0 && FileSize >= MultipartThresholdBytes))
+    {
+        BH_MultipartUpload::FSettings PartSettings = MultipartSettings;
+        if (bThrottled)
+        {
+            PartSettings.PartSize = BH_MultipartUpload::MinPartSize;
+            PartSettings.MaxConcurrentParts = 1;
+        }
+
+        UploadMultipart(UploadId, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, Prepared, FileSize,
+            ContentType, CustomName, CacheKey, PartSettings, OnComplete, OnProgress);
+        return;
+    }
+
+    const FString IssueUrl = FString::Printf(TEXT("%s/projects/%s/issues/%s"), *BaseUrl, *ProjectId, *IssueId);
 
     // Step 1: Request presigned URL
     RequestPresignedUrl(
-        PresignedEndpoint,
+        UploadId,
+        IssueUrl,
+        MediaEndpoint,
         ApiToken,
         Filename,
         FileSize,
-        Checksum,
+        Prepared.Checksum,
         ContentType,
-        [this, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, FileData, CustomName, OnComplete]
+        Prepared.ContentEncoding,
+        [this, UploadId, IssueUrl, ApiToken, MediaEndpoint, Prepared, FileSize, CustomName, OnComplete, OnProgress, CacheKey]
         (bool bSuccess, const FString& ErrorMsg, const FString& BlobSignedId, TSharedPtr<FJsonObject> PresignedData)
         {
             if (!bSuccess)
@@ -75,6 +457,8 @@ void BH_S3Uploader::UploadFileToS3(
                 return;
             }
 
+            NotifyStage(UploadId, EBH_UploadStage::Presigned, BlobSignedId);
+
             // Extract upload URL and headers
             FString UploadUrl;
             TSharedPtr<FJsonObject> Headers;
@@ -114,10 +498,13 @@ void BH_S3Uploader::UploadFileToS3(
 
             // Step 2: Upload to S3
             UploadToS3(
+                UploadId,
                 UploadUrl,
                 Headers,
-                FileData,
-                [this, BaseUrl, ProjectId, IssueId, ApiToken, MediaEndpoint, BlobSignedId, CustomName, OnComplete]
+                Prepared,
+                FileSize,
+                OnProgress,
+                [this, UploadId, IssueUrl, ApiToken, MediaEndpoint, BlobSignedId, CustomName, OnComplete, CacheKey]
                 (bool bS3Success, const FString& S3Error)
                 {
                     if (!bS3Success)
@@ -129,17 +516,23 @@ void BH_S3Uploader::UploadFileToS3(
                         return;
                     }
 
-                    // Step 3: Confirm upload
-                    FString ConfirmEndpoint = FString::Printf(TEXT("%s/projects/%s/issues/%s/%s/confirm_upload"),
-                        *BaseUrl, *ProjectId, *IssueId, *MediaEndpoint);
+                    NotifyStage(UploadId, EBH_UploadStage::Uploaded, BlobSignedId);
 
+                    // Step 3: Confirm upload
                     ConfirmUpload(
-                        ConfirmEndpoint,
+                        UploadId,
+                        IssueUrl,
+                        MediaEndpoint,
                         ApiToken,
                         BlobSignedId,
                         CustomName,
-                        [OnComplete, BlobSignedId](bool bConfirmSuccess, const FString& ConfirmError)
+                        [this, UploadId, OnComplete, BlobSignedId, CacheKey](bool bConfirmSuccess, const FString& ConfirmError)
                         {
+                            if (bConfirmSuccess)
+                            {
+                                CacheBlob(UploadId, CacheKey, BlobSignedId);
+                            }
+
                             FUploadResult Result;
                             Result.bSuccess = bConfirmSuccess;
                             Result.ErrorMessage = bConfirmSuccess ? TEXT("") : ConfirmError;
@@ -153,80 +546,149 @@ void BH_S3Uploader::UploadFileToS3(
     );
 }
 
+void BH_S3Uploader::UploadMultipart(
+    int32 UploadId,
+    const FString& BaseUrl,
+    const FString& ProjectId,
+    const FString& IssueId,
+    const FString& ApiToken,
+    const FString& MediaEndpoint,
+    const FPreparedFile& Prepared,
+    int64 FileSize,
+    const FString& ContentType,
+    const FString& CustomName,
+    const FString& CacheKey,
+    const BH_MultipartUpload::FSettings& PartSettings,
+    const FOnUploadComplete& OnComplete,
+    const FOnUploadProgress& OnProgress)
+{
+    const FString IssueUrl = FString::Printf(TEXT("%s/projects/%s/issues/%s"), *BaseUrl, *ProjectId, *IssueId);
+    const FString EndpointBase = IssueUrl / MediaEndpoint;
+
+    TSharedRef<BH_MultipartUpload> Multipart = MakeShared<BH_MultipartUpload>(
+        EndpointBase,
+        ApiToken,
+        Prepared.FilePath,
+        Prepared.Data,
+        FileSize,
+        Prepared.Checksum,
+        ChecksumAlgorithm == EBH_ChecksumAlgorithm::MD5 ? FString() : FString(BH_Checksum::GetAlgorithmName(ChecksumAlgorithm)),
+        ContentType,
+        Prepared.ContentEncoding,
+        PartSettings
+    );
+
+    Multipart->Start(
+        [this, UploadId](const FHttpRequestPtr& Request)
+        {
+            return TrackRequest(UploadId, Request);
+        },
+        [OnProgress](int64 BytesSent, int64 TotalBytes)
+        {
+            OnProgress.ExecuteIfBound(BytesSent, TotalBytes);
+        },
+        [this, UploadId, IssueUrl, MediaEndpoint, ApiToken, CustomName, CacheKey, OnComplete](bool bSuccess, const FString& Error, const FString& BlobSignedId)
+        {
+            if (!bSuccess)
+            {
+                FUploadResult Result;
+                Result.bSuccess = false;
+                Result.ErrorMessage = FString::Printf(TEXT("Multipart upload failed: %s"), *Error);
+                OnComplete.ExecuteIfBound(Result);
+                return;
+            }
+
+            NotifyStage(UploadId, EBH_UploadStage::Uploaded, BlobSignedId);
+
+            // The blob exists now, attach it like a single-part upload
+            ConfirmUpload(
+                UploadId,
+                IssueUrl,
+                MediaEndpoint,
+                ApiToken,
+                BlobSignedId,
+                CustomName,
+                [this, UploadId, OnComplete, BlobSignedId, CacheKey](bool bConfirmSuccess, const FString& ConfirmError)
+                {
+                    if (bConfirmSuccess)
+                    {
+                        CacheBlob(UploadId, CacheKey, BlobSignedId);
+                    }
+
+                    FUploadResult Result;
+                    Result.bSuccess = bConfirmSuccess;
+                    Result.ErrorMessage = bConfirmSuccess ? TEXT("") : ConfirmError;
+                    Result.BlobSignedId = BlobSignedId;
+                    OnComplete.ExecuteIfBound(Result);
+                }
+            );
+        }
+    );
+}
+
 void BH_S3Uploader::RequestPresignedUrl(
-    const FString& Endpoint,
+    int32 UploadId,
+    const FString& IssueUrl,
+    const FString& MediaEndpoint,
     const FString& ApiToken,
     const FString& Filename,
     int64 FileSize,
     const FString& Checksum,
     const FString& ContentType,
+    const FString& ContentEncoding,
     TFunction<void(bool, const FString&, const FString&, TSharedPtr<FJsonObject>)> OnComplete)
 {
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(Endpoint);
-    Request->SetVerb(TEXT("POST"));
-    Request->SetHeader(TEXT("Accept"), TEXT("application/json"));
-    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
-    Request->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *ApiToken));
-
     // Build JSON request body
     TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
     JsonObject->SetStringField(TEXT("filename"), Filename);
     JsonObject->SetNumberField(TEXT("byte_size"), FileSize);
     JsonObject->SetStringField(TEXT("checksum"), Checksum);
+    if (ChecksumAlgorithm != EBH_ChecksumAlgorithm::MD5)
+    {
+        // MD5 is the default, the field is only sent when the server needs to know otherwise
+        JsonObject->SetStringField(TEXT("checksum_algorithm"), BH_Checksum::GetAlgorithmName(ChecksumAlgorithm));
+    }
     JsonObject->SetStringField(TEXT("content_type"), ContentType);
+    if (!ContentEncoding.IsEmpty())
+    {
+        JsonObject->SetStringField(TEXT("content_encoding"), ContentEncoding);
+    }
 
-    FString JsonString;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
-    FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
-    Request->SetContentAsString(JsonString);
-
-    Request->OnProcessRequestComplete().BindLambda(
-        [OnComplete](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
+    BH_UploadBatcher::FCall Call;
+    Call.MediaEndpoint = MediaEndpoint;
+    Call.Body = JsonObject;
+    Call.TrackRequest = [this, UploadId](const FHttpRequestPtr& Request)
+    {
+        return TrackRequest(UploadId, Request);
+    };
+    Call.OnComplete = [OnComplete](bool bSuccess, const FString& Error, const TSharedPtr<FJsonObject>& JsonResponse)
+    {
+        if (!bSuccess)
         {
-            if (!bWasSuccessful || !HttpResponse.IsValid())
-            {
-                OnComplete(false, TEXT("Network request failed"), TEXT(""), nullptr);
-                return;
-            }
-
-            int32 ResponseCode = HttpResponse->GetResponseCode();
-            if (ResponseCode != 200 && ResponseCode != 201)
-            {
-                FString ErrorMsg = FString::Printf(TEXT("HTTP %d: %s"),
-                    ResponseCode, *HttpResponse->GetContentAsString());
-                OnComplete(false, ErrorMsg, TEXT(""), nullptr);
-                return;
-            }
-
-            // Parse response
-            TSharedPtr<FJsonObject> JsonResponse;
-            TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(HttpResponse->GetContentAsString());
-            if (!FJsonSerializer::Deserialize(Reader, JsonResponse) || !JsonResponse.IsValid())
-            {
-                OnComplete(false, TEXT("Invalid JSON response"), TEXT(""), nullptr);
-                return;
-            }
-
-            FString BlobSignedId;
-            if (!JsonResponse->TryGetStringField(TEXT("blob_signed_id"), BlobSignedId))
-            {
-                OnComplete(false, TEXT("Missing blob_signed_id in response"), TEXT(""), nullptr);
-                return;
-            }
+            OnComplete(false, Error, TEXT(""), nullptr);
+            return;
+        }
 
-            OnComplete(true, TEXT(""), BlobSignedId, JsonResponse);
+        FString BlobSignedId;
+        if (!JsonResponse->TryGetStringField(TEXT("blob_signed_id"), BlobSignedId))
+        {
+            OnComplete(false, TEXT("Missing blob_signed_id in response"), TEXT(""), nullptr);
+            return;
         }
-    );
 
-    Request->SetTimeout(30.0f); // 30 seconds for API call
-    Request->ProcessRequest();
+        OnComplete(true, TEXT(""), BlobSignedId, JsonResponse);
+    };
+
+    Batcher.Add(EBH_BatchCall::Presign, IssueUrl, ApiToken, MoveTemp(Call));
 }
 
 void BH_S3Uploader::UploadToS3(
+    int32 UploadId,
     const FString& UploadUrl,
     const TSharedPtr<FJsonObject>& Headers,
-    const TArray<uint8>& FileData,
+    const FPreparedFile& Prepared,
+    int64 FileSize,
+    const FOnUploadProgress& OnProgress,
     TFunction<void(bool, const FString&)> OnComplete)
 {
     TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
@@ -247,8 +709,50 @@ void BH_S3Uploader::UploadToS3(
         }
     }
 
-    // Set file data as content
-    Request->SetContent(FileData);
+    // Stored with the object, so the file is decompressed transparently when it is downloaded
+    if (!Prepared.ContentEncoding.IsEmpty() && Request->GetHeader(TEXT("Content-Encoding")).IsEmpty())
+    {
+        Request->SetHeader(TEXT("Content-Encoding"), Prepared.ContentEncoding);
+    }
+
+    // Content in memory (logs, bundles) is sent from memory, files are streamed from disk
+    if (Prepared.Data.IsValid())
+    {
+        Request->SetContent(*Prepared.Data);
+    }
+    else
+    {
+        TSharedRef<FBH_FileRangeArchive, ESPMode::ThreadSafe> Body =
+            MakeShared<FBH_FileRangeArchive, ESPMode::ThreadSafe>(Prepared.FilePath, 0, FileSize);
+        if (!Body->IsValid())
+        {
+            OnComplete(false, FString::Printf(TEXT("Failed to open file for streaming: %s"), *Prepared.FilePath));
+            return;
+        }
+        Request->SetContentFromStream(Body);
+    }
+
+    // The bytes actually sent drive the limiter's adaptive rate
+    TSharedRef<int64> ReportedBytes = MakeShared<int64>(0);
+#if ENGINE_MINOR_VERSION >= 4
+    Request->OnRequestProgress64().BindLambda(
+        [OnProgress, FileSize, ReportedBytes](FHttpRequestPtr HttpRequest, uint64 BytesSent, uint64 BytesReceived)
+        {
+            BH_BandwidthLimiter::Get().AddSentBytes((int64)BytesSent - *ReportedBytes);
+            *ReportedBytes = (int64)BytesSent;
+            OnProgress.ExecuteIfBound((int64)BytesSent, FileSize);
+        }
+    );
+#else
+    Request->OnRequestProgress().BindLambda(
+        [OnProgress, FileSize, ReportedBytes](FHttpRequestPtr HttpRequest, int32 BytesSent, int32 BytesReceived)
+        {
+            BH_BandwidthLimiter::Get().AddSentBytes((int64)(uint32)BytesSent - *ReportedBytes);
+            *ReportedBytes = (int64)(uint32)BytesSent;
+            OnProgress.ExecuteIfBound((int64)(uint32)BytesSent, FileSize);
+        }
+    );
+#endif
 
     Request->OnProcessRequestComplete().BindLambda(
         [OnComplete](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
@@ -275,22 +779,35 @@ void BH_S3Uploader::UploadToS3(
 
     // Set generous timeout for large file uploads (5 minutes)
     Request->SetTimeout(300.0f);
-    Request->ProcessRequest();
+
+    // Paced per request, the body is then read at full speed on the HTTP thread. It is at most a part
+    // while the rate is limited, larger files are sent as a multipart upload.
+    BH_BandwidthLimiter::Get().WhenAvailable(FileSize, [this, UploadId, Request]()
+    {
+        // Not tracked if the upload was cancelled while waiting
+        if (TrackRequest(UploadId, Request))
+        {
+            Request->ProcessRequest();
+        }
+    });
 }
 
 void BH_S3Uploader::ConfirmUpload(
-    const FString& Endpoint,
+    int32 UploadId,
+    const FString& IssueUrl,
+    const FString& MediaEndpoint,
     const FString& ApiToken,
     const FString& BlobSignedId,
     const FString& CustomName,
     TFunction<void(bool, const FString&)> OnComplete)
 {
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->SetURL(Endpoint);
-    Request->SetVerb(TEXT("POST"));
-    Request->SetHeader(TEXT("Accept"), TEXT("application/json"));
-    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
-    Request->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *ApiToken));
+    const FActiveUpload* Upload = ActiveUploads.Find(UploadId);
+    if (Upload && Upload->bHoldConfirmation)
+    {
+        UE_LOG(LogBetaHub, Log, TEXT("File uploaded, its confirmation is held until the report is submitted"));
+        OnComplete(true, TEXT(""));
+        return;
+    }
 
     // Build JSON request body
     TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
@@ -302,50 +819,194 @@ void BH_S3Uploader::ConfirmUpload(
         JsonObject->SetStringField(TEXT("name"), CustomName);
     }
 
-    FString JsonString;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
-    FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
-    Request->SetContentAsString(JsonString);
-
-    Request->OnProcessRequestComplete().BindLambda(
-        [OnComplete](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
+    BH_UploadBatcher::FCall Call;
+    Call.MediaEndpoint = MediaEndpoint;
+    Call.Body = JsonObject;
+    Call.TrackRequest = [this, UploadId](const FHttpRequestPtr& Request)
+    {
+        return TrackRequest(UploadId, Request);
+    };
+    Call.OnComplete = [OnComplete](bool bSuccess, const FString& Error, const TSharedPtr<FJsonObject>& JsonResponse)
+    {
+        if (!bSuccess)
         {
-            if (!bWasSuccessful || !HttpResponse.IsValid())
-            {
-                OnComplete(false, TEXT("Confirm upload network request failed"));
-                return;
-            }
+            OnComplete(false, FString::Printf(TEXT("Confirm failed: %s"), *Error));
+            return;
+        }
 
-            int32 ResponseCode = HttpResponse->GetResponseCode();
-            if (ResponseCode != 200 && ResponseCode != 201)
-            {
-                FString ErrorMsg = FString::Printf(TEXT("Confirm failed with HTTP %d: %s"),
-                    ResponseCode, *HttpResponse->GetContentAsString());
-                OnComplete(false, ErrorMsg);
-                return;
-            }
+        UE_LOG(LogBetaHub, Log, TEXT("Upload confirmation successful"));
+        OnComplete(true, TEXT(""));
+    };
 
-            UE_LOG(LogBetaHub, Log, TEXT("Upload confirmation successful"));
-            OnComplete(true, TEXT(""));
-        }
-    );
+    Batcher.Add(EBH_BatchCall::Confirm, IssueUrl, ApiToken, MoveTemp(Call));
+}
+
+BH_S3Uploader::FPreparedFile BH_S3Uploader::PrepareFile(const FString& FilePath, const FString& ContentType, EBH_ChecksumAlgorithm Algorithm, bool bCompressText)
+{
+    // Logs are compressed and uploaded from memory, larger text files are streamed uncompressed
+    const int64 MaxCompressedInputBytes = 64 * 1024 * 1024;
+
+    FPreparedFile Prepared;
+    Prepared.FilePath = FilePath;
+
+    const int64 FileSize = IFileManager::Get().FileSize(*FilePath);
+    TArray<uint8> Uncompressed;
+    TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> Compressed = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+
+    if (bCompressText && IsTextContentType(ContentType) && FileSize > 0 && FileSize <= MaxCompressedInputBytes
+        && FFileHelper::LoadFileToArray(Uncompressed, *FilePath, FILEREAD_Silent)
+        && CompressText(Uncompressed, *Compressed))
+    {
+        UE_LOG(LogBetaHub, Log, TEXT("Compressed %s from %lld to %d bytes"), *FPaths::GetCleanFilename(FilePath), FileSize, Compressed->Num());
+
+        BH_Checksum Hasher(Algorithm);
+        Hasher.Update(Compressed->GetData(), Compressed->Num());
 
-    Request->SetTimeout(30.0f); // 30 seconds for API call
-    Request->ProcessRequest();
+        Prepared.Data = Compressed;
+        Prepared.Checksum = Hasher.FinalizeBase64();
+        Prepared.ContentEncoding = TEXT("gzip");
+        return Prepared;
+    }
+
+    if (Uncompressed.Num() > 0)
+    {
+        // Already loaded for compressing
+        BH_Checksum Hasher(Algorithm);
+        Hasher.Update(Uncompressed.GetData(), Uncompressed.Num());
+        Prepared.Checksum = Hasher.FinalizeBase64();
+        return Prepared;
+    }
+
+    Prepared.Checksum = CalculateChecksum(FilePath, Algorithm);
+    return Prepared;
 }
 
-FString BH_S3Uploader::CalculateMD5Checksum(const TArray<uint8>& FileData)
+BH_S3Uploader::FPreparedFile BH_S3Uploader::PrepareData(
+    const TSharedRef<TArray<uint8>, ESPMode::ThreadSafe>& Data,
+    const FString& ContentType,
+    EBH_ChecksumAlgorithm Algorithm,
+    bool bCompressText)
 {
-    // Calculate MD5 hash
-    FMD5 Md5Gen;
-    Md5Gen.Update(FileData.GetData(), FileData.Num());
+    FPreparedFile Prepared;
+    Prepared.Data = Data;
 
-    uint8 Digest[16];
-    Md5Gen.Final(Digest);
+    TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> Compressed = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+    if (bCompressText && IsTextContentType(ContentType) && CompressText(*Data, *Compressed))
+    {
+        Prepared.Data = Compressed;
+        Prepared.ContentEncoding = TEXT("gzip");
+    }
+
+    BH_Checksum Hasher(Algorithm);
+    Hasher.Update(Prepared.Data->GetData(), Prepared.Data->Num());
+    Prepared.Checksum = Hasher.FinalizeBase64();
+    return Prepared;
+}
+
+bool BH_S3Uploader::IsTextContentType(const FString& ContentType)
+{
+    return ContentType.StartsWith(TEXT("text/"))
+        || ContentType == TEXT("application/json")
+        || ContentType == TEXT("application/xml");
+}
+
+bool BH_S3Uploader::CompressText(const TArray<uint8>& Uncompressed, TArray<uint8>& OutCompressed)
+{
+    if (Uncompressed.Num() == 0)
+    {
+        return false;
+    }
+
+    int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Gzip, Uncompressed.Num());
+    OutCompressed.SetNumUninitialized(CompressedSize);
+    if (!FCompression::CompressMemory(NAME_Gzip, OutCompressed.GetData(), CompressedSize, Uncompressed.GetData(), Uncompressed.Num(), COMPRESS_BiasSize))
+    {
+        UE_LOG(LogBetaHub, Warning, TEXT("Failed to compress %d bytes, uploading them uncompressed"), Uncompressed.Num());
+        return false;
+    }
+    OutCompressed.SetNum(CompressedSize, false);
+
+    // Not worth an encoding the server has to know about
+    return CompressedSize < Uncompressed.Num();
+}
+
+FString BH_S3Uploader::CalculateChecksum(const FString& FilePath, EBH_ChecksumAlgorithm Algorithm)
+{
+    const int64 ChunkSize = 4 * 1024 * 1024;
+    const uint32 Alignment = 4096;
+
+    TUniquePtr<IAsyncReadFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenAsyncRead(*FilePath));
+    if (!Handle)
+    {
+        return FString();
+    }
+
+    TUniquePtr<IAsyncReadRequest> SizeRequest(Handle->SizeRequest());
+    if (!SizeRequest)
+    {
+        return FString();
+    }
+    SizeRequest->WaitCompletion();
+    const int64 FileSize = SizeRequest->GetSizeResults();
+    SizeRequest.Reset();
+
+    if (FileSize < 0)
+    {
+        return FString();
+    }
+
+    // Two aligned buffers: the next chunk is read while the current one is hashed
+    uint8* Buffers[2] = {
+        (uint8*)FMemory::Malloc(ChunkSize, Alignment),
+        (uint8*)FMemory::Malloc(ChunkSize, Alignment)
+    };
+
+    auto StartRead = [&Handle, &Buffers, FileSize, ChunkSize](int64 Offset, int32 BufferIndex) -> IAsyncReadRequest*
+    {
+        const int64 BytesToRead = FMath::Min(ChunkSize, FileSize - Offset);
+        return Handle->ReadRequest(Offset, BytesToRead, AIOP_BelowNormal, nullptr, Buffers[BufferIndex]);
+    };
+
+    BH_Checksum Hasher(Algorithm);
+    bool bReadFailed = false;
+
+    int64 Offset = 0;
+    int32 BufferIndex = 0;
+    TUniquePtr<IAsyncReadRequest> PendingRead(FileSize > 0 ? StartRead(0, 0) : nullptr);
+
+    while (PendingRead)
+    {
+        PendingRead->WaitCompletion();
+        if (!PendingRead->GetReadResults())
+        {
+            bReadFailed = true;
+            PendingRead.Reset();
+            break;
+        }
+        PendingRead.Reset();
+
+        const int64 BytesRead = FMath::Min(ChunkSize, FileSize - Offset);
+        const int64 NextOffset = Offset + BytesRead;
+        if (NextOffset < FileSize)
+        {
+            PendingRead.Reset(StartRead(NextOffset, 1 - BufferIndex));
+        }
+
+        Hasher.Update(Buffers[BufferIndex], BytesRead);
+
+        Offset = NextOffset;
+        BufferIndex = 1 - BufferIndex;
+    }
+
+    FMemory::Free(Buffers[0]);
+    FMemory::Free(Buffers[1]);
+
+    if (bReadFailed)
+    {
+        return FString();
+    }
 
-    // Convert to Base64
-    FString Base64String = FBase64::Encode(Digest, 16);
-    return Base64String;
+    return Hasher.FinalizeBase64();
 }
 
 TSharedPtr<FJsonObject> BH_S3Uploader::ParseJsonResponse(const FString& ResponseContent)
@@ -5,6 +5,21 @@
 #include "HttpModule.h"
 #include "Interfaces/IHttpRequest.h"
 #include "Dom/JsonObject.h"
+#include "Async/Future.h"
+#include "HAL/CriticalSection.h"
+#include "BH_MediaTypes.h"
+#include "BH_MultipartUpload.h"
+#include "BH_UploadBatcher.h"
+#include "BH_ReportBundle.h"
+
+/**
+ * Milestones of an upload that can be resumed from, reported before the upload completes
+ */
+enum class EBH_UploadStage : uint8
+{
+    Presigned,      // The blob exists on BetaHub, the file is not uploaded yet
+    Uploaded        // The file is in S3, only the confirmation is missing
+};
 
 /**
  * Handles S3 direct upload operations for BetaHub media files
@@ -31,6 +46,16 @@ public:
      */
     DECLARE_DELEGATE_OneParam(FOnUploadComplete, const FUploadResult&);
 
+    /**
+     * Callback delegate for byte-level progress of the S3 upload
+     */
+    DECLARE_DELEGATE_TwoParams(FOnUploadProgress, int64 /* BytesSent */, int64 /* TotalBytes */);
+
+    /**
+     * Callback delegate for upload milestones, with the blob of the upload
+     */
+    DECLARE_DELEGATE_TwoParams(FOnUploadStage, EBH_UploadStage /* Stage */, const FString& /* BlobSignedId */);
+
     /**
      * Main upload function that orchestrates the 3-step S3 upload process
      *
@@ -43,8 +68,11 @@ public:
      * @param ContentType       MIME type of the file
      * @param CustomName        Optional custom display name for the file
      * @param OnComplete        Callback when upload completes
+     * @param OnProgress        Optional callback with the number of bytes sent to S3 so far
+     * @param OnStage           Optional callback when the upload reaches a milestone it can be resumed from
+     * @return                  Id of the upload for CancelUpload. OnComplete is never called before this returns.
      */
-    void UploadFileToS3(
+    int32 UploadFileToS3(
         const FString& BaseUrl,
         const FString& ProjectId,
         const FString& IssueId,
@@ -53,38 +81,254 @@ public:
         const FString& FilePath,
         const FString& ContentType,
         const FString& CustomName,
+        const FOnUploadComplete& OnComplete,
+        const FOnUploadProgress& OnProgress = FOnUploadProgress(),
+        const FOnUploadStage& OnStage = FOnUploadStage()
+    );
+
+    /**
+     * Uploads content that is already in memory (e.g. captured logs) without writing it to disk.
+     * Works like UploadFileToS3, the data is only read and must not be modified until OnComplete.
+     *
+     * @param Data              Bytes to upload
+     * @param Filename          File name reported to BetaHub, e.g. "log.log"
+     * @return                  Id of the upload for CancelUpload. OnComplete is never called before this returns.
+     */
+    int32 UploadDataToS3(
+        const FString& BaseUrl,
+        const FString& ProjectId,
+        const FString& IssueId,
+        const FString& ApiToken,
+        const FString& MediaEndpoint,
+        const TSharedRef<TArray<uint8>, ESPMode::ThreadSafe>& Data,
+        const FString& Filename,
+        const FString& ContentType,
+        const FString& CustomName,
+        const FOnUploadComplete& OnComplete,
+        const FOnUploadProgress& OnProgress = FOnUploadProgress(),
+        const FOnUploadStage& OnStage = FOnUploadStage()
+    );
+
+    /**
+     * Packs small files into one archive on a worker thread (see BH_ReportBundle) and uploads it
+     * to the issue's bundles, where BetaHub expands it into the issue's attachments.
+     *
+     * @param Entries           Files to pack, content in memory must not be modified until OnComplete
+     * @return                  Id of the upload for CancelUpload. OnComplete is never called before this returns.
+     */
+    int32 UploadBundleToS3(
+        const FString& BaseUrl,
+        const FString& ProjectId,
+        const FString& IssueId,
+        const FString& ApiToken,
+        const TArray<BH_ReportBundle::FEntry>& Entries,
+        const FOnUploadComplete& OnComplete,
+        const FOnUploadProgress& OnProgress = FOnUploadProgress()
+    );
+
+    /**
+     * Confirms a file that was uploaded to S3 earlier (EBH_UploadStage::Uploaded) without uploading it again
+     *
+     * @param BlobSignedId      Blob reported with the Uploaded stage
+     * @return                  Id of the upload for CancelUpload. OnComplete is never called before this returns.
+     */
+    int32 ConfirmExistingUpload(
+        const FString& BaseUrl,
+        const FString& ProjectId,
+        const FString& IssueId,
+        const FString& ApiToken,
+        const FString& MediaEndpoint,
+        const FString& BlobSignedId,
+        const FString& CustomName,
         const FOnUploadComplete& OnComplete
     );
 
+    /**
+     * Starts computing the checksum of a file on a worker thread (compressing it first if it is a text file),
+     * so a later upload of it does not wait for it. Does nothing if the file is already being prepared.
+     *
+     * @param FilePath          Path to the file that will be uploaded next
+     * @param ContentType       MIME type the file will be uploaded with
+     */
+    void PrefetchChecksum(const FString& FilePath, const FString& ContentType);
+
+    /**
+     * Drops the prefetched checksum of a file that will not be uploaded, e.g. one of a cancelled upload
+     *
+     * @param FilePath          Path given to PrefetchChecksum
+     */
+    void DiscardPreparedFile(const FString& FilePath);
+
+    /**
+     * Stops an upload once the file is in S3: it completes successfully with its blob, after the Uploaded stage,
+     * and is attached to the issue later with ConfirmExistingUpload. Call it right after starting the upload.
+     *
+     * @param UploadId          Id returned by UploadFileToS3 or UploadDataToS3
+     */
+    void HoldConfirmation(int32 UploadId);
+
+    /**
+     * Aborts the in-flight HTTP request of an upload and completes it with an error right away.
+     * Does nothing if the upload has already completed.
+     *
+     * @param UploadId          Id returned by UploadFileToS3
+     */
+    void CancelUpload(int32 UploadId);
+
 private:
     /**
-     * Step 1: Request presigned URL from BetaHub
+     * Registers a new upload, the returned callback must be used to complete it
+     */
+    FOnUploadComplete BeginUpload(const FOnUploadComplete& OnComplete, const FOnUploadStage& OnStage, int32& OutUploadId);
+
+    void NotifyStage(int32 UploadId, EBH_UploadStage Stage, const FString& BlobSignedId);
+
+    /**
+     * Adds a request to the ones aborted by CancelUpload
+     *
+     * @return                  False if the upload was cancelled and the request must not be sent
+     */
+    bool TrackRequest(int32 UploadId, const FHttpRequestPtr& Request);
+
+    /**
+     * Remembers the blob of a confirmed upload, so identical files are not uploaded again
+     */
+    void CacheBlob(int32 UploadId, const FString& CacheKey, const FString& BlobSignedId);
+
+    /**
+     * What is actually uploaded: the file, or bytes in memory such as a gzip-compressed text file
+     */
+    struct FPreparedFile
+    {
+        FString FilePath;
+        TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> Data;    // Uploaded instead of FilePath when set
+        FString Checksum;
+        FString ContentEncoding;    // "gzip" for compressed content, empty otherwise
+    };
+
+    /**
+     * Returns the prefetched file, or starts preparing it, and removes it from the prefetch cache
+     */
+    TFuture<FPreparedFile> TakePreparedFile(const FString& FilePath, const FString& ContentType);
+
+    /**
+     * Compresses text files and computes the checksum of what will be uploaded.
+     * Blocks until done, only call it from a worker thread.
+     */
+    static FPreparedFile PrepareFile(const FString& FilePath, const FString& ContentType, EBH_ChecksumAlgorithm Algorithm, bool bCompressText);
+
+    /**
+     * Compresses text in memory and computes the checksum of what will be uploaded.
+     * Blocks until done, only call it from a worker thread.
+     */
+    static FPreparedFile PrepareData(
+        const TSharedRef<TArray<uint8>, ESPMode::ThreadSafe>& Data,
+        const FString& ContentType,
+        EBH_ChecksumAlgorithm Algorithm,
+        bool bCompressText
+    );
+
+    static bool IsTextContentType(const FString& ContentType);
+
+    /**
+     * @return              False if the compression fails or the data does not get smaller
+     */
+    static bool CompressText(const TArray<uint8>& Uncompressed, TArray<uint8>& OutCompressed);
+
+    /**
+     * Starts the upload once its content is prepared, on the game thread
+     */
+    void OnFilePrepared(
+        int32 UploadId,
+        const FString& BaseUrl,
+        const FString& ProjectId,
+        const FString& IssueId,
+        const FString& ApiToken,
+        const FString& MediaEndpoint,
+        const FString& Filename,
+        const FPreparedFile& Prepared,
+        const FString& ContentType,
+        const FString& CustomName,
+        const FOnUploadComplete& OnComplete,
+        const FOnUploadProgress& OnProgress
+    );
+
+    /**
+     * Runs the 3-step upload once the checksum is known, or only confirms the blob of an identical
+     * file uploaded earlier (see BH_BlobCache)
+     */
+    void UploadWithChecksum(
+        int32 UploadId,
+        const FString& BaseUrl,
+        const FString& ProjectId,
+        const FString& IssueId,
+        const FString& ApiToken,
+        const FString& MediaEndpoint,
+        const FString& Filename,
+        const FPreparedFile& Prepared,
+        int64 FileSize,
+        const FString& ContentType,
+        const FString& CustomName,
+        const FOnUploadComplete& OnComplete,
+        const FOnUploadProgress& OnProgress
+    );
+
+    /**
+     * Uploads a large file with BH_MultipartUpload and confirms it
+     */
+    void UploadMultipart(
+        int32 UploadId,
+        const FString& BaseUrl,
+        const FString& ProjectId,
+        const FString& IssueId,
+        const FString& ApiToken,
+        const FString& MediaEndpoint,
+        const FPreparedFile& Prepared,
+        int64 FileSize,
+        const FString& ContentType,
+        const FString& CustomName,
+        const FString& CacheKey,
+        const BH_MultipartUpload::FSettings& PartSettings,
+        const FOnUploadComplete& OnComplete,
+        const FOnUploadProgress& OnProgress
+    );
+
+    /**
+     * Step 1: Request presigned URL from BetaHub, batched with the other files of the issue
      */
     void RequestPresignedUrl(
-        const FString& Endpoint,
+        int32 UploadId,
+        const FString& IssueUrl,
+        const FString& MediaEndpoint,
         const FString& ApiToken,
         const FString& Filename,
         int64 FileSize,
         const FString& Checksum,
         const FString& ContentType,
+        const FString& ContentEncoding,
         TFunction<void(bool, const FString&, const FString&, TSharedPtr<FJsonObject>)> OnComplete
     );
 
     /**
-     * Step 2: Upload file directly to S3
+     * Step 2: Upload file directly to S3, streaming the body from disk (or sending it from memory)
      */
     void UploadToS3(
+        int32 UploadId,
         const FString& UploadUrl,
         const TSharedPtr<FJsonObject>& Headers,
-        const TArray<uint8>& FileData,
+        const FPreparedFile& Prepared,
+        int64 FileSize,
+        const FOnUploadProgress& OnProgress,
         TFunction<void(bool, const FString&)> OnComplete
     );
 
     /**
-     * Step 3: Confirm upload completion with BetaHub
+     * Step 3: Confirm upload completion with BetaHub, batched with the other files of the issue
      */
     void ConfirmUpload(
-        const FString& Endpoint,
+        int32 UploadId,
+        const FString& IssueUrl,
+        const FString& MediaEndpoint,
         const FString& ApiToken,
         const FString& BlobSignedId,
         const FString& CustomName,
@@ -92,15 +336,45 @@ private:
     );
 
     /**
-     * Calculate MD5 checksum for a file
+     * Calculate the checksum of a file with double-buffered, aligned async reads.
+     * Blocks until done, only call it from a worker thread.
      *
-     * @param FileData      File content as byte array
-     * @return              Base64-encoded MD5 checksum
+     * @param FilePath      Path to the file
+     * @param Algorithm     Checksum algorithm
+     * @return              Base64-encoded checksum, empty if the file cannot be read
      */
-    FString CalculateMD5Checksum(const TArray<uint8>& FileData);
+    static FString CalculateChecksum(const FString& FilePath, EBH_ChecksumAlgorithm Algorithm);
 
     /**
      * Helper to parse JSON response
      */
     TSharedPtr<FJsonObject> ParseJsonResponse(const FString& ResponseContent);
+
+    // Uploads that have not completed yet
+    struct FActiveUpload
+    {
+        TArray<FHttpRequestPtr> Requests;
+        FOnUploadComplete OnComplete;
+        FOnUploadStage OnStage;
+        bool bHoldConfirmation;     // Completes without confirming, see HoldConfirmation
+    };
+    TMap<int32, FActiveUpload> ActiveUploads;
+    int32 NextUploadId;
+
+    // Presign and confirm calls of the same issue are sent together
+    BH_UploadBatcher Batcher;
+
+    // Read from the plugin settings once, so a prefetched checksum always matches the presign request
+    EBH_ChecksumAlgorithm ChecksumAlgorithm;
+
+    // Text files (logs) are uploaded gzip-compressed with Content-Encoding: gzip
+    bool bCompressTextUploads;
+
+    // Files of at least this size are uploaded in parts, 0 disables multipart uploads
+    int64 MultipartThresholdBytes;
+    BH_MultipartUpload::FSettings MultipartSettings;
+
+    // Files being prepared ahead of their upload, keyed by file path
+    TMap<FString, TFuture<FPreparedFile>> ChecksumFutures;
+    FCriticalSection ChecksumMutex;
 };
\ No newline at end of file
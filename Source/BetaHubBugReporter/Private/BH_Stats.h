@@ -11,3 +11,6 @@ DECLARE_CYCLE_STAT(TEXT("ReadPixels"), STAT_BetaHub_ReadPixels, STATGROUP_BetaHu
 DECLARE_CYCLE_STAT(TEXT("CopyBackBuffer"), STAT_BetaHub_CopyBackBuffer, STATGROUP_BetaHub);
 DECLARE_CYCLE_STAT(TEXT("ProcessFrame"), STAT_BetaHub_ProcessFrame, STATGROUP_BetaHub);
 DECLARE_CYCLE_STAT(TEXT("SetFrameData"), STAT_BetaHub_SetFrameData, STATGROUP_BetaHub);
+
+// Share of the whole machine's CPU time used by the ffmpeg encoder process, sampled once per second
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Encoder CPU %"), STAT_BetaHub_EncoderCpuPercent, STATGROUP_BetaHub);
@@ -0,0 +1,237 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "BH_StorageManager.h"
+#include "BH_Log.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+int64 BH_StorageManager::BudgetBytes = 0;
+int64 BH_StorageManager::MinFreeBytes = 0;
+FString BH_StorageManager::SegmentsDirOverride;
+
+void BH_StorageManager::Configure(int64 InBudgetBytes, int64 InMinFreeBytes, const FString& InSegmentsDirOverride)
+{
+    BudgetBytes = FMath::Max<int64>(InBudgetBytes, 0);
+    MinFreeBytes = FMath::Max<int64>(InMinFreeBytes, 0);
+    SegmentsDirOverride = InSegmentsDirOverride;
+
+    if (!SegmentsDirOverride.IsEmpty())
+    {
+        IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+        if (!PlatformFile.DirectoryExists(*SegmentsDirOverride) && !PlatformFile.CreateDirectoryTree(*SegmentsDirOverride))
+        {
+            UE_LOG(LogBetaHub, Warning, TEXT("Cannot use %s for video segments, falling back to the default directory."), *SegmentsDirOverride);
+            SegmentsDirOverride.Empty();
+        }
+    }
+
+    UE_LOG(LogBetaHub, Log, TEXT("Storage budget: %lld MB, minimum free space: %lld MB, segments directory: %s"),
+        BudgetBytes / (1024 * 1024), MinFreeBytes / (1024 * 1024), *GetSegmentsDir());
+}
+
+FString BH_StorageManager::GetSegmentsDir()
+{
+    if (!SegmentsDirOverride.IsEmpty())
+    {
+        return SegmentsDirOverride;
+    }
+
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("BH_VideoSegments"));
+}
+
+FString BH_StorageManager::GetExportsDir()
+{
+    return FPaths::ProjectSavedDir();
+}
+
+FString BH_StorageManager::GetTempDir()
+{
+    return FPaths::ProjectSavedDir() / TEXT("BetaHub") / TEXT("Temp");
+}
+
+FString BH_StorageManager::GetUploadStateDir()
+{
+    return FPaths::ProjectSavedDir() / TEXT("BetaHub") / TEXT("Uploads");
+}
+
+FString BH_StorageManager::GetJournalDir()
+{
+    return FPaths::ProjectSavedDir() / TEXT("BetaHub") / TEXT("Journal");
+}
+
+const TArray<FString>& BH_StorageManager::GetSegmentPatterns()
+{
+    static const TArray<FString> Patterns = { TEXT("*.mp4"), TEXT("*.mkv") };
+    return Patterns;
+}
+
+const TArray<FString>& BH_StorageManager::GetExportPatterns()
+{
+    static const TArray<FString> Patterns = {
+        TEXT("Gameplay_*.mp4"), TEXT("Gameplay_*.mkv"), TEXT("GameplayProxy_*.mp4")
+    };
+    return Patterns;
+}
+
+int64 BH_StorageManager::GetUsedBytes()
+{
+    return GetDirectorySize(GetSegmentsDir(), GetSegmentPatterns())
+        + GetDirectorySize(GetExportsDir(), GetExportPatterns())
+        + GetDirectorySize(GetTempDir(), { TEXT("*") })
+        + GetDirectoryTreeSize(GetJournalDir());
+}
+
+EBH_StorageLevel BH_StorageManager::GetStorageLevel()
+{
+    EBH_StorageLevel Level = EBH_StorageLevel::Normal;
+
+    if (BudgetBytes > 0)
+    {
+        const int64 UsedBytes = GetUsedBytes();
+
+        if (UsedBytes >= BudgetBytes)
+        {
+            Level = EBH_StorageLevel::Exhausted;
+        }
+        else if (UsedBytes >= BudgetBytes * 8 / 10)
+        {
+            Level = EBH_StorageLevel::ReducedResolution;
+        }
+        else if (UsedBytes >= BudgetBytes * 6 / 10)
+        {
+            Level = EBH_StorageLevel::ReducedBitrate;
+        }
+    }
+
+    if (MinFreeBytes > 0)
+    {
+        // Segments may live on a different volume than the exports
+        const int64 FreeBytes = FMath::Min(GetFreeDiskBytes(GetSegmentsDir()), GetFreeDiskBytes(GetExportsDir()));
+
+        EBH_StorageLevel DiskLevel = EBH_StorageLevel::Normal;
+        if (FreeBytes < MinFreeBytes / 4)
+        {
+            DiskLevel = EBH_StorageLevel::Exhausted;
+        }
+        else if (FreeBytes < MinFreeBytes / 2)
+        {
+            DiskLevel = EBH_StorageLevel::ReducedResolution;
+        }
+        else if (FreeBytes < MinFreeBytes)
+        {
+            DiskLevel = EBH_StorageLevel::ReducedBitrate;
+        }
+
+        Level = FMath::Max(Level, DiskLevel);
+    }
+
+    return Level;
+}
+
+void BH_StorageManager::RemoveStaleFiles()
+{
+    // Segments of other sessions may still be in use by another instance of the game
+    RemoveFilesOlderThan(GetSegmentsDir(), GetSegmentPatterns(), FTimespan::FromHours(24));
+
+    // Exports and temp files are deleted as soon as they are uploaded, anything older is left over from a crash
+    RemoveFilesOlderThan(GetExportsDir(), GetExportPatterns(), FTimespan::FromHours(1));
+    RemoveFilesOlderThan(GetTempDir(), { TEXT("*") }, FTimespan::FromHours(1));
+
+    // Servers abort incomplete multipart uploads after a few days, their resume state is useless by then
+    RemoveFilesOlderThan(GetUploadStateDir(), { TEXT("*.json") }, FTimespan::FromDays(7));
+}
+
+bool BH_StorageManager::SaveStringToFileAtomic(const FString& Contents, const FString& Path)
+{
+    const FString TempPath = Path + TEXT(".tmp");
+    if (!FFileHelper::SaveStringToFile(Contents, *TempPath) || !IFileManager::Get().Move(*Path, *TempPath, true))
+    {
+        UE_LOG(LogBetaHub, Warning, TEXT("Failed to write %s"), *Path);
+        IFileManager::Get().Delete(*TempPath, false, false, true);
+        return false;
+    }
+    return true;
+}
+
+int64 BH_StorageManager::GetDirectorySize(const FString& Directory, const TArray<FString>& Patterns)
+{
+    IFileManager& FileManager = IFileManager::Get();
+    int64 TotalSize = 0;
+
+    for (const FString& Pattern : Patterns)
+    {
+        TArray<FString> Files;
+        FileManager.FindFiles(Files, *(Directory / Pattern), true, false);
+
+        for (const FString& File : Files)
+        {
+            const int64 FileSize = FileManager.FileSize(*(Directory / File));
+            if (FileSize > 0)
+            {
+                TotalSize += FileSize;
+            }
+        }
+    }
+
+    return TotalSize;
+}
+
+int64 BH_StorageManager::GetDirectoryTreeSize(const FString& Directory)
+{
+    IFileManager& FileManager = IFileManager::Get();
+    int64 TotalSize = 0;
+
+    TArray<FString> Files;
+    FileManager.FindFilesRecursive(Files, *Directory, TEXT("*"), true, false);
+
+    for (const FString& File : Files)
+    {
+        // FindFilesRecursive returns full paths
+        const int64 FileSize = FileManager.FileSize(*File);
+        if (FileSize > 0)
+        {
+            TotalSize += FileSize;
+        }
+    }
+
+    return TotalSize;
+}
+
+int64 BH_StorageManager::GetFreeDiskBytes(const FString& Directory)
+{
+    uint64 TotalBytes = 0;
+    uint64 FreeBytes = 0;
+
+    if (!FPlatformMisc::GetDiskTotalAndFreeSpace(FPaths::ConvertRelativePathToFull(Directory), TotalBytes, FreeBytes))
+    {
+        // Unknown, do not degrade because of it
+        return MAX_int64;
+    }
+
+    return (int64)FMath::Min<uint64>(FreeBytes, (uint64)MAX_int64);
+}
+
+void BH_StorageManager::RemoveFilesOlderThan(const FString& Directory, const TArray<FString>& Patterns, const FTimespan& MaxAge)
+{
+    IFileManager& FileManager = IFileManager::Get();
+    const FDateTime CurrentTime = FDateTime::UtcNow();
+
+    for (const FString& Pattern : Patterns)
+    {
+        TArray<FString> Files;
+        FileManager.FindFiles(Files, *(Directory / Pattern), true, false);
+
+        for (const FString& File : Files)
+        {
+            FString FilePath = FPaths::Combine(Directory, File);
+            FFileStatData StatData = FileManager.GetStatData(*FilePath);
+            if (StatData.bIsValid && (CurrentTime - StatData.ModificationTime) > MaxAge)
+            {
+                UE_LOG(LogBetaHub, Log, TEXT("Removing old file: %s"), *FilePath);
+                FileManager.Delete(*FilePath);
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#pragma once
+
+#include "CoreMinimal.h"
+
+// How much the recorder has to cut back to stay within the storage budget, from least to most severe
+enum class EBH_StorageLevel : uint8
+{
+    Normal,
+    ReducedBitrate,
+    ReducedResolution,
+    Exhausted
+};
+
+/**
+ * Keeps everything the plugin writes to disk (video segments, exported clips, temporary
+ * upload files and reports waiting to be uploaded) within a byte budget, and makes sure a minimum of free disk space is left.
+ */
+class BH_StorageManager
+{
+public:
+    /**
+     * @param InBudgetBytes             Maximum bytes used by segments, exports, temp files and journaled reports together, 0 for no limit
+     * @param InMinFreeBytes            Free disk space the recorder must always leave, 0 for no limit
+     * @param InSegmentsDirOverride     Directory for the video segments (e.g. a RAM disk), empty for the default
+     */
+    static void Configure(int64 InBudgetBytes, int64 InMinFreeBytes, const FString& InSegmentsDirOverride);
+
+    static FString GetSegmentsDir();
+    static FString GetExportsDir();
+    static FString GetTempDir();
+
+    // Resume state of interrupted uploads
+    static FString GetUploadStateDir();
+
+    // Submitted reports that are not fully uploaded yet, with their files
+    static FString GetJournalDir();
+
+    // Bytes currently used by segments, exports, temp files and journaled reports
+    static int64 GetUsedBytes();
+
+    // The most severe level required by either the budget or the free disk space
+    static EBH_StorageLevel GetStorageLevel();
+
+    // Deletes segments, exports and temp files left over by sessions that did not clean up after themselves
+    static void RemoveStaleFiles();
+
+    // Writes a file through a temp file next to it, so a crash mid-write leaves the previous contents intact.
+    // Logs a warning and returns false on failure.
+    static bool SaveStringToFileAtomic(const FString& Contents, const FString& Path);
+
+private:
+    static int64 BudgetBytes;
+    static int64 MinFreeBytes;
+    static FString SegmentsDirOverride;
+
+    static int64 GetDirectorySize(const FString& Directory, const TArray<FString>& Patterns);
+    static int64 GetDirectoryTreeSize(const FString& Directory);
+    static int64 GetFreeDiskBytes(const FString& Directory);
+    static void RemoveFilesOlderThan(const FString& Directory, const TArray<FString>& Patterns, const FTimespan& MaxAge);
+
+    static const TArray<FString>& GetSegmentPatterns();
+    static const TArray<FString>& GetExportPatterns();
+};
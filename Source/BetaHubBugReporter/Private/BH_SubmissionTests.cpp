@@ -0,0 +1,331 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && BH_WITH_MOCK_SERVER
+
+#include "BH_MockServer.h"
+#include "BH_BugReport.h"
+#include "BH_PluginSettings.h"
+#include "BH_StorageManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+
+namespace
+{
+    // Not the default port of BetaHub.MockServer.Start, the tests restart the server with their own conditions
+    const uint32 TestMockPort = 8788;
+
+    const double TestTimeoutSeconds = 60.0;
+
+    // An enum class from UE 5.5, the type is left to the compiler
+    const auto TestFlags = EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+        | EAutomationTestFlags::ProductFilter;
+
+    /**
+     * One submission to the mock server: starts the server, keeps the report and its settings alive until the
+     * test is done, then stops the server and deletes the test's files
+     */
+    class FBH_MockSubmission : public TSharedFromThis<FBH_MockSubmission>
+    {
+    public:
+        explicit FBH_MockSubmission(FAutomationTestBase* InTest)
+            : Test(InTest)
+            , Settings(nullptr)
+            , BugReport(nullptr)
+            , StartTime(0.0)
+            , bDone(false)
+            , bSucceeded(false)
+        {
+        }
+
+        bool Start()
+        {
+            // No simulated latency or failures, the tests check what is sent, not how long it takes
+            BH_MockServer::FConditions Conditions;
+            Conditions.LatencySeconds = 0.0f;
+            if (!BH_MockServer::Get().Start(TestMockPort, Conditions))
+            {
+                Test->AddError(FString::Printf(TEXT("Cannot start the mock server on port %u"), TestMockPort));
+                return false;
+            }
+
+            // Everything is uploaded before publishing, so a report makes one sequence of calls
+            Settings = BH_MockServer::Get().CreateSettings();
+            Settings->bUploadVideoAfterPublishing = false;
+            Settings->AddToRoot();
+
+            BugReport = NewObject<UBH_BugReport>();
+            BugReport->AddToRoot();
+
+            StartTime = FPlatformTime::Seconds();
+            return true;
+        }
+
+        void Finish()
+        {
+            BH_MockServer::Get().Stop();
+
+            Settings->RemoveFromRoot();
+            BugReport->RemoveFromRoot();
+
+            for (const FString& Path : Files)
+            {
+                IFileManager::Get().Delete(*Path, false, false, true);
+            }
+            Files.Empty();
+        }
+
+        TFunction<void()> OnSuccess()
+        {
+            TSharedRef<FBH_MockSubmission> This = AsShared();
+            return [This]()
+            {
+                This->bDone = true;
+                This->bSucceeded = true;
+            };
+        }
+
+        TFunction<void(const FString&)> OnFailure()
+        {
+            TSharedRef<FBH_MockSubmission> This = AsShared();
+            return [This](const FString& Error)
+            {
+                This->Test->AddError(FString::Printf(TEXT("Submission failed: %s"), *Error));
+                This->bDone = true;
+            };
+        }
+
+        /**
+         * True once the submission ended, or timed out
+         */
+        bool IsDone()
+        {
+            if (!bDone && FPlatformTime::Seconds() - StartTime > TestTimeoutSeconds)
+            {
+                Test->AddError(TEXT("Submission timed out"));
+                bDone = true;
+            }
+            return bDone;
+        }
+
+        bool Succeeded() const
+        {
+            return bSucceeded;
+        }
+
+        /**
+         * Random content, so uploads cached by earlier runs are not reused
+         */
+        FString WriteRandomFile(const TCHAR* Extension, int64 Size)
+        {
+            TArray<uint8> Data;
+            Data.SetNumUninitialized(Size);
+            for (int64 Index = 0; Index + 4 <= Size; Index += 4)
+            {
+                const int32 Value = FMath::Rand();
+                FMemory::Memcpy(&Data[Index], &Value, 4);
+            }
+
+            const FString Path = BH_StorageManager::GetTempDir() / FString::Printf(TEXT("test_%s.%s"),
+                *FGuid::NewGuid().ToString(EGuidFormats::Digits), Extension);
+            FFileHelper::SaveArrayToFile(Data, *Path);
+            Files.Add(Path);
+            return Path;
+        }
+
+        /**
+         * Index of the first call after StartIndex containing Text, INDEX_NONE if there is none
+         */
+        int32 FindCall(const TCHAR* Text, int32 StartIndex = 0) const
+        {
+            const TArray<FString>& Calls = BH_MockServer::Get().GetStats().Calls;
+            for (int32 Index = StartIndex; Index < Calls.Num(); ++Index)
+            {
+                if (Calls[Index].Contains(Text))
+                {
+                    return Index;
+                }
+            }
+            return INDEX_NONE;
+        }
+
+        /**
+         * Checks that the calls were made in this order, other calls may come in between
+         *
+         * @return              Index of the last call, INDEX_NONE if one is missing
+         */
+        int32 TestCallOrder(std::initializer_list<const TCHAR*> ExpectedCalls) const
+        {
+            int32 Index = INDEX_NONE;
+            for (const TCHAR* ExpectedCall : ExpectedCalls)
+            {
+                Index = FindCall(ExpectedCall, Index + 1);
+                if (Index == INDEX_NONE)
+                {
+                    Test->AddError(FString::Printf(TEXT("No \"%s\" in its place, the server received:\n%s"), ExpectedCall,
+                        *FString::Join(BH_MockServer::Get().GetStats().Calls, TEXT("\n"))));
+                    break;
+                }
+            }
+            return Index;
+        }
+
+        FAutomationTestBase* Test;
+        UBH_PluginSettings* Settings;
+        UBH_BugReport* BugReport;
+
+    private:
+        double StartTime;
+        bool bDone;
+        bool bSucceeded;
+        TArray<FString> Files;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBH_BugReportSubmissionTest, "BetaHub.Submission.BugReport", TestFlags)
+
+bool FBH_BugReportSubmissionTest::RunTest(const FString& Parameters)
+{
+    TSharedRef<FBH_MockSubmission> Submission = MakeShared<FBH_MockSubmission>(this);
+    if (!Submission->Start())
+    {
+        return false;
+    }
+
+    TArray<FBH_MediaFile> Screenshots;
+    Screenshots.Add(FBH_MediaFile(Submission->WriteRandomFile(TEXT("png"), 256 * 1024), TEXT("Screenshot")));
+
+    TArray<FBH_MediaFile> Logs;
+    FBH_MediaFile Log;
+    Log.Content = FString::Printf(TEXT("Test run %s\n"), *FGuid::NewGuid().ToString());
+    Log.Name = TEXT("Game.log");
+    Logs.Add(Log);
+
+    Submission->BugReport->SubmitReportWithMedia(Submission->Settings, nullptr, TEXT("Submission test"), TEXT("Run BetaHub.Submission.BugReport"),
+        TArray<FBH_MediaFile>(), Screenshots, Logs, Submission->OnSuccess(), Submission->OnFailure());
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Submission]()
+    {
+        if (!Submission->IsDone())
+        {
+            return false;
+        }
+
+        if (Submission->Succeeded())
+        {
+            // Draft, then each file presigned, put to S3 and confirmed, and only then published
+            const int32 PublishIndex = Submission->TestCallOrder({
+                TEXT("POST issues.json"), TEXT("presigned_upload"), TEXT("PUT s3"), TEXT("confirm_upload"), TEXT("/publish") });
+            if (PublishIndex != INDEX_NONE)
+            {
+                TestEqual(TEXT("Uploads after publishing"), Submission->FindCall(TEXT("PUT s3"), PublishIndex), (int32)INDEX_NONE);
+                TestEqual(TEXT("Confirmations after publishing"), Submission->FindCall(TEXT("confirm_upload"), PublishIndex), (int32)INDEX_NONE);
+            }
+            TestEqual(TEXT("Issues published"), BH_MockServer::Get().GetStats().IssuesPublished, 1);
+        }
+
+        Submission->Finish();
+        return true;
+    }));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBH_MultipartSubmissionTest, "BetaHub.Submission.Multipart", TestFlags)
+
+bool FBH_MultipartSubmissionTest::RunTest(const FString& Parameters)
+{
+    // The uploader takes the threshold from the project's settings when it is created
+    const UBH_PluginSettings* ProjectSettings = GetDefault<UBH_PluginSettings>();
+    if (ProjectSettings->MultipartUploadThresholdMB <= 0)
+    {
+        AddInfo(TEXT("Multipart uploads are disabled in the project settings"));
+        return true;
+    }
+
+    TSharedRef<FBH_MockSubmission> Submission = MakeShared<FBH_MockSubmission>(this);
+    if (!Submission->Start())
+    {
+        return false;
+    }
+
+    // Over the threshold by a part, so the file is sent in at least two parts
+    const int64 VideoBytes = ((int64)ProjectSettings->MultipartUploadThresholdMB + ProjectSettings->MultipartPartSizeMB) * 1024 * 1024;
+
+    TArray<FBH_MediaFile> Videos;
+    Videos.Add(FBH_MediaFile(Submission->WriteRandomFile(TEXT("mp4"), VideoBytes), TEXT("Gameplay")));
+
+    Submission->BugReport->SubmitReportWithMedia(Submission->Settings, nullptr, TEXT("Multipart submission test"), TEXT("Run BetaHub.Submission.Multipart"),
+        Videos, TArray<FBH_MediaFile>(), TArray<FBH_MediaFile>(), Submission->OnSuccess(), Submission->OnFailure());
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Submission]()
+    {
+        if (!Submission->IsDone())
+        {
+            return false;
+        }
+
+        if (Submission->Succeeded())
+        {
+            // The parts are put to S3 and assembled before the video is confirmed and the report published
+            Submission->TestCallOrder({ TEXT("POST issues.json"), TEXT("presigned_multipart_upload"), TEXT("PUT s3"), TEXT("PUT s3"),
+                TEXT("complete_multipart_upload"), TEXT("confirm_upload"), TEXT("/publish") });
+        }
+
+        Submission->Finish();
+        return true;
+    }));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBH_DuplicateReportSubmissionTest, "BetaHub.Submission.DuplicateReport", TestFlags)
+
+bool FBH_DuplicateReportSubmissionTest::RunTest(const FString& Parameters)
+{
+    TSharedRef<FBH_MockSubmission> Submission = MakeShared<FBH_MockSubmission>(this);
+    if (!Submission->Start())
+    {
+        return false;
+    }
+
+    FBH_ReportSignature Signature;
+    Signature.Hash = FGuid::NewGuid().ToString(EGuidFormats::Digits);
+    Signature.Problems.Add(TEXT("Error: LogTemp: Test problem"));
+    BH_MockServer::Get().AddOpenIssue(Signature.Hash, TEXT("42"));
+
+    // The issue found by its signature gets the report as an occurrence instead of a new draft
+    UBH_BugReport::FindDuplicateIssue(Submission->Settings, Signature, [this, Submission](const FString& IssueId, const FString& IssueTitle)
+    {
+        if (!TestEqual(TEXT("Duplicate issue"), IssueId, FString(TEXT("42"))))
+        {
+            Submission->OnFailure()(TEXT("No duplicate issue found"));
+            return;
+        }
+
+        Submission->BugReport->SubmitDuplicateReport(Submission->Settings, IssueId, TEXT("Duplicate submission test"),
+            TEXT("Run BetaHub.Submission.DuplicateReport"), FString(), Submission->OnSuccess(), Submission->OnFailure());
+    });
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Submission]()
+    {
+        if (!Submission->IsDone())
+        {
+            return false;
+        }
+
+        if (Submission->Succeeded())
+        {
+            Submission->TestCallOrder({ TEXT("POST issues/find_by_signature.json"), TEXT("POST issues/g-42/occurrences.json") });
+            TestEqual(TEXT("Drafts created"), Submission->FindCall(TEXT("POST issues.json")), (int32)INDEX_NONE);
+        }
+
+        Submission->Finish();
+        return true;
+    }));
+
+    return true;
+}
+
+#endif
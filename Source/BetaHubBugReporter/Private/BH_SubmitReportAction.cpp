@@ -0,0 +1,117 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "BH_SubmitReportAction.h"
+#include "BH_BugReport.h"
+#include "BH_BackgroundService.h"
+#include "BH_GameInstanceSubsystem.h"
+#include "BH_Manager.h"
+#include "BH_PluginSettings.h"
+#include "BH_StorageManager.h"
+#include "BH_Log.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+UBH_SubmitReportAction* UBH_SubmitReportAction::SubmitBugReport(
+    UObject* WorldContextObject,
+    const FString& Description,
+    const FString& StepsToReproduce,
+    bool bIncludeVideo,
+    bool bIncludeScreenshot,
+    bool bIncludeLogs)
+{
+    UBH_SubmitReportAction* Action = NewObject<UBH_SubmitReportAction>();
+    Action->WorldContext = WorldContextObject;
+    Action->Description = Description;
+    Action->StepsToReproduce = StepsToReproduce;
+    Action->bIncludeVideo = bIncludeVideo;
+    Action->bIncludeScreenshot = bIncludeScreenshot;
+    Action->bIncludeLogs = bIncludeLogs;
+    Action->RegisterWithGameInstance(WorldContextObject);
+    return Action;
+}
+
+void UBH_SubmitReportAction::Activate()
+{
+    UBH_PluginSettings* Settings = GetMutableDefault<UBH_PluginSettings>();
+
+    // The media comes from the background service, the report is sent without it if the service is not running
+    UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContext.Get(), EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+    UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+    UBH_GameInstanceSubsystem* Subsystem = GameInstance ? GameInstance->GetSubsystem<UBH_GameInstanceSubsystem>() : nullptr;
+    UBH_Manager* Manager = Subsystem ? Subsystem->GetManager() : nullptr;
+    UBH_BackgroundService* BackgroundService = Manager ? Manager->GetBackgroundService() : nullptr;
+
+    UBH_GameRecorder* GameRecorder = BackgroundService ? BackgroundService->GetGameRecorder() : nullptr;
+    if (!BackgroundService)
+    {
+        UE_LOG(LogBetaHub, Warning, TEXT("BetaHub background service is not running, the report is submitted without video, screenshot and logs"));
+    }
+
+    BugReport = NewObject<UBH_BugReport>(this);
+
+    // Encoded on a worker thread while the draft issue is created
+    if (bIncludeScreenshot && GameRecorder)
+    {
+        const FString ScreenshotPath = BH_StorageManager::GetTempDir() / FString::Printf(TEXT("Screenshot_%s.jpg"),
+            *FGuid::NewGuid().ToString(EGuidFormats::Digits));
+        BugReport->AddPendingScreenshot(GameRecorder->CaptureScreenshotToJPGAsync(ScreenshotPath));
+    }
+
+    TArray<FBH_MediaFile> Logs;
+    if (bIncludeLogs && BackgroundService)
+    {
+        // Formatted on a worker thread when the report is staged
+        FBH_MediaFile Log;
+        Log.LogSnapshot = BackgroundService->GetReportLogSnapshot();
+        if (Log.LogSnapshot.IsValid() && !Log.LogSnapshot->IsEmpty())
+        {
+            Logs.Add(Log);
+        }
+    }
+
+    TWeakObjectPtr<UBH_SubmitReportAction> WeakThis = this;
+    BugReport->SubmitReportWithMedia(
+        Settings,
+        bIncludeVideo ? GameRecorder : nullptr,
+        Description,
+        StepsToReproduce,
+        TArray<FBH_MediaFile>(),
+        TArray<FBH_MediaFile>(),
+        Logs,
+        [WeakThis]()
+        {
+            if (WeakThis.IsValid())
+            {
+                WeakThis->Finish(true, FString());
+            }
+        },
+        [WeakThis](const FString& Error)
+        {
+            if (WeakThis.IsValid())
+            {
+                WeakThis->Finish(false, Error);
+            }
+        }
+    );
+}
+
+void UBH_SubmitReportAction::Cancel()
+{
+    if (BugReport)
+    {
+        BugReport->CancelSubmission();
+    }
+}
+
+void UBH_SubmitReportAction::Finish(bool bSuccess, const FString& Error)
+{
+    if (bSuccess)
+    {
+        OnSuccess.Broadcast(Error);
+    }
+    else
+    {
+        OnFailure.Broadcast(Error);
+    }
+    SetReadyToDestroy();
+}
@@ -0,0 +1,292 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "BH_UploadBatcher.h"
+#include "BH_Log.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+BH_UploadBatcher::BH_UploadBatcher(bool bInEnabled)
+    : bEnabled(bInEnabled)
+    , bBatchEndpointsMissing(false)
+{
+}
+
+BH_UploadBatcher::~BH_UploadBatcher()
+{
+    if (FlushHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(FlushHandle);
+    }
+}
+
+void BH_UploadBatcher::Add(EBH_BatchCall Kind, const FString& IssueUrl, const FString& ApiToken, FCall&& Call)
+{
+    check(IsInGameThread());
+
+    if (!bEnabled || bBatchEndpointsMissing)
+    {
+        SendSingle(FString(), Kind, IssueUrl, ApiToken, MoveTemp(Call));
+        return;
+    }
+
+    const FString QueueKey = FString::Printf(TEXT("%s|%s|%s"), GetBatchEndpoint(Kind), *IssueUrl, *ApiToken);
+
+    FQueue* Queue = Queues.Find(QueueKey);
+    if (!Queue)
+    {
+        Queue = &Queues.Add(QueueKey);
+        Queue->Kind = Kind;
+        Queue->IssueUrl = IssueUrl;
+        Queue->ApiToken = ApiToken;
+        Queue->RequestsInFlight = 0;
+    }
+    Queue->Calls.Add(MoveTemp(Call));
+
+    // A queue with a request in flight is sent when the request completes
+    if (Queue->RequestsInFlight == 0 && !FlushHandle.IsValid())
+    {
+        FlushHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &BH_UploadBatcher::FlushQueues));
+    }
+}
+
+bool BH_UploadBatcher::FlushQueues(float DeltaTime)
+{
+    FlushHandle.Reset();
+
+    TArray<FString> QueueKeys;
+    Queues.GenerateKeyArray(QueueKeys);
+    for (const FString& QueueKey : QueueKeys)
+    {
+        const FQueue* Queue = Queues.Find(QueueKey);
+        if (Queue && Queue->RequestsInFlight == 0)
+        {
+            FlushQueue(QueueKey);
+        }
+    }
+
+    return false;
+}
+
+void BH_UploadBatcher::FlushQueue(const FString& QueueKey)
+{
+    FQueue* Queue = Queues.Find(QueueKey);
+    if (!Queue)
+    {
+        return;
+    }
+
+    if (Queue->Calls.Num() == 0)
+    {
+        if (Queue->RequestsInFlight == 0)
+        {
+            Queues.Remove(QueueKey);
+        }
+        return;
+    }
+
+    TArray<FCall> Calls = MoveTemp(Queue->Calls);
+    Queue->Calls.Reset();
+
+    if (Calls.Num() > 1 && !bBatchEndpointsMissing)
+    {
+        SendBatch(QueueKey, MoveTemp(Calls));
+        return;
+    }
+
+    const EBH_BatchCall Kind = Queue->Kind;
+    const FString IssueUrl = Queue->IssueUrl;
+    const FString ApiToken = Queue->ApiToken;
+    for (FCall& Call : Calls)
+    {
+        SendSingle(QueueKey, Kind, IssueUrl, ApiToken, MoveTemp(Call));
+    }
+}
+
+void BH_UploadBatcher::SendSingle(const FString& QueueKey, EBH_BatchCall Kind, const FString& IssueUrl, const FString& ApiToken, FCall&& Call)
+{
+    const FString Url = FString::Printf(TEXT("%s/%s/%s"), *IssueUrl, *Call.MediaEndpoint, GetSingleEndpoint(Kind));
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = CreateApiRequest(Url, ApiToken, Call.Body.ToSharedRef());
+
+    FOnCallComplete OnComplete = MoveTemp(Call.OnComplete);
+    Request->OnProcessRequestComplete().BindLambda(
+        [this, QueueKey, OnComplete](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
+        {
+            const FString Error = GetResponseError(HttpResponse, bWasSuccessful);
+            if (Error.IsEmpty())
+            {
+                // Confirmations may have no body, the caller checks the fields it needs
+                TSharedPtr<FJsonObject> Response;
+                TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(HttpResponse->GetContentAsString());
+                if (!FJsonSerializer::Deserialize(Reader, Response) || !Response.IsValid())
+                {
+                    Response = MakeShared<FJsonObject>();
+                }
+                OnComplete(true, FString(), Response);
+            }
+            else
+            {
+                OnComplete(false, Error, nullptr);
+            }
+
+            OnRequestDone(QueueKey);
+        }
+    );
+
+    if (Call.TrackRequest && !Call.TrackRequest(Request))
+    {
+        return;
+    }
+
+    if (FQueue* Queue = Queues.Find(QueueKey))
+    {
+        Queue->RequestsInFlight++;
+    }
+    Request->ProcessRequest();
+}
+
+void BH_UploadBatcher::SendBatch(const FString& QueueKey, TArray<FCall>&& Calls)
+{
+    FQueue& Queue = Queues.FindChecked(QueueKey);
+    const EBH_BatchCall Kind = Queue.Kind;
+    const FString IssueUrl = Queue.IssueUrl;
+    const FString ApiToken = Queue.ApiToken;
+
+    TArray<TSharedPtr<FJsonValue>> Uploads;
+    for (const FCall& Call : Calls)
+    {
+        TSharedRef<FJsonObject> Upload = MakeShared<FJsonObject>();
+        Upload->Values = Call.Body->Values;
+        Upload->SetStringField(TEXT("media_type"), Call.MediaEndpoint);
+        Uploads.Add(MakeShared<FJsonValueObject>(Upload));
+    }
+
+    TSharedRef<FJsonObject> Body = MakeShared<FJsonObject>();
+    Body->SetArrayField(TEXT("uploads"), Uploads);
+
+    UE_LOG(LogBetaHub, Log, TEXT("Sending %d %s calls in one request"), Calls.Num(), GetSingleEndpoint(Kind));
+
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = CreateApiRequest(IssueUrl / GetBatchEndpoint(Kind), ApiToken, Body);
+    Request->OnProcessRequestComplete().BindLambda(
+        [this, QueueKey, Kind, IssueUrl, ApiToken, Calls](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
+        {
+            const int32 ResponseCode = HttpResponse.IsValid() ? HttpResponse->GetResponseCode() : 0;
+            if (bWasSuccessful && (ResponseCode == 404 || ResponseCode == 405))
+            {
+                UE_LOG(LogBetaHub, Log, TEXT("The server does not support batch upload calls, files are presigned and confirmed one by one"));
+                bBatchEndpointsMissing = true;
+
+                for (FCall Call : Calls)
+                {
+                    SendSingle(QueueKey, Kind, IssueUrl, ApiToken, MoveTemp(Call));
+                }
+                OnRequestDone(QueueKey);
+                return;
+            }
+
+            FString Error = GetResponseError(HttpResponse, bWasSuccessful);
+
+            const TArray<TSharedPtr<FJsonValue>>* Results = nullptr;
+            TSharedPtr<FJsonObject> Response;
+            if (Error.IsEmpty())
+            {
+                TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(HttpResponse->GetContentAsString());
+                if (!FJsonSerializer::Deserialize(Reader, Response) || !Response.IsValid()
+                    || !Response->TryGetArrayField(TEXT("uploads"), Results) || Results->Num() != Calls.Num())
+                {
+                    Error = TEXT("Invalid batch response");
+                }
+            }
+
+            for (int32 Index = 0; Index < Calls.Num(); ++Index)
+            {
+                if (!Error.IsEmpty())
+                {
+                    Calls[Index].OnComplete(false, Error, nullptr);
+                    continue;
+                }
+
+                const TSharedPtr<FJsonObject>* Result = nullptr;
+                FString CallError;
+                if (!(*Results)[Index].IsValid() || !(*Results)[Index]->TryGetObject(Result))
+                {
+                    Calls[Index].OnComplete(false, TEXT("Invalid batch response"), nullptr);
+                }
+                else if ((*Result)->TryGetStringField(TEXT("error"), CallError))
+                {
+                    Calls[Index].OnComplete(false, CallError, nullptr);
+                }
+                else
+                {
+                    Calls[Index].OnComplete(true, FString(), *Result);
+                }
+            }
+
+            OnRequestDone(QueueKey);
+        }
+    );
+
+    Queue.RequestsInFlight++;
+    Request->ProcessRequest();
+}
+
+void BH_UploadBatcher::OnRequestDone(const FString& QueueKey)
+{
+    FQueue* Queue = Queues.Find(QueueKey);
+    if (!Queue)
+    {
+        return;
+    }
+
+    Queue->RequestsInFlight--;
+
+    // Once batching is off nothing waits for a request to complete
+    if (Queue->RequestsInFlight == 0 || bBatchEndpointsMissing)
+    {
+        FlushQueue(QueueKey);
+    }
+}
+
+TSharedRef<IHttpRequest, ESPMode::ThreadSafe> BH_UploadBatcher::CreateApiRequest(const FString& Url, const FString& ApiToken, const TSharedRef<FJsonObject>& Body)
+{
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    Request->SetURL(Url);
+    Request->SetVerb(TEXT("POST"));
+    Request->SetHeader(TEXT("Accept"), TEXT("application/json"));
+    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+    Request->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *ApiToken));
+
+    FString JsonString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+    FJsonSerializer::Serialize(Body, Writer);
+    Request->SetContentAsString(JsonString);
+
+    Request->SetTimeout(30.0f); // 30 seconds for API call
+    return Request;
+}
+
+FString BH_UploadBatcher::GetResponseError(FHttpResponsePtr HttpResponse, bool bWasSuccessful)
+{
+    if (!bWasSuccessful || !HttpResponse.IsValid())
+    {
+        return TEXT("Network request failed");
+    }
+
+    const int32 ResponseCode = HttpResponse->GetResponseCode();
+    if (ResponseCode != 200 && ResponseCode != 201)
+    {
+        return FString::Printf(TEXT("HTTP %d: %s"), ResponseCode, *HttpResponse->GetContentAsString());
+    }
+
+    return FString();
+}
+
+const TCHAR* BH_UploadBatcher::GetSingleEndpoint(EBH_BatchCall Kind)
+{
+    return Kind == EBH_BatchCall::Presign ? TEXT("presigned_upload") : TEXT("confirm_upload");
+}
+
+const TCHAR* BH_UploadBatcher::GetBatchEndpoint(EBH_BatchCall Kind)
+{
+    return Kind == EBH_BatchCall::Presign ? TEXT("presigned_uploads") : TEXT("confirm_uploads");
+}
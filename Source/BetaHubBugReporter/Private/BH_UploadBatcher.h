@@ -0,0 +1,106 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Dom/JsonObject.h"
+
+/**
+ * BetaHub API calls made for every file of an issue
+ */
+enum class EBH_BatchCall : uint8
+{
+    Presign,        // {media}/presigned_upload
+    Confirm         // {media}/confirm_upload
+};
+
+/**
+ * Sends the presign and confirm calls of the files of one issue together, saving a round trip per file.
+ *
+ * API flow:
+ *   POST {issue}/presigned_uploads and {issue}/confirm_uploads with {"uploads": [{"media_type": ..., <body of the single call>}, ...]}
+ *   Both return {"uploads": [...]}, one entry per call in the same order: the response of the single call,
+ *   or {"error": "..."} for a call that failed.
+ *
+ * Calls are collected until the next tick, and while a call of the same issue is in flight, so under load
+ * the calls are batched and an idle uploader adds no delay. A single call is sent to its own endpoint, and so
+ * is every call once the server has answered a batch with 404 or 405.
+ * Game thread only.
+ */
+class BH_UploadBatcher
+{
+public:
+    /**
+     * Result of one call, with the JSON response of the call (an empty object if the response has no body)
+     */
+    typedef TFunction<void(bool /* bSuccess */, const FString& /* Error */, const TSharedPtr<FJsonObject>& /* Response */)> FOnCallComplete;
+
+    /**
+     * Registers a call's own request so cancelling the upload aborts it, returns false if the upload was cancelled.
+     * Batch requests are shared and are not registered.
+     */
+    typedef TFunction<bool(const FHttpRequestPtr&)> FTrackRequest;
+
+    struct FCall
+    {
+        FString MediaEndpoint;              // "screenshots", "video_clips" or "log_files"
+        TSharedPtr<FJsonObject> Body;       // Body of the single call
+        FTrackRequest TrackRequest;
+        FOnCallComplete OnComplete;
+    };
+
+    /**
+     * @param bInEnabled        False sends every call on its own
+     */
+    explicit BH_UploadBatcher(bool bInEnabled);
+    ~BH_UploadBatcher();
+
+    /**
+     * Queues a call. OnComplete is called exactly once, unless the call's own request was cancelled.
+     *
+     * @param IssueUrl          {BaseUrl}/projects/{Id}/issues/{Id}
+     * @param ApiToken          JWT token of the draft issue
+     */
+    void Add(EBH_BatchCall Kind, const FString& IssueUrl, const FString& ApiToken, FCall&& Call);
+
+private:
+    struct FQueue
+    {
+        EBH_BatchCall Kind;
+        FString IssueUrl;
+        FString ApiToken;
+        TArray<FCall> Calls;
+        int32 RequestsInFlight;
+    };
+
+    bool FlushQueues(float DeltaTime);
+    void FlushQueue(const FString& QueueKey);
+
+    void SendSingle(const FString& QueueKey, EBH_BatchCall Kind, const FString& IssueUrl, const FString& ApiToken, FCall&& Call);
+    void SendBatch(const FString& QueueKey, TArray<FCall>&& Calls);
+
+    /**
+     * Sends more calls of a queue if it has any, or removes it
+     */
+    void OnRequestDone(const FString& QueueKey);
+
+    static TSharedRef<IHttpRequest, ESPMode::ThreadSafe> CreateApiRequest(const FString& Url, const FString& ApiToken, const TSharedRef<FJsonObject>& Body);
+
+    /**
+     * @return              The error of a failed request, empty on success
+     */
+    static FString GetResponseError(FHttpResponsePtr HttpResponse, bool bWasSuccessful);
+
+    static const TCHAR* GetSingleEndpoint(EBH_BatchCall Kind);
+    static const TCHAR* GetBatchEndpoint(EBH_BatchCall Kind);
+
+    // Keyed by call kind, issue and token
+    TMap<FString, FQueue> Queues;
+    FTSTicker::FDelegateHandle FlushHandle;
+
+    bool bEnabled;
+
+    // Set when the server does not support batch calls, for the rest of the session
+    bool bBatchEndpointsMissing;
+};
@@ -0,0 +1,1061 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "BH_UploadJournal.h"
+#include "BH_MediaUploadManager.h"
+#include "BH_UploadScheduler.h"
+#include "BH_StorageManager.h"
+#include "BH_PluginSettings.h"
+#include "BH_Log.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Async/Async.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+
+// Backoff between attempts of a report, doubled after each attempt
+static const double RetryBaseDelaySeconds = 30.0;
+static const double RetryMaxDelaySeconds = 60.0 * 60.0;
+
+// Reports of earlier sessions wait for the game to finish loading
+static const double StartupDelaySeconds = 10.0;
+
+// Time for cancelled requests to close the files of a discarded report
+static const double FileReleaseDelaySeconds = 5.0;
+
+static FString ReportStateToString(EBH_ReportState State)
+{
+    switch (State)
+    {
+        case EBH_ReportState::Uploading:
+            return TEXT("uploading");
+        case EBH_ReportState::Published:
+            return TEXT("published");
+        case EBH_ReportState::DraftCreated:
+        default:
+            return TEXT("draft_created");
+    }
+}
+
+static EBH_ReportState ReportStateFromString(const FString& State)
+{
+    if (State == TEXT("uploading"))
+    {
+        return EBH_ReportState::Uploading;
+    }
+    if (State == TEXT("published"))
+    {
+        return EBH_ReportState::Published;
+    }
+    return EBH_ReportState::DraftCreated;
+}
+
+static FString ArtifactStateToString(EBH_ArtifactState State)
+{
+    switch (State)
+    {
+        case EBH_ArtifactState::Presigned:
+            return TEXT("presigned");
+        case EBH_ArtifactState::Uploaded:
+            return TEXT("uploaded");
+        case EBH_ArtifactState::Confirmed:
+            return TEXT("confirmed");
+        case EBH_ArtifactState::Failed:
+            return TEXT("failed");
+        case EBH_ArtifactState::Pending:
+        default:
+            return TEXT("pending");
+    }
+}
+
+static EBH_ArtifactState ArtifactStateFromString(const FString& State)
+{
+    if (State == TEXT("presigned"))
+    {
+        return EBH_ArtifactState::Presigned;
+    }
+    if (State == TEXT("uploaded"))
+    {
+        return EBH_ArtifactState::Uploaded;
+    }
+    if (State == TEXT("confirmed"))
+    {
+        return EBH_ArtifactState::Confirmed;
+    }
+    if (State == TEXT("failed"))
+    {
+        return EBH_ArtifactState::Failed;
+    }
+    return EBH_ArtifactState::Pending;
+}
+
+BH_UploadJournal& BH_UploadJournal::Get()
+{
+    static BH_UploadJournal Instance;
+    return Instance;
+}
+
+BH_UploadJournal::BH_UploadJournal()
+    : MaxAttempts(FMath::Max(GetDefault<UBH_PluginSettings>()->MaxUploadRetryAttempts, 0) + 1)
+    , bInitialized(false)
+{
+    // Constructed first so it is destroyed after the upload managers owned by the journal
+    BH_UploadScheduler::Get();
+}
+
+void BH_UploadJournal::Initialize()
+{
+    check(IsInGameThread());
+
+    if (bInitialized)
+    {
+        return;
+    }
+    bInitialized = true;
+
+    const FString JournalDir = BH_StorageManager::GetJournalDir();
+
+    TArray<FString> JournalFiles;
+    IFileManager::Get().FindFiles(JournalFiles, *(JournalDir / TEXT("*.json")), true, false);
+
+    const FDateTime Now = FDateTime::UtcNow();
+    for (const FString& JournalFile : JournalFiles)
+    {
+        FReport Report;
+        if (!LoadReport(JournalDir / JournalFile, Report))
+        {
+            UE_LOG(LogBetaHub, Warning, TEXT("Discarding unreadable upload journal %s"), *JournalFile);
+            IFileManager::Get().Delete(*(JournalDir / JournalFile), false, false, true);
+            IFileManager::Get().DeleteDirectory(*GetArtifactsDir(FPaths::GetBaseFilename(JournalFile)), false, true);
+            continue;
+        }
+
+        // The game was closed with the report form open, the report was never submitted
+        if (Report.bHeld)
+        {
+            UE_LOG(LogBetaHub, Log, TEXT("Deleting report %s, it was never submitted"), *Report.IssueId);
+            const FString IssueId = Report.IssueId;
+            Reports.Add(IssueId, MoveTemp(Report));
+            DiscardReport(IssueId);
+            continue;
+        }
+
+        const double DelaySeconds = FMath::Max((Report.NextAttempt - Now).GetTotalSeconds(), StartupDelaySeconds);
+        UE_LOG(LogBetaHub, Log, TEXT("Resuming unfinished report %s in %.0f seconds (attempt %d of %d)"),
+            *Report.IssueId, DelaySeconds, Report.Attempts + 1, MaxAttempts);
+
+        const FString IssueId = Report.IssueId;
+        ScheduleAttempt(Reports.Add(IssueId, MoveTemp(Report)), DelaySeconds);
+    }
+}
+
+void BH_UploadJournal::BeginReport(const FString& BaseUrl, const FString& ProjectId, const FString& IssueId, const FString& ApiToken, bool bSpeculative)
+{
+    check(IsInGameThread());
+
+    FReport& Report = Reports.Add(IssueId);
+    Report.IssueId = IssueId;
+    Report.BaseUrl = BaseUrl;
+    Report.ProjectId = ProjectId;
+    Report.ApiToken = ApiToken;
+    Report.State = EBH_ReportState::DraftCreated;
+    Report.Attempts = 0;
+    Report.NextAttempt = FDateTime::UtcNow();
+    Report.bHeld = bSpeculative;
+    Report.NumExpected = 0;
+    Report.Pass = EPass::Done;
+    Report.bProcessing = false;
+
+    SaveReport(Report);
+}
+
+void BH_UploadJournal::AddArtifact(const FString& IssueId, EBH_MediaType MediaType, const FBH_MediaFile& File, bool bMoveFile, bool bDeferred,
+    const FString& FileName)
+{
+    check(IsInGameThread());
+
+    FReport* Report = Reports.Find(IssueId);
+    if (!Report)
+    {
+        UE_LOG(LogBetaHub, Error, TEXT("AddArtifact called for unknown report %s"), *IssueId);
+
+        // Files of the plugin would be left behind
+        if (bMoveFile && !File.FilePath.IsEmpty())
+        {
+            IFileManager::Get().Delete(*File.FilePath, false, false, true);
+        }
+        return;
+    }
+
+    IFileManager& FileManager = IFileManager::Get();
+    const FString ArtifactDir = GetArtifactsDir(IssueId) / FString::FromInt(Report->Artifacts.Num());
+    FileManager.MakeDirectory(*ArtifactDir, true);
+
+    FArtifact Artifact;
+    Artifact.MediaType = MediaType;
+    Artifact.Name = File.Name;
+    Artifact.State = EBH_ArtifactState::Pending;
+    Artifact.bDeferred = bDeferred;
+
+    if (!File.FilePath.IsEmpty())
+    {
+        const FString JournalPath = ArtifactDir / (FileName.IsEmpty() ? FPaths::GetCleanFilename(File.FilePath) : FileName);
+
+        // Files of the plugin are moved (a rename on the same volume), files of the game are left where they are
+        const bool bStored = bMoveFile
+            ? FileManager.Move(*JournalPath, *File.FilePath, true, true)
+            : FileManager.Copy(*JournalPath, *File.FilePath, true, true) == COPY_OK;
+
+        if (bStored)
+        {
+            Artifact.FilePath = JournalPath;
+        }
+        else
+        {
+            UE_LOG(LogBetaHub, Warning, TEXT("Cannot store %s in the upload journal, it is uploaded from its original location"), *File.FilePath);
+            Artifact.FilePath = File.FilePath;
+        }
+    }
+    else if (!File.Content.IsEmpty())
+    {
+        // Written once as UTF-8, the same bytes are uploaded later without another conversion
+        Artifact.FilePath = ArtifactDir / TEXT("log.log");
+        if (!FFileHelper::SaveStringToFile(File.Content, *Artifact.FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+        {
+            UE_LOG(LogBetaHub, Error, TEXT("Failed to write log contents to the upload journal"));
+            return;
+        }
+    }
+    else
+    {
+        return;
+    }
+
+    Report->Artifacts.Add(MoveTemp(Artifact));
+    SaveReport(*Report);
+}
+
+void BH_UploadJournal::ExpectArtifacts(const FString& IssueId)
+{
+    check(IsInGameThread());
+
+    if (FReport* Report = Reports.Find(IssueId))
+    {
+        Report->NumExpected++;
+    }
+}
+
+void BH_UploadJournal::EndExpectedArtifacts(const FString& IssueId)
+{
+    check(IsInGameThread());
+
+    FReport* Report = Reports.Find(IssueId);
+    if (!Report || Report->NumExpected == 0)
+    {
+        return;
+    }
+
+    Report->NumExpected--;
+
+    // A report that is processing or waiting for a retry picks the files up on its own
+    if (Report->NumExpected == 0 && Report->State == EBH_ReportState::Published && !Report->bProcessing && !Report->RetryHandle.IsValid())
+    {
+        ProcessReport(IssueId);
+    }
+}
+
+void BH_UploadJournal::ProcessReport(const FString& IssueId, TFunction<void()> OnPublished, TFunction<void(const FString&)> OnFailure)
+{
+    check(IsInGameThread());
+
+    FReport* Report = Reports.Find(IssueId);
+    if (!Report)
+    {
+        return;
+    }
+
+    if (Report->bProcessing)
+    {
+        // Submitted while its files are uploaded ahead, the upload pass confirms them and publishes when it is done
+        if (Report->bHeld)
+        {
+            Report->bHeld = false;
+            Report->Attempts++;
+            Report->State = EBH_ReportState::Uploading;
+            Report->OnPublished = MoveTemp(OnPublished);
+            Report->OnFailure = MoveTemp(OnFailure);
+            SaveReport(*Report);
+        }
+        return;
+    }
+
+    if (Report->RetryHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(Report->RetryHandle);
+        Report->RetryHandle.Reset();
+    }
+
+    Report->Attempts++;
+    Report->bHeld = false;
+    Report->bProcessing = true;
+    Report->Pass = EPass::UploadBeforePublish;
+    Report->OnPublished = MoveTemp(OnPublished);
+    Report->OnFailure = MoveTemp(OnFailure);
+
+    if (Report->State == EBH_ReportState::DraftCreated)
+    {
+        Report->State = EBH_ReportState::Uploading;
+    }
+    SaveReport(*Report);
+
+    ContinueReport(IssueId);
+}
+
+void BH_UploadJournal::PreUploadReport(const FString& IssueId)
+{
+    check(IsInGameThread());
+
+    FReport* Report = Reports.Find(IssueId);
+    if (!Report || !Report->bHeld || Report->bProcessing)
+    {
+        return;
+    }
+
+    Report->bProcessing = true;
+    Report->Pass = EPass::UploadBeforePublish;
+    ContinueReport(IssueId);
+}
+
+void BH_UploadJournal::RemoveArtifacts(const FString& IssueId, EBH_MediaType MediaType)
+{
+    check(IsInGameThread());
+
+    FReport* Report = Reports.Find(IssueId);
+    if (!Report)
+    {
+        return;
+    }
+
+    const FString ArtifactsDir = GetArtifactsDir(IssueId);
+    const int32 NumRemoved = Report->Artifacts.RemoveAll([MediaType, &ArtifactsDir](const FArtifact& Artifact)
+    {
+        if (Artifact.MediaType != MediaType || Artifact.State == EBH_ArtifactState::Confirmed)
+        {
+            return false;
+        }
+
+        // A file that is still being read by its upload is deleted with the report
+        if (Artifact.FilePath.StartsWith(ArtifactsDir))
+        {
+            IFileManager::Get().Delete(*Artifact.FilePath, false, false, true);
+        }
+        return true;
+    });
+
+    if (NumRemoved > 0)
+    {
+        UE_LOG(LogBetaHub, Log, TEXT("Removed %d %s files from report %s"), NumRemoved, *BH_MediaTypeHelper::GetDisplayName(MediaType), *IssueId);
+        SaveReport(*Report);
+    }
+}
+
+void BH_UploadJournal::SetIssueFields(const FString& IssueId, const TSharedRef<FJsonObject>& Fields)
+{
+    check(IsInGameThread());
+
+    if (FReport* Report = Reports.Find(IssueId))
+    {
+        Report->IssueFields = Fields;
+        SaveReport(*Report);
+    }
+}
+
+void BH_UploadJournal::DiscardReport(const FString& IssueId)
+{
+    check(IsInGameThread());
+
+    FReport* Report = Reports.Find(IssueId);
+    if (!Report)
+    {
+        return;
+    }
+
+    if (Report->RetryHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(Report->RetryHandle);
+    }
+
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    Request->SetURL(Report->BaseUrl + TEXT("/projects/") + Report->ProjectId + TEXT("/issues/") + IssueId);
+    Request->SetVerb(TEXT("DELETE"));
+    Request->SetHeader(TEXT("Accept"), TEXT("application/json"));
+    Request->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *Report->ApiToken));
+    Request->SetHeader(TEXT("BetaHub-Project-ID"), Report->ProjectId);
+
+    Request->OnProcessRequestComplete().BindLambda(
+        [IssueId](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
+        {
+            const int32 ResponseCode = HttpResponse.IsValid() ? HttpResponse->GetResponseCode() : 0;
+            if (bWasSuccessful && (ResponseCode == 200 || ResponseCode == 204 || ResponseCode == 404))
+            {
+                UE_LOG(LogBetaHub, Log, TEXT("Draft issue %s deleted"), *IssueId);
+            }
+            else
+            {
+                // Drafts are never shown, an unpublished one only takes space on the server
+                UE_LOG(LogBetaHub, Warning, TEXT("Failed to delete draft issue %s (HTTP %d)"), *IssueId, ResponseCode);
+            }
+        }
+    );
+
+    Request->SetTimeout(30.0f);
+    Request->ProcessRequest();
+
+    // The report is gone, so the cancelled uploads complete without continuing it
+    Reports.Remove(IssueId);
+
+    TSharedPtr<BH_MediaUploadManager> MediaManager;
+    if (ActiveUploads.RemoveAndCopyValue(IssueId, MediaManager))
+    {
+        MediaManager->CancelUploads();
+    }
+
+    // Only now, a file still open for an upload cannot be deleted on Windows. A request cancelled
+    // on the HTTP thread may keep its file open a moment longer, the files are then deleted again later.
+    if (!DeleteReportFiles(IssueId))
+    {
+        FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this, IssueId](float DeltaTime)
+        {
+            if (!Reports.Contains(IssueId) && !DeleteReportFiles(IssueId))
+            {
+                UE_LOG(LogBetaHub, Warning, TEXT("Failed to delete the files of discarded report %s"), *IssueId);
+            }
+            return false;
+        }), (float)FileReleaseDelaySeconds);
+    }
+}
+
+void BH_UploadJournal::DiscardReports(const FString& BaseUrl)
+{
+    check(IsInGameThread());
+
+    TArray<FString> IssueIds;
+    for (const TPair<FString, FReport>& Entry : Reports)
+    {
+        if (Entry.Value.BaseUrl == BaseUrl)
+        {
+            IssueIds.Add(Entry.Key);
+        }
+    }
+
+    for (const FString& IssueId : IssueIds)
+    {
+        DiscardReport(IssueId);
+    }
+}
+
+bool BH_UploadJournal::CanRetry(const FString& IssueId) const
+{
+    const FReport* Report = Reports.Find(IssueId);
+    return Report && Report->Attempts < MaxAttempts;
+}
+
+void BH_UploadJournal::ContinueReport(const FString& IssueId)
+{
+    FReport* Report = Reports.Find(IssueId);
+    if (!Report)
+    {
+        return;
+    }
+
+    switch (Report->Pass)
+    {
+        case EPass::UploadBeforePublish:
+            if (Report->State == EBH_ReportState::Published)
+            {
+                // Published in an earlier attempt, only the remaining files are left
+                Report->Pass = EPass::UploadAfterPublish;
+                ContinueReport(IssueId);
+            }
+            else
+            {
+                UploadArtifacts(IssueId, false);
+            }
+            break;
+
+        case EPass::UpdateIssue:
+            if (Report->bHeld)
+            {
+                // Uploaded ahead, the rest waits for the player to submit the report
+                Report->bProcessing = false;
+                Report->Pass = EPass::Done;
+            }
+            else
+            {
+                UpdateIssue(IssueId);
+            }
+            break;
+
+        case EPass::Publish:
+            PublishReport(IssueId);
+            break;
+
+        case EPass::UploadAfterPublish:
+            UploadArtifacts(IssueId, true);
+            break;
+
+        case EPass::Done:
+        default:
+            FinishAttempt(IssueId);
+            break;
+    }
+}
+
+void BH_UploadJournal::UploadArtifacts(const FString& IssueId, bool bDeferred)
+{
+    FReport& Report = Reports[IssueId];
+    const bool bHeld = Report.bHeld;
+
+    TArray<FBH_MediaFile> Videos;
+    TArray<FBH_MediaFile> Screenshots;
+    TArray<FBH_MediaFile> Logs;
+    TMap<FString, FString> UploadedBlobs;
+
+    for (FArtifact& Artifact : Report.Artifacts)
+    {
+        // Files that failed before publishing are retried along with the deferred ones
+        const bool bInPass = bDeferred || !Artifact.bDeferred;
+        const bool bUnfinished = Artifact.State != EBH_ArtifactState::Confirmed && Artifact.State != EBH_ArtifactState::Failed;
+        if (!bInPass || !bUnfinished)
+        {
+            continue;
+        }
+
+        if (!FPaths::FileExists(Artifact.FilePath))
+        {
+            UE_LOG(LogBetaHub, Warning, TEXT("File of report %s is gone, not uploading it: %s"), *IssueId, *Artifact.FilePath);
+            Artifact.State = EBH_ArtifactState::Failed;
+            continue;
+        }
+
+        FBH_MediaFile File;
+        File.FilePath = Artifact.FilePath;
+        File.Name = Artifact.Name;
+
+        switch (Artifact.MediaType)
+        {
+            case EBH_MediaType::Video:
+                Videos.Add(File);
+                break;
+            case EBH_MediaType::Screenshot:
+                Screenshots.Add(File);
+                break;
+            case EBH_MediaType::LogFile:
+                Logs.Add(File);
+                break;
+            case EBH_MediaType::Bundle:
+                // Bundles are built for each attempt, they are never journaled
+                break;
+        }
+
+        if (Artifact.State == EBH_ArtifactState::Uploaded)
+        {
+            UploadedBlobs.Add(Artifact.FilePath, Artifact.BlobSignedId);
+        }
+    }
+
+    const EPass NextPass = bDeferred ? EPass::Done : EPass::UpdateIssue;
+
+    if (Videos.Num() + Screenshots.Num() + Logs.Num() == 0)
+    {
+        SaveReport(Report);
+        Report.Pass = NextPass;
+        ContinueReport(IssueId);
+        return;
+    }
+
+    TSharedPtr<BH_MediaUploadManager> MediaManager = MakeShareable(new BH_MediaUploadManager());
+    ActiveUploads.Add(IssueId, MediaManager);
+
+    MediaManager->SetUploadedBlobs(UploadedBlobs);
+    MediaManager->SetHoldConfirmations(bHeld);
+    MediaManager->SetFileCallbacks(
+        BH_MediaUploadManager::FOnFileStage::CreateLambda(
+            [this, IssueId](const FString& FilePath, EBH_UploadStage Stage, const FString& BlobSignedId)
+            {
+                FReport* Report = Reports.Find(IssueId);
+                FArtifact* Artifact = Report ? Report->Artifacts.FindByPredicate(
+                    [&FilePath](const FArtifact& Candidate) { return Candidate.FilePath == FilePath; }) : nullptr;
+                if (!Artifact)
+                {
+                    return;
+                }
+
+                Artifact->State = Stage == EBH_UploadStage::Uploaded ? EBH_ArtifactState::Uploaded : EBH_ArtifactState::Presigned;
+                Artifact->BlobSignedId = BlobSignedId;
+                SaveReport(*Report);
+            }),
+        BH_MediaUploadManager::FOnFileComplete::CreateLambda(
+            [this, IssueId, bHeld](const FString& FilePath, const BH_S3Uploader::FUploadResult& Result)
+            {
+                FReport* Report = Reports.Find(IssueId);
+                FArtifact* Artifact = Report ? Report->Artifacts.FindByPredicate(
+                    [&FilePath](const FArtifact& Candidate) { return Candidate.FilePath == FilePath; }) : nullptr;
+                if (!Artifact || !Result.bSuccess)
+                {
+                    // Kept in its current state and retried with the next attempt
+                    return;
+                }
+
+                if (bHeld)
+                {
+                    // Only uploaded, the Uploaded stage is recorded and the file is confirmed when the report is submitted
+                    return;
+                }
+
+                Artifact->State = EBH_ArtifactState::Confirmed;
+                SaveReport(*Report);
+
+                // Free the disk space right away, the report may wait for other files for a while
+                if (Artifact->FilePath.StartsWith(GetArtifactsDir(IssueId)))
+                {
+                    IFileManager::Get().Delete(*Artifact->FilePath, false, false, true);
+                }
+            }));
+
+    TWeakPtr<BH_MediaUploadManager> WeakManager = MediaManager;
+    BH_MediaUploadManager::FOnUploadComplete OnComplete = BH_MediaUploadManager::FOnUploadComplete::CreateLambda(
+        [this, IssueId, NextPass, bHeld, WeakManager](const BH_MediaUploadManager::FMediaUploadResult& Result)
+        {
+            if (Result.bSuccess)
+            {
+                UE_LOG(LogBetaHub, Log, TEXT("Media of report %s uploaded (%d screenshots, %d videos, %d log files)"),
+                    *IssueId, Result.ScreenshotsUploaded, Result.VideosUploaded, Result.LogsUploaded);
+            }
+            else
+            {
+                for (const FString& Error : Result.Errors)
+                {
+                    UE_LOG(LogBetaHub, Warning, TEXT("Upload error in report %s: %s"), *IssueId, *Error);
+                }
+            }
+
+            // The manager is still on the call stack, it is kept alive and released on the next tick.
+            // A report submitted while its files were uploaded ahead gets a new manager below, which must stay.
+            TSharedPtr<BH_MediaUploadManager> CompletedManager = WeakManager.Pin();
+            AsyncTask(ENamedThreads::GameThread, [this, IssueId, CompletedManager]()
+            {
+                const TSharedPtr<BH_MediaUploadManager>* ActiveManager = ActiveUploads.Find(IssueId);
+                if (ActiveManager && *ActiveManager == CompletedManager)
+                {
+                    ActiveUploads.Remove(IssueId);
+                }
+            });
+
+            if (FReport* Report = Reports.Find(IssueId))
+            {
+                // The issue is published even if some media failed, like without the journal.
+                // A report submitted while its files were uploaded ahead runs the pass again to confirm them.
+                Report->Pass = bHeld && !Report->bHeld ? EPass::UploadBeforePublish : NextPass;
+                ContinueReport(IssueId);
+            }
+        });
+
+    BH_MediaUploadManager::FOnProgressUpdate OnProgress = BH_MediaUploadManager::FOnProgressUpdate::CreateLambda(
+        [](const BH_MediaUploadManager::FUploadProgress& Progress)
+        {
+            UE_LOG(LogBetaHub, Verbose, TEXT("Upload progress: %s (%.1f%%, %lld of %lld bytes)"),
+                *Progress.CurrentFile, Progress.ProgressPercent, Progress.BytesSent, Progress.TotalBytes);
+        });
+
+    UE_LOG(LogBetaHub, Log, TEXT("Uploading %d files of report %s%s"),
+        Videos.Num() + Screenshots.Num() + Logs.Num(), *IssueId,
+        bDeferred ? TEXT(" in the background") : bHeld ? TEXT(" before it is submitted") : TEXT(""));
+
+    SaveReport(Report);
+
+    // The report may already be finished when UploadMediaFiles returns
+    const FString BaseUrl = Report.BaseUrl;
+    const FString ProjectId = Report.ProjectId;
+    const FString ApiToken = Report.ApiToken;
+    MediaManager->UploadMediaFiles(
+        BaseUrl,
+        ProjectId,
+        IssueId,
+        ApiToken,
+        Videos,
+        Screenshots,
+        Logs,
+        OnProgress,
+        OnComplete
+    );
+}
+
+void BH_UploadJournal::UpdateIssue(const FString& IssueId)
+{
+    FReport& Report = Reports[IssueId];
+    if (!Report.IssueFields.IsValid())
+    {
+        Report.Pass = EPass::Publish;
+        ContinueReport(IssueId);
+        return;
+    }
+
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    Request->SetURL(Report.BaseUrl + TEXT("/projects/") + Report.ProjectId + TEXT("/issues/") + IssueId);
+    Request->SetVerb(TEXT("PATCH"));
+    Request->SetHeader(TEXT("Accept"), TEXT("application/json"));
+    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+    Request->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *Report.ApiToken));
+    Request->SetHeader(TEXT("BetaHub-Project-ID"), Report.ProjectId);
+
+    TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+    JsonObject->SetObjectField(TEXT("issue"), Report.IssueFields);
+
+    FString JsonString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+    FJsonSerializer::Serialize(JsonObject, Writer);
+    Request->SetContentAsString(JsonString);
+
+    Request->OnProcessRequestComplete().BindLambda(
+        [this, IssueId](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
+        {
+            AsyncTask(ENamedThreads::GameThread, [this, IssueId, HttpResponse, bWasSuccessful]()
+            {
+                FReport* Report = Reports.Find(IssueId);
+                if (!Report)
+                {
+                    return;
+                }
+
+                const int32 ResponseCode = HttpResponse.IsValid() ? HttpResponse->GetResponseCode() : 0;
+                if (bWasSuccessful && (ResponseCode == 200 || ResponseCode == 204))
+                {
+                    UE_LOG(LogBetaHub, Log, TEXT("Issue updated successfully"));
+
+                    Report->IssueFields.Reset();
+                    Report->Pass = EPass::Publish;
+                    SaveReport(*Report);
+
+                    ContinueReport(IssueId);
+                    return;
+                }
+
+                FString ErrorMessage = TEXT("Failed to update issue");
+                if (HttpResponse.IsValid())
+                {
+                    ErrorMessage = FString::Printf(TEXT("Failed to update issue: HTTP %d - %s"),
+                        ResponseCode, *HttpResponse->GetContentAsString());
+                }
+                else if (!bWasSuccessful)
+                {
+                    ErrorMessage = TEXT("Failed to update issue: Network request failed");
+                }
+                UE_LOG(LogBetaHub, Error, TEXT("%s"), *ErrorMessage);
+
+                FailRequest(IssueId, ErrorMessage, ResponseCode);
+            });
+        }
+    );
+
+    Request->SetTimeout(30.0f);
+    Request->ProcessRequest();
+}
+
+void BH_UploadJournal::PublishReport(const FString& IssueId)
+{
+    const FReport& Report = Reports[IssueId];
+
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+    FString Url = Report.BaseUrl + TEXT("/projects/") + Report.ProjectId + TEXT("/issues/") + IssueId + TEXT("/publish");
+
+    Request->SetURL(Url);
+    Request->SetVerb(TEXT("POST"));
+    Request->SetHeader(TEXT("Accept"), TEXT("application/json"));
+    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+    Request->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *Report.ApiToken));
+    Request->SetHeader(TEXT("BetaHub-Project-ID"), Report.ProjectId);
+
+    // Create JSON body
+    TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
+    JsonObject->SetBoolField(TEXT("email_my_report"), false);
+
+    FString JsonString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+    FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
+    Request->SetContentAsString(JsonString);
+
+    Request->OnProcessRequestComplete().BindLambda(
+        [this, IssueId](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
+        {
+            AsyncTask(ENamedThreads::GameThread, [this, IssueId, HttpResponse, bWasSuccessful]()
+            {
+                FReport* Report = Reports.Find(IssueId);
+                if (!Report)
+                {
+                    return;
+                }
+
+                const int32 ResponseCode = HttpResponse.IsValid() ? HttpResponse->GetResponseCode() : 0;
+                if (bWasSuccessful && (ResponseCode == 200 || ResponseCode == 201))
+                {
+                    UE_LOG(LogBetaHub, Log, TEXT("Issue published successfully"));
+
+                    Report->State = EBH_ReportState::Published;
+                    Report->Pass = EPass::UploadAfterPublish;
+                    SaveReport(*Report);
+
+                    TFunction<void()> OnPublished = MoveTemp(Report->OnPublished);
+                    Report->OnFailure = nullptr;
+                    if (OnPublished)
+                    {
+                        OnPublished();
+                    }
+
+                    ContinueReport(IssueId);
+                    return;
+                }
+
+                FString ErrorMessage = TEXT("Failed to publish issue");
+                if (HttpResponse.IsValid())
+                {
+                    ErrorMessage = FString::Printf(TEXT("Failed to publish issue: HTTP %d - %s"),
+                        ResponseCode, *HttpResponse->GetContentAsString());
+                }
+                else if (!bWasSuccessful)
+                {
+                    ErrorMessage = TEXT("Failed to publish issue: Network request failed");
+                }
+                UE_LOG(LogBetaHub, Error, TEXT("%s"), *ErrorMessage);
+
+                FailRequest(IssueId, ErrorMessage, ResponseCode);
+            });
+        }
+    );
+
+    Request->SetTimeout(30.0f);
+    Request->ProcessRequest();
+}
+
+void BH_UploadJournal::FailRequest(const FString& IssueId, FString ErrorMessage, int32 ResponseCode)
+{
+    FReport& Report = Reports[IssueId];
+
+    // The draft or its token is rejected, another attempt would fail the same way
+    const bool bRetryable = ResponseCode == 0 || ResponseCode == 408 || ResponseCode == 429 || ResponseCode >= 500;
+    if (!bRetryable)
+    {
+        Report.Attempts = MaxAttempts;
+    }
+    else if (CanRetry(IssueId))
+    {
+        ErrorMessage += TEXT(". The report is saved and will be sent again later.");
+    }
+
+    TFunction<void(const FString&)> OnFailure = MoveTemp(Report.OnFailure);
+    Report.OnPublished = nullptr;
+    Report.Pass = EPass::Done;
+
+    if (OnFailure)
+    {
+        OnFailure(ErrorMessage);
+    }
+
+    ContinueReport(IssueId);
+}
+
+void BH_UploadJournal::FinishAttempt(const FString& IssueId)
+{
+    FReport& Report = Reports[IssueId];
+    Report.bProcessing = false;
+    Report.OnPublished = nullptr;
+    Report.OnFailure = nullptr;
+
+    const bool bAllFilesDone = !Report.Artifacts.ContainsByPredicate([](const FArtifact& Artifact)
+    {
+        return Artifact.State != EBH_ArtifactState::Confirmed && Artifact.State != EBH_ArtifactState::Failed;
+    });
+
+    if (Report.State == EBH_ReportState::Published && bAllFilesDone)
+    {
+        if (Report.NumExpected > 0)
+        {
+            UE_LOG(LogBetaHub, Log, TEXT("Report %s is published, waiting for its remaining files"), *IssueId);
+            return;
+        }
+
+        UE_LOG(LogBetaHub, Log, TEXT("Report %s is complete"), *IssueId);
+        RemoveReport(IssueId);
+        return;
+    }
+
+    if (Report.Attempts >= MaxAttempts)
+    {
+        UE_LOG(LogBetaHub, Warning, TEXT("Giving up on report %s after %d attempts (%s)"),
+            *IssueId, Report.Attempts, Report.State == EBH_ReportState::Published ? TEXT("published, some files are missing") : TEXT("not published"));
+        RemoveReport(IssueId);
+        return;
+    }
+
+    // Exponential backoff with jitter, so reports that failed together do not retry together
+    const double Backoff = FMath::Min(RetryBaseDelaySeconds * FMath::Pow(2.0, Report.Attempts - 1), RetryMaxDelaySeconds);
+    const double DelaySeconds = Backoff * FMath::FRandRange(0.8, 1.2);
+
+    UE_LOG(LogBetaHub, Log, TEXT("Report %s is unfinished, retrying in %.0f seconds (attempt %d of %d)"),
+        *IssueId, DelaySeconds, Report.Attempts + 1, MaxAttempts);
+    ScheduleAttempt(Report, DelaySeconds);
+}
+
+void BH_UploadJournal::ScheduleAttempt(FReport& Report, double DelaySeconds)
+{
+    Report.NextAttempt = FDateTime::UtcNow() + FTimespan::FromSeconds(DelaySeconds);
+    SaveReport(Report);
+
+    const FString IssueId = Report.IssueId;
+    Report.RetryHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this, IssueId](float DeltaTime)
+    {
+        if (FReport* ScheduledReport = Reports.Find(IssueId))
+        {
+            ScheduledReport->RetryHandle.Reset();
+            ProcessReport(IssueId);
+        }
+        return false;
+    }), (float)DelaySeconds);
+}
+
+void BH_UploadJournal::RemoveReport(const FString& IssueId)
+{
+    DeleteReportFiles(IssueId);
+    Reports.Remove(IssueId);
+}
+
+bool BH_UploadJournal::DeleteReportFiles(const FString& IssueId) const
+{
+    IFileManager::Get().Delete(*GetReportPath(IssueId), false, false, true);
+    return IFileManager::Get().DeleteDirectory(*GetArtifactsDir(IssueId), false, true);
+}
+
+void BH_UploadJournal::SaveReport(const FReport& Report) const
+{
+    TArray<TSharedPtr<FJsonValue>> Artifacts;
+    for (const FArtifact& Artifact : Report.Artifacts)
+    {
+        TSharedPtr<FJsonObject> ArtifactObject = MakeShareable(new FJsonObject);
+        ArtifactObject->SetNumberField(TEXT("media_type"), (int32)Artifact.MediaType);
+        ArtifactObject->SetStringField(TEXT("file"), Artifact.FilePath);
+        ArtifactObject->SetStringField(TEXT("name"), Artifact.Name);
+        ArtifactObject->SetStringField(TEXT("state"), ArtifactStateToString(Artifact.State));
+        ArtifactObject->SetStringField(TEXT("blob_signed_id"), Artifact.BlobSignedId);
+        ArtifactObject->SetBoolField(TEXT("deferred"), Artifact.bDeferred);
+        Artifacts.Add(MakeShareable(new FJsonValueObject(ArtifactObject)));
+    }
+
+    TSharedPtr<FJsonObject> Journal = MakeShareable(new FJsonObject);
+    Journal->SetStringField(TEXT("issue_id"), Report.IssueId);
+    Journal->SetStringField(TEXT("base_url"), Report.BaseUrl);
+    Journal->SetStringField(TEXT("project_id"), Report.ProjectId);
+    Journal->SetStringField(TEXT("api_token"), Report.ApiToken);
+    Journal->SetStringField(TEXT("state"), ReportStateToString(Report.State));
+    Journal->SetNumberField(TEXT("attempts"), Report.Attempts);
+    Journal->SetStringField(TEXT("next_attempt"), Report.NextAttempt.ToIso8601());
+    Journal->SetArrayField(TEXT("artifacts"), Artifacts);
+    Journal->SetBoolField(TEXT("held"), Report.bHeld);
+    if (Report.IssueFields.IsValid())
+    {
+        Journal->SetObjectField(TEXT("issue_fields"), Report.IssueFields);
+    }
+
+    FString JsonString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+    FJsonSerializer::Serialize(Journal.ToSharedRef(), Writer);
+
+    // A crash mid-write must not lose the report
+    BH_StorageManager::SaveStringToFileAtomic(JsonString, GetReportPath(Report.IssueId));
+}
+
+bool BH_UploadJournal::LoadReport(const FString& JournalPath, FReport& OutReport) const
+{
+    FString JsonString;
+    if (!FFileHelper::LoadFileToString(JsonString, *JournalPath))
+    {
+        return false;
+    }
+
+    TSharedPtr<FJsonObject> Journal;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+    if (!FJsonSerializer::Deserialize(Reader, Journal) || !Journal.IsValid()
+        || !Journal->TryGetStringField(TEXT("issue_id"), OutReport.IssueId)
+        || !Journal->TryGetStringField(TEXT("base_url"), OutReport.BaseUrl)
+        || !Journal->TryGetStringField(TEXT("project_id"), OutReport.ProjectId)
+        || !Journal->TryGetStringField(TEXT("api_token"), OutReport.ApiToken))
+    {
+        return false;
+    }
+
+    FString State;
+    Journal->TryGetStringField(TEXT("state"), State);
+    OutReport.State = ReportStateFromString(State);
+
+    OutReport.Attempts = 0;
+    Journal->TryGetNumberField(TEXT("attempts"), OutReport.Attempts);
+
+    FString NextAttempt;
+    if (!Journal->TryGetStringField(TEXT("next_attempt"), NextAttempt) || !FDateTime::ParseIso8601(*NextAttempt, OutReport.NextAttempt))
+    {
+        OutReport.NextAttempt = FDateTime::UtcNow();
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* Artifacts;
+    if (Journal->TryGetArrayField(TEXT("artifacts"), Artifacts))
+    {
+        for (const TSharedPtr<FJsonValue>& Value : *Artifacts)
+        {
+            const TSharedPtr<FJsonObject>* ArtifactObject;
+            if (!Value->TryGetObject(ArtifactObject))
+            {
+                continue;
+            }
+
+            FArtifact& Artifact = OutReport.Artifacts.AddDefaulted_GetRef();
+
+            int32 MediaType = 0;
+            (*ArtifactObject)->TryGetNumberField(TEXT("media_type"), MediaType);
+            Artifact.MediaType = (EBH_MediaType)FMath::Clamp(MediaType, 0, (int32)EBH_MediaType::LogFile);
+
+            (*ArtifactObject)->TryGetStringField(TEXT("file"), Artifact.FilePath);
+            (*ArtifactObject)->TryGetStringField(TEXT("name"), Artifact.Name);
+            (*ArtifactObject)->TryGetStringField(TEXT("state"), State);
+            Artifact.State = ArtifactStateFromString(State);
+            (*ArtifactObject)->TryGetStringField(TEXT("blob_signed_id"), Artifact.BlobSignedId);
+
+            Artifact.bDeferred = false;
+            (*ArtifactObject)->TryGetBoolField(TEXT("deferred"), Artifact.bDeferred);
+        }
+    }
+
+    OutReport.bHeld = false;
+    Journal->TryGetBoolField(TEXT("held"), OutReport.bHeld);
+
+    const TSharedPtr<FJsonObject>* IssueFields;
+    if (Journal->TryGetObjectField(TEXT("issue_fields"), IssueFields))
+    {
+        OutReport.IssueFields = *IssueFields;
+    }
+
+    OutReport.NumExpected = 0;
+    OutReport.Pass = EPass::Done;
+    OutReport.bProcessing = false;
+    return true;
+}
+
+FString BH_UploadJournal::GetReportPath(const FString& IssueId) const
+{
+    return BH_StorageManager::GetJournalDir() / (IssueId + TEXT(".json"));
+}
+
+FString BH_UploadJournal::GetArtifactsDir(const FString& IssueId) const
+{
+    return BH_StorageManager::GetJournalDir() / IssueId;
+}
@@ -0,0 +1,195 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "BH_MediaTypes.h"
+
+class BH_MediaUploadManager;
+
+// Progress of a submitted report, persisted after every change
+enum class EBH_ReportState : uint8
+{
+    DraftCreated,
+    Uploading,
+    Published
+};
+
+// Progress of one file of a report
+enum class EBH_ArtifactState : uint8
+{
+    Pending,
+    Presigned,
+    Uploaded,       // In S3, only the confirmation is missing
+    Confirmed,
+    Failed          // The file is gone, it is not retried
+};
+
+/**
+ * Crash-safe journal of submitted reports in Saved/BetaHub/Journal. Each report's state and the state
+ * of each of its files are written to disk as they change, and the files themselves are kept in the
+ * journal until they are uploaded. Unfinished reports are resumed with exponential backoff, in the
+ * same session or on the next launch, until their retry budget is spent.
+ * Game thread only.
+ */
+class BH_UploadJournal
+{
+public:
+    static BH_UploadJournal& Get();
+
+    /**
+     * Loads the reports left over by earlier sessions and schedules them
+     */
+    void Initialize();
+
+    /**
+     * Records a draft issue, the first state of a report
+     *
+     * @param bSpeculative      Created before the player submitted it: its files are only uploaded (PreUploadReport)
+     *                          until ProcessReport, and the draft is deleted on the next launch if it never is
+     */
+    void BeginReport(const FString& BaseUrl, const FString& ProjectId, const FString& IssueId, const FString& ApiToken, bool bSpeculative = false);
+
+    /**
+     * Adds a file to a report. The file is moved (bMoveFile) or copied into the journal, log contents are
+     * written to a file, so the file survives until it is uploaded.
+     *
+     * @param bDeferred         Uploaded only after the report is published, e.g. the full-quality clip of a triage proxy
+     * @param FileName          Name the file is stored and uploaded with, the name of File.FilePath by default
+     */
+    void AddArtifact(const FString& IssueId, EBH_MediaType MediaType, const FBH_MediaFile& File, bool bMoveFile, bool bDeferred,
+        const FString& FileName = FString());
+
+    /**
+     * Files of the report are still being produced, e.g. the recorded video is being saved. The report is not
+     * completed until EndExpectedArtifacts, the files are added in between (usually deferred).
+     */
+    void ExpectArtifacts(const FString& IssueId);
+
+    /**
+     * Uploads the files added since ExpectArtifacts, in the background if the report is already published
+     */
+    void EndExpectedArtifacts(const FString& IssueId);
+
+    /**
+     * Uploads the pending files, publishes the report and uploads the deferred files.
+     * Unfinished work is retried later with backoff.
+     *
+     * @param OnPublished       Called when the report is published in this attempt
+     * @param OnFailure         Called when publishing fails in this attempt
+     */
+    void ProcessReport(
+        const FString& IssueId,
+        TFunction<void()> OnPublished = nullptr,
+        TFunction<void(const FString&)> OnFailure = nullptr
+    );
+
+    /**
+     * Uploads the files of a speculative report to S3 without attaching them to the issue, so ProcessReport
+     * only has to confirm them. Does not count as an attempt. ProcessReport may be called while it runs.
+     */
+    void PreUploadReport(const FString& IssueId);
+
+    /**
+     * Removes the files of a type that are not attached yet, e.g. the ones the player chose not to send
+     */
+    void RemoveArtifacts(const FString& IssueId, EBH_MediaType MediaType);
+
+    /**
+     * Issue fields (e.g. "description") sent to the draft before it is published, for reports whose text
+     * was not known when the draft was created
+     */
+    void SetIssueFields(const FString& IssueId, const TSharedRef<FJsonObject>& Fields);
+
+    /**
+     * Stops the uploads of a report that will not be submitted, deletes its draft on BetaHub and its files
+     */
+    void DiscardReport(const FString& IssueId);
+
+    /**
+     * Discards every report sent to an API, e.g. the mock server's when it stops
+     */
+    void DiscardReports(const FString& BaseUrl);
+
+    // True when a report that fails now will be attempted again
+    bool CanRetry(const FString& IssueId) const;
+
+private:
+    BH_UploadJournal();
+
+    struct FArtifact
+    {
+        EBH_MediaType MediaType;
+        FString FilePath;
+        FString Name;
+        EBH_ArtifactState State;
+        FString BlobSignedId;
+        bool bDeferred;
+    };
+
+    // Steps of one attempt, in order
+    enum class EPass : uint8
+    {
+        UploadBeforePublish,
+        UpdateIssue,
+        Publish,
+        UploadAfterPublish,
+        Done
+    };
+
+    struct FReport
+    {
+        FString IssueId;
+        FString BaseUrl;
+        FString ProjectId;
+        FString ApiToken;           // Token of the draft, only valid for this issue
+        EBH_ReportState State;
+        int32 Attempts;
+        FDateTime NextAttempt;
+        TArray<FArtifact> Artifacts;
+        bool bHeld;                 // Speculative, not submitted yet
+        TSharedPtr<FJsonObject> IssueFields;    // Not sent yet
+
+        // Not persisted
+        int32 NumExpected;          // ExpectArtifacts calls without EndExpectedArtifacts
+        EPass Pass;
+        bool bProcessing;
+        FTSTicker::FDelegateHandle RetryHandle;
+        TFunction<void()> OnPublished;
+        TFunction<void(const FString&)> OnFailure;
+    };
+
+    void ContinueReport(const FString& IssueId);
+    void UploadArtifacts(const FString& IssueId, bool bDeferred);
+    void UpdateIssue(const FString& IssueId);
+    void PublishReport(const FString& IssueId);
+
+    /**
+     * Ends the attempt after a failed request to BetaHub, a rejected request is not retried
+     */
+    void FailRequest(const FString& IssueId, FString ErrorMessage, int32 ResponseCode);
+    void FinishAttempt(const FString& IssueId);
+    void ScheduleAttempt(FReport& Report, double DelaySeconds);
+    void RemoveReport(const FString& IssueId);
+
+    /**
+     * @return              False if the artifacts directory could not be deleted
+     */
+    bool DeleteReportFiles(const FString& IssueId) const;
+
+    void SaveReport(const FReport& Report) const;
+    bool LoadReport(const FString& JournalPath, FReport& OutReport) const;
+
+    FString GetReportPath(const FString& IssueId) const;
+    FString GetArtifactsDir(const FString& IssueId) const;
+
+    TMap<FString, FReport> Reports;
+
+    // Upload managers of the reports being uploaded
+    TMap<FString, TSharedPtr<BH_MediaUploadManager>> ActiveUploads;
+
+    // First attempt plus the configured retries
+    int32 MaxAttempts;
+    bool bInitialized;
+};
@@ -0,0 +1,230 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#include "BH_UploadScheduler.h"
+#include "BH_PluginSettings.h"
+#include "BH_Log.h"
+#include "Misc/Paths.h"
+
+BH_UploadScheduler& BH_UploadScheduler::Get()
+{
+    static BH_UploadScheduler Instance;
+    return Instance;
+}
+
+BH_UploadScheduler::BH_UploadScheduler()
+    : MaxConcurrentUploads(FMath::Max(GetDefault<UBH_PluginSettings>()->MaxConcurrentUploads, 1))
+    , NextGroupId(1)
+{
+    S3Uploader = MakeShareable(new BH_S3Uploader());
+}
+
+int32 BH_UploadScheduler::CreateGroup()
+{
+    check(IsInGameThread());
+    return NextGroupId++;
+}
+
+void BH_UploadScheduler::Enqueue(
+    int32 GroupId,
+    const FUploadRequest& Request,
+    const BH_S3Uploader::FOnUploadComplete& OnComplete,
+    const BH_S3Uploader::FOnUploadProgress& OnProgress,
+    const BH_S3Uploader::FOnUploadStage& OnStage)
+{
+    check(IsInGameThread());
+
+    FJob Job;
+    Job.GroupId = GroupId;
+    Job.Priority = GetPriority(Request.MediaType);
+    Job.Request = Request;
+    Job.OnComplete = OnComplete;
+    Job.OnProgress = OnProgress;
+    Job.OnStage = OnStage;
+
+    // Insert after all jobs of the same or higher priority
+    int32 InsertIndex = PendingJobs.Num();
+    for (int32 Index = 0; Index < PendingJobs.Num(); Index++)
+    {
+        if (PendingJobs[Index].Priority < Job.Priority)
+        {
+            InsertIndex = Index;
+            break;
+        }
+    }
+    PendingJobs.Insert(MoveTemp(Job), InsertIndex);
+
+    StartPendingJobs();
+}
+
+void BH_UploadScheduler::CancelGroup(int32 GroupId)
+{
+    check(IsInGameThread());
+
+    TArray<FJob> CancelledJobs;
+    for (int32 Index = PendingJobs.Num() - 1; Index >= 0; Index--)
+    {
+        if (PendingJobs[Index].GroupId == GroupId)
+        {
+            CancelledJobs.Insert(MoveTemp(PendingJobs[Index]), 0);
+            PendingJobs.RemoveAt(Index);
+        }
+    }
+
+    TArray<int32> RunningUploadIds;
+    for (const TPair<int32, FJob>& Pair : RunningJobs)
+    {
+        if (Pair.Value.GroupId == GroupId)
+        {
+            RunningUploadIds.Add(Pair.Key);
+        }
+    }
+
+    if (CancelledJobs.Num() > 0 || RunningUploadIds.Num() > 0)
+    {
+        UE_LOG(LogBetaHub, Log, TEXT("Cancelling %d queued and %d running uploads"), CancelledJobs.Num(), RunningUploadIds.Num());
+    }
+
+    BH_S3Uploader::FUploadResult CancelledResult;
+    CancelledResult.bSuccess = false;
+    CancelledResult.ErrorMessage = TEXT("Upload cancelled by user");
+
+    for (const FJob& Job : CancelledJobs)
+    {
+        // The next queued file may have been prefetched
+        if (!Job.Request.FilePath.IsEmpty())
+        {
+            S3Uploader->DiscardPreparedFile(Job.Request.FilePath);
+        }
+        Job.OnComplete.ExecuteIfBound(CancelledResult);
+    }
+
+    // Completes each job through OnJobComplete
+    for (int32 UploadId : RunningUploadIds)
+    {
+        S3Uploader->CancelUpload(UploadId);
+    }
+}
+
+int32 BH_UploadScheduler::GetPriority(EBH_MediaType MediaType)
+{
+    switch (MediaType)
+    {
+        case EBH_MediaType::LogFile:
+        case EBH_MediaType::Bundle:
+            return 2;
+        case EBH_MediaType::Screenshot:
+            return 1;
+        case EBH_MediaType::Video:
+        default:
+            return 0;
+    }
+}
+
+void BH_UploadScheduler::StartPendingJobs()
+{
+    while (RunningJobs.Num() < MaxConcurrentUploads && PendingJobs.Num() > 0)
+    {
+        FJob Job = MoveTemp(PendingJobs[0]);
+        PendingJobs.RemoveAt(0);
+
+        const FUploadRequest& Request = Job.Request;
+
+        UE_LOG(LogBetaHub, Log, TEXT("Starting upload of %s (%d running, %d queued)"),
+            *FPaths::GetCleanFilename(Request.FilePath), RunningJobs.Num() + 1, PendingJobs.Num());
+
+        // The upload id is only known after the call, the result is routed through it
+        TSharedRef<int32> UploadIdRef = MakeShared<int32>(INDEX_NONE);
+        BH_S3Uploader::FOnUploadComplete OnComplete = BH_S3Uploader::FOnUploadComplete::CreateLambda(
+            [this, UploadIdRef](const BH_S3Uploader::FUploadResult& Result)
+            {
+                OnJobComplete(*UploadIdRef, Result);
+            });
+
+        int32 UploadId;
+        if (!Request.UploadedBlobSignedId.IsEmpty())
+        {
+            UploadId = S3Uploader->ConfirmExistingUpload(
+                Request.BaseUrl,
+                Request.ProjectId,
+                Request.IssueId,
+                Request.ApiToken,
+                BH_MediaTypeHelper::GetAPIEndpoint(Request.MediaType),
+                Request.UploadedBlobSignedId,
+                Request.CustomName,
+                OnComplete
+            );
+        }
+        else if (Request.BundleEntries.Num() > 0)
+        {
+            UploadId = S3Uploader->UploadBundleToS3(
+                Request.BaseUrl,
+                Request.ProjectId,
+                Request.IssueId,
+                Request.ApiToken,
+                Request.BundleEntries,
+                OnComplete,
+                Job.OnProgress
+            );
+        }
+        else if (Request.Content.IsValid())
+        {
+            UploadId = S3Uploader->UploadDataToS3(
+                Request.BaseUrl,
+                Request.ProjectId,
+                Request.IssueId,
+                Request.ApiToken,
+                BH_MediaTypeHelper::GetAPIEndpoint(Request.MediaType),
+                Request.Content.ToSharedRef(),
+                FPaths::GetCleanFilename(Request.FilePath),
+                Request.ContentType,
+                Request.CustomName,
+                OnComplete,
+                Job.OnProgress,
+                Job.OnStage
+            );
+        }
+        else
+        {
+            UploadId = S3Uploader->UploadFileToS3(
+                Request.BaseUrl,
+                Request.ProjectId,
+                Request.IssueId,
+                Request.ApiToken,
+                BH_MediaTypeHelper::GetAPIEndpoint(Request.MediaType),
+                Request.FilePath,
+                Request.ContentType,
+                Request.CustomName,
+                OnComplete,
+                Job.OnProgress,
+                Job.OnStage
+            );
+        }
+
+        if (Request.bHoldConfirmation)
+        {
+            S3Uploader->HoldConfirmation(UploadId);
+        }
+
+        *UploadIdRef = UploadId;
+        RunningJobs.Add(UploadId, MoveTemp(Job));
+    }
+
+    // Hash the next file while the running ones are being uploaded
+    if (PendingJobs.Num() > 0 && PendingJobs[0].Request.UploadedBlobSignedId.IsEmpty() && !PendingJobs[0].Request.Content.IsValid()
+        && PendingJobs[0].Request.BundleEntries.Num() == 0)
+    {
+        S3Uploader->PrefetchChecksum(PendingJobs[0].Request.FilePath, PendingJobs[0].Request.ContentType);
+    }
+}
+
+void BH_UploadScheduler::OnJobComplete(int32 UploadId, const BH_S3Uploader::FUploadResult& Result)
+{
+    FJob Job;
+    if (!RunningJobs.RemoveAndCopyValue(UploadId, Job))
+    {
+        return;
+    }
+
+    Job.OnComplete.ExecuteIfBound(Result);
+
+    StartPendingJobs();
+}
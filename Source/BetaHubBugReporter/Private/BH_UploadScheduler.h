@@ -0,0 +1,100 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BH_S3Uploader.h"
+#include "BH_MediaTypes.h"
+
+/**
+ * Runs the S3 uploads of all reports with a bounded number of uploads in flight.
+ * Small, quick-to-triage files (logs, screenshots) are started before videos, across reports.
+ * Game thread only.
+ */
+class BH_UploadScheduler
+{
+public:
+    /**
+     * A single file to upload
+     */
+    struct FUploadRequest
+    {
+        FString BaseUrl;
+        FString ProjectId;
+        FString IssueId;
+        FString ApiToken;
+        EBH_MediaType MediaType;
+        FString FilePath;               // For content in memory only the file name is used
+        TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> Content;    // Uploaded instead of the file when set
+        TArray<BH_ReportBundle::FEntry> BundleEntries;              // Packed and uploaded as one archive when set
+        FString ContentType;
+        FString CustomName;
+        int64 FileSize;
+        FString UploadedBlobSignedId;   // Set when the file is already in S3 and only needs confirming
+        bool bHoldConfirmation;         // Stop once the file is in S3, it is confirmed by a later upload
+    };
+
+    static BH_UploadScheduler& Get();
+
+    /**
+     * Creates an id used to cancel a set of uploads together, e.g. all uploads of one report
+     */
+    int32 CreateGroup();
+
+    /**
+     * Queues an upload. OnComplete is called exactly once, also when the upload is cancelled.
+     *
+     * @param GroupId           Group created with CreateGroup
+     * @param Request           File to upload
+     * @param OnComplete        Callback when the upload completes, fails or is cancelled
+     * @param OnProgress        Optional callback with the number of bytes sent to S3 so far
+     * @param OnStage           Optional callback when the upload reaches a milestone it can be resumed from
+     */
+    void Enqueue(
+        int32 GroupId,
+        const FUploadRequest& Request,
+        const BH_S3Uploader::FOnUploadComplete& OnComplete,
+        const BH_S3Uploader::FOnUploadProgress& OnProgress,
+        const BH_S3Uploader::FOnUploadStage& OnStage = BH_S3Uploader::FOnUploadStage()
+    );
+
+    /**
+     * Cancels queued uploads of a group and aborts its in-flight HTTP requests
+     */
+    void CancelGroup(int32 GroupId);
+
+    /**
+     * Higher priority uploads are started first, uploads of the same priority in the order they were queued
+     */
+    static int32 GetPriority(EBH_MediaType MediaType);
+
+private:
+    BH_UploadScheduler();
+
+    struct FJob
+    {
+        int32 GroupId;
+        int32 Priority;
+        FUploadRequest Request;
+        BH_S3Uploader::FOnUploadComplete OnComplete;
+        BH_S3Uploader::FOnUploadProgress OnProgress;
+        BH_S3Uploader::FOnUploadStage OnStage;
+    };
+
+    /**
+     * Starts queued jobs until the concurrency limit is reached
+     */
+    void StartPendingJobs();
+
+    void OnJobComplete(int32 UploadId, const BH_S3Uploader::FUploadResult& Result);
+
+    TSharedPtr<BH_S3Uploader> S3Uploader;
+
+    int32 MaxConcurrentUploads;
+    int32 NextGroupId;
+
+    // Sorted by priority, FIFO within a priority
+    TArray<FJob> PendingJobs;
+
+    // In-flight jobs keyed by their BH_S3Uploader upload id
+    TMap<int32, FJob> RunningJobs;
+};
@@ -9,11 +9,19 @@
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Guid.h"
+#include "Misc/ScopeLock.h"
 #include "BH_Runnable.h"
 #include "BH_FFmpeg.h"
+#include "BH_Stats.h"
+#include "BH_StorageManager.h"
 
 const int SEGMENT_DURATION_SECONDS = 10;
 FString BH_VideoEncoder::PreferredFfmpegOptions;
+FString BH_VideoEncoder::PreferredFfmpegEncoder;
+
+// Intra-frame codec used for capture when only a software H.264 encoder is available
+// (%d is the quality, 2 best ... 31 worst)
+#define IntraFrameCaptureOptions TEXT("-c:v mjpeg -q:v %d -pix_fmt yuvj420p")
 
 BH_VideoEncoder::BH_VideoEncoder(
     int32 InTargetFPS,
@@ -24,6 +32,15 @@ BH_VideoEncoder::BH_VideoEncoder(
         targetFPS(InTargetFPS),
         screenWidth(InScreenWidth),
         screenHeight(InScreenHeight),
+        proxyHeight(0),
+        proxyBitrateKbps(0),
+        bIntraFrameCaptureRequested(false),
+        segmentExtension(TEXT("mp4")),
+        storageLevel(EBH_StorageLevel::Normal),
+        bLastRunReducedResolution(false),
+        frameTimesOffset(0),
+        lastFrameTime(0.0),
+        currentSegment(0),
         frameSource(InFrameSource),
         thread(nullptr),
         bIsRecording(false),
@@ -34,7 +51,10 @@ BH_VideoEncoder::BH_VideoEncoder(
         LastSegmentCheckTime(FDateTime::Now())
 {
     // Generate a random 5-character string for segmentPrefix
-    segmentPrefix = FGuid::NewGuid().ToString(EGuidFormats::Digits).Left(5) + TEXT("_");
+    FString randomId = FGuid::NewGuid().ToString(EGuidFormats::Digits).Left(5);
+    segmentPrefix = randomId + TEXT("_");
+    // Must not match the segmentPrefix + "*" pattern of the full-quality segments
+    proxySegmentPrefix = randomId + TEXT("-proxy_");
     
     // check if width and height are multiples of 4
     if (screenWidth % 4 != 0 || screenHeight % 4 != 0)
@@ -57,7 +77,7 @@ BH_VideoEncoder::BH_VideoEncoder(
     }
 
     // Set up the segments directory in the Saved folder
-    segmentsDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("BH_VideoSegments"));
+    segmentsDir = BH_StorageManager::GetSegmentsDir();
     IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
     if (!PlatformFile.DirectoryExists(*segmentsDir))
     {
@@ -67,17 +87,29 @@ BH_VideoEncoder::BH_VideoEncoder(
     // Remove all existing segment files
     IFileManager& FileManager = IFileManager::Get();
     TArray<FString> SegmentFiles;
-    FileManager.FindFiles(SegmentFiles, *(segmentsDir / (segmentPrefix + TEXT("*.mp4"))), true, false);
-    for (const FString& SegmentFile : SegmentFiles)
+    for (const FString& Prefix : { segmentPrefix, proxySegmentPrefix })
     {
-        FileManager.Delete(*(segmentsDir / SegmentFile));
+        for (const TCHAR* Extension : { TEXT("*.mp4"), TEXT("*.mkv") })
+        {
+            FileManager.FindFiles(SegmentFiles, *(segmentsDir / (Prefix + Extension)), true, false);
+            for (const FString& SegmentFile : SegmentFiles)
+            {
+                FileManager.Delete(*(segmentsDir / SegmentFile));
+            }
+        }
     }
 
+    // Does not match the segment pattern, so it is never merged or removed as a segment
+    segmentListFile = FPaths::Combine(segmentsDir, (segmentPrefix + TEXT("list.csv")));
+    FileManager.Delete(*segmentListFile, false, false, true);
+
     outputFile = FPaths::Combine(segmentsDir, (segmentPrefix + TEXT("%06d.mp4")));
-    encodingSettings = TEXT("-y -f rawvideo -pix_fmt bgra -s ") +
+    proxyOutputFile = FPaths::Combine(segmentsDir, (proxySegmentPrefix + TEXT("%06d.mp4")));
+    inputSettings = TEXT("-y -f rawvideo -pix_fmt bgra -s ") +
         FString::FromInt(screenWidth) + TEXT("x") + FString::FromInt(screenHeight) +
         TEXT(" -r ") + FString::FromInt(targetFPS) +
-        TEXT(" -i - {OPTIONS} -pix_fmt yuv420p -f segment -segment_time 10 -reset_timestamps 1 ");
+        TEXT(" -i -");
+    outputSettings = TEXT("{OPTIONS} -f segment -segment_time 10 -reset_timestamps 1");
 
     stopEvent = FPlatformProcess::GetSynchEventFromPool(false);
     pauseEvent = FPlatformProcess::GetSynchEventFromPool(false);
@@ -105,10 +137,47 @@ bool BH_VideoEncoder::Init()
 
 uint32 BH_VideoEncoder::Run()
 {
-    RunEncoding();
+    // Walks the storage directories, so it is done here rather than on the game thread
+    storageLevel = BH_StorageManager::GetStorageLevel();
+
+    // ffmpeg is restarted with cheaper settings whenever the storage level gets more severe,
+    // and once storage frees up after it was exhausted
+    while (true)
+    {
+        if (storageLevel == EBH_StorageLevel::Exhausted)
+        {
+            if (!WaitForStorage())
+            {
+                break;
+            }
+        }
+        else if (!RunEncoding())
+        {
+            break;
+        }
+    }
+
+    // Lets StartRecording start again after the thread stopped on its own, e.g. when ffmpeg failed
+    bIsRecording = false;
     return 0;
 }
 
+bool BH_VideoEncoder::WaitForStorage()
+{
+    UE_LOG(LogBetaHub, Error, TEXT("Not enough storage for video recording, recording is paused until space is freed."));
+
+    while (!stopEvent->Wait(SegmentCheckInterval))
+    {
+        storageLevel = BH_StorageManager::GetStorageLevel();
+        if (storageLevel != EBH_StorageLevel::Exhausted)
+        {
+            UE_LOG(LogBetaHub, Log, TEXT("Storage was freed, video recording resumed."));
+            return true;
+        }
+    }
+    return false;
+}
+
 void BH_VideoEncoder::Stop()
 {
     UE_LOG(LogBetaHub, Log, TEXT("Stopping video encoding..."));
@@ -117,6 +186,40 @@ void BH_VideoEncoder::Stop()
     bIsRecording = false;
 }
 
+void BH_VideoEncoder::SetProxyRendition(int32 InHeight, int32 InBitrateKbps)
+{
+    if (bIsRecording)
+    {
+        UE_LOG(LogBetaHub, Warning, TEXT("Cannot change the proxy rendition while recording."));
+        return;
+    }
+
+    proxyHeight = FMath::Max(InHeight, 0);
+    proxyBitrateKbps = FMath::Max(InBitrateKbps, 0);
+}
+
+void BH_VideoEncoder::SetIntraFrameCapture(bool bEnable)
+{
+    if (bIsRecording)
+    {
+        UE_LOG(LogBetaHub, Warning, TEXT("Cannot change the capture codec while recording."));
+        return;
+    }
+
+    bIntraFrameCaptureRequested = bEnable;
+}
+
+void BH_VideoEncoder::SetCpuLimits(const FBH_EncoderCpuLimits& InCpuLimits)
+{
+    if (bIsRecording)
+    {
+        UE_LOG(LogBetaHub, Warning, TEXT("Cannot change the encoder CPU limits while recording."));
+        return;
+    }
+
+    cpuLimits = InCpuLimits;
+}
+
 void BH_VideoEncoder::StartRecording()
 {
     if (ffmpegPath.IsEmpty() || !FPaths::FileExists(ffmpegPath))
@@ -127,17 +230,38 @@ void BH_VideoEncoder::StartRecording()
 
     if (!bIsRecording)
     {
+        // The previous thread has finished, it stopped on its own or was stopped
+        if (thread)
+        {
+            thread->WaitForCompletion();
+            delete thread;
+            thread = nullptr;
+        }
+
         bIsRecording = true;
 
         if (PreferredFfmpegOptions.IsEmpty())
         {
             BH_FFmpegOptions Options = BH_FFmpeg::GetFFmpegPreferredOptions();
             PreferredFfmpegOptions = Options.Options;
+            PreferredFfmpegEncoder = Options.Encoder;
 
             UE_LOG(LogBetaHub, Log, TEXT("Preferred FFmpeg options: %s"), *PreferredFfmpegOptions);
         }
 
-        thread = FRunnableThread::Create(this, TEXT("BH_VideoEncoderThread"), 0, TPri_Normal);
+        // Hardware encoders are already cheap, MJPEG only pays off against software H.264
+        const bool bUseIntraFrameCapture = bIntraFrameCaptureRequested && PreferredFfmpegEncoder == TEXT("libx264");
+        segmentExtension = bUseIntraFrameCapture ? TEXT("mkv") : TEXT("mp4");
+        outputFile = FPaths::Combine(segmentsDir, (segmentPrefix + TEXT("%06d.") + segmentExtension));
+
+        if (bUseIntraFrameCapture)
+        {
+            UE_LOG(LogBetaHub, Log, TEXT("Capturing with intra-frame codec, clips are transcoded when a report is submitted."));
+        }
+
+        thread = FRunnableThread::Create(this, TEXT("BH_VideoEncoderThread"), 0,
+            cpuLimits.bLowerPriority ? TPri_BelowNormal : TPri_Normal,
+            cpuLimits.AffinityMask != 0 ? cpuLimits.AffinityMask : FPlatformAffinity::GetNoAffinityMask());
     }
 }
 
@@ -166,12 +290,12 @@ void BH_VideoEncoder::ResumeRecording()
     }
 }
 
-void BH_VideoEncoder::RunEncoding()
+bool BH_VideoEncoder::RunEncoding()
 {
     if (ffmpegPath.IsEmpty() || !FPaths::FileExists(ffmpegPath))
     {
         UE_LOG(LogBetaHub, Error, TEXT("Cannot run encoding. FFmpeg executable not found."));
-        return;
+        return false;
     }
 
     // Wait for the first valid frame
@@ -181,7 +305,7 @@ void BH_VideoEncoder::RunEncoding()
         if (!frameSource.IsValid())
         {
             UE_LOG(LogBetaHub, Error, TEXT("Frame source is not valid."));
-            return;
+            return false;
         }
 
         firstFrame = frameSource->GetFrame();
@@ -194,15 +318,33 @@ void BH_VideoEncoder::RunEncoding()
         if (stopEvent->Wait(0))
         {
             // stop event received, do not proceed any further
-            return;
+            return false;
         }
     }
 
-    FString settings = encodingSettings.Replace(TEXT("{Options}"), *PreferredFfmpegOptions);
-    FString commandLine = settings + TEXT(" \"") + FPaths::ConvertRelativePathToFull(outputFile) + TEXT("\"");
+    // Segments of different resolutions cannot be joined by stream copy
+    const bool bReducedResolution = storageLevel >= EBH_StorageLevel::ReducedResolution;
+    if (bReducedResolution != bLastRunReducedResolution)
+    {
+        FScopeLock Lock(&resolutionChangeLock);
+        resolutionChangeSegments.Add(GetNextSegmentNumber(segmentPrefix));
+        bLastRunReducedResolution = bReducedResolution;
+    }
+
+    // The list of the previous run was read when it ended, this run starts its own at frame 0
+    {
+        FScopeLock Lock(&segmentTimesLock);
+        IFileManager::Get().Delete(*segmentListFile, false, false, true);
+        frameTimes.Reset();
+        frameTimesOffset = 0;
+        currentSegment = GetNextSegmentNumber(segmentPrefix);
+    }
+
+    FString commandLine = BuildCommandLine();
 
     // Create and start the runnable for ffmpeg
-    FBH_Runnable* ffmpegRunnable = new FBH_Runnable(*ffmpegPath, commandLine);
+    FBH_Runnable* ffmpegRunnable = new FBH_Runnable(*ffmpegPath, commandLine, FPaths::ProjectDir(),
+        cpuLimits.bLowerPriority ? -1 : 0, cpuLimits.AffinityMask);
 
     FPlatformProcess::Sleep(0.2);
 
@@ -223,7 +365,7 @@ void BH_VideoEncoder::RunEncoding()
         }
 
         delete ffmpegRunnable;
-        return;
+        return false;
     }
     else
     {
@@ -233,9 +375,26 @@ void BH_VideoEncoder::RunEncoding()
     const float frameInterval = 1.0f / targetFPS;
 
     TArray<uint8> byteData;
+    bool bRestart = false;
+
+    const int32 numCores = FMath::Max(FPlatformMisc::NumberOfCoresIncludingHyperthreads(), 1);
+    double lastCpuSampleTime = FPlatformTime::Seconds();
+    double lastCpuSeconds = ffmpegRunnable->GetProcessCpuSeconds();
 
     while (!stopEvent->Wait(0))
     {
+        double now = FPlatformTime::Seconds();
+        if (now - lastCpuSampleTime >= 1.0)
+        {
+            double cpuSeconds = ffmpegRunnable->GetProcessCpuSeconds();
+            float cpuPercent = (float)(100.0 * (cpuSeconds - lastCpuSeconds) / ((now - lastCpuSampleTime) * numCores));
+            SET_FLOAT_STAT(STAT_BetaHub_EncoderCpuPercent, cpuPercent);
+            lastCpuSampleTime = now;
+            lastCpuSeconds = cpuSeconds;
+
+            ReadSegmentList();
+        }
+
         if (!pauseEvent->Wait(0))
         {
             if (!frameSource.IsValid())
@@ -266,6 +425,12 @@ void BH_VideoEncoder::RunEncoding()
                     // Write data to the pipe all at once
                     ffmpegRunnable->WriteToPipe(byteData);
 
+                    {
+                        FScopeLock Lock(&segmentTimesLock);
+                        lastFrameTime = FPlatformTime::Seconds();
+                        frameTimes.Add(lastFrameTime);
+                    }
+
                     // Read the buffered output
                     FString ffmpegOutput = ffmpegRunnable->GetBufferedOutput();
 
@@ -284,6 +449,12 @@ void BH_VideoEncoder::RunEncoding()
                 {
                     RemoveOldSegments();
                     LastSegmentCheckTime = FDateTime::Now();
+
+                    if (UpdateStorageLevel())
+                    {
+                        bRestart = true;
+                        break;
+                    }
                 }
             }
             else
@@ -319,9 +490,162 @@ void BH_VideoEncoder::RunEncoding()
     ffmpegRunnable->Terminate(true);
 
     delete ffmpegRunnable;
+
+    // The last segment is finished now
+    ReadSegmentList();
+
+    SET_FLOAT_STAT(STAT_BetaHub_EncoderCpuPercent, 0.0f);
+
+    return bRestart;
+}
+
+bool BH_VideoEncoder::UpdateStorageLevel()
+{
+    EBH_StorageLevel newLevel = BH_StorageManager::GetStorageLevel();
+
+    // Only ever degrade while recording, the level is re-evaluated when recording starts again
+    if (newLevel <= storageLevel)
+    {
+        return false;
+    }
+
+    storageLevel = newLevel;
+
+    switch (storageLevel)
+    {
+    case EBH_StorageLevel::ReducedBitrate:
+        UE_LOG(LogBetaHub, Warning, TEXT("Storage is running low, lowering the video bitrate."));
+        break;
+    case EBH_StorageLevel::ReducedResolution:
+        UE_LOG(LogBetaHub, Warning, TEXT("Storage is running low, lowering the video resolution."));
+        break;
+    case EBH_StorageLevel::Exhausted:
+        // Run waits for storage to free up
+        break;
+    default:
+        break;
+    }
+
+    return true;
+}
+
+FString BH_VideoEncoder::BuildCommandLine() const
+{
+    // Under storage pressure the full rendition is encoded at half resolution and/or a capped bitrate
+    const bool bReduceResolution = storageLevel >= EBH_StorageLevel::ReducedResolution;
+    const bool bReduceBitrate = storageLevel >= EBH_StorageLevel::ReducedBitrate;
+    const int32 fullWidth = bReduceResolution ? (screenWidth / 2) & ~1 : screenWidth;
+    const int32 fullHeight = bReduceResolution ? (screenHeight / 2) & ~1 : screenHeight;
+
+    FString fullOptions;
+    if (segmentExtension == TEXT("mkv"))
+    {
+        fullOptions = FString::Printf(IntraFrameCaptureOptions, bReduceBitrate ? 12 : 5) + GetThreadOptions(TEXT("mjpeg"));
+    }
+    else
+    {
+        fullOptions = PreferredFfmpegOptions + TEXT(" -pix_fmt yuv420p") + GetThreadOptions(PreferredFfmpegEncoder);
+        if (bReduceBitrate)
+        {
+            // Roughly 0.05 bits per pixel, enough to follow what happened on screen
+            int32 bitrateKbps = FMath::Max(500, (int32)((int64)fullWidth * fullHeight * targetFPS / 20000));
+            fullOptions += FString::Printf(TEXT(" -b:v %dk -maxrate %dk -bufsize %dk"), bitrateKbps, bitrateKbps, bitrateKbps * 2);
+        }
+    }
+
+    // Continue the numbering when ffmpeg is restarted, so the existing segments are not overwritten
+    FString fullOutput = outputSettings.Replace(TEXT("{Options}"), *fullOptions) +
+        FString::Printf(TEXT(" -segment_start_number %d"), GetNextSegmentNumber(segmentPrefix)) +
+        TEXT(" -segment_list_type csv -segment_list \"") + FPaths::ConvertRelativePathToFull(segmentListFile) + TEXT("\"") +
+        TEXT(" \"") + FPaths::ConvertRelativePathToFull(outputFile) + TEXT("\"");
+
+    if (proxyHeight <= 0)
+    {
+        FString scaleFilter = bReduceResolution ? FString::Printf(TEXT(" -vf scale=%d:%d"), fullWidth, fullHeight) : FString();
+        return inputSettings + scaleFilter + TEXT(" ") + fullOutput;
+    }
+
+    // Never upscale, and keep the height even as required by yuv420p
+    int32 scaledHeight = FMath::Min(proxyHeight, screenHeight) & ~1;
+
+    // One decode of the raw frames, split into two renditions encoded by the same process
+    FString fullFilter = bReduceResolution
+        ? FString::Printf(TEXT("[fullin]scale=%d:%d[full]"), fullWidth, fullHeight)
+        : TEXT("[fullin]null[full]");
+    FString filterGraph = FString::Printf(TEXT("-filter_complex \"[0:v]split=2[fullin][proxyin];%s;[proxyin]scale=-2:%d[proxy]\""), *fullFilter, scaledHeight);
+    if (cpuLimits.ThreadLimit > 0)
+    {
+        filterGraph += FString::Printf(TEXT(" -filter_complex_threads %d"), cpuLimits.ThreadLimit);
+    }
+
+    FString proxyOptions = PreferredFfmpegOptions + FString::Printf(TEXT(" -pix_fmt yuv420p -b:v %dk -maxrate %dk -bufsize %dk"),
+        proxyBitrateKbps, proxyBitrateKbps, proxyBitrateKbps * 2) + GetThreadOptions(PreferredFfmpegEncoder);
+    FString proxyOutput = outputSettings.Replace(TEXT("{Options}"), *proxyOptions) +
+        FString::Printf(TEXT(" -segment_start_number %d"), GetNextSegmentNumber(proxySegmentPrefix)) +
+        TEXT(" \"") + FPaths::ConvertRelativePathToFull(proxyOutputFile) + TEXT("\"");
+
+    return inputSettings + TEXT(" ") + filterGraph +
+        TEXT(" -map \"[full]\" ") + fullOutput +
+        TEXT(" -map \"[proxy]\" ") + proxyOutput;
+}
+
+int32 BH_VideoEncoder::GetNextSegmentNumber(const FString& Prefix) const
+{
+    IFileManager& FileManager = IFileManager::Get();
+    TArray<FString> SegmentFiles;
+    FileManager.FindFiles(SegmentFiles, *(segmentsDir / GetSegmentPattern(Prefix)), true, false);
+
+    int32 NextNumber = 0;
+    for (const FString& SegmentFile : SegmentFiles)
+    {
+        FString Number = FPaths::GetBaseFilename(SegmentFile).RightChop(Prefix.Len());
+        NextNumber = FMath::Max(NextNumber, FCString::Atoi(*Number) + 1);
+    }
+
+    return NextNumber;
+}
+
+FString BH_VideoEncoder::GetThreadOptions(const FString& Encoder) const
+{
+    if (cpuLimits.ThreadLimit <= 0)
+    {
+        return FString();
+    }
+
+    FString options = FString::Printf(TEXT(" -threads %d"), cpuLimits.ThreadLimit);
+
+    // x264 spawns its own lookahead threads on top of the frame threads
+    if (Encoder == TEXT("libx264"))
+    {
+        options += FString::Printf(TEXT(" -x264-params threads=%d:lookahead_threads=1"), cpuLimits.ThreadLimit);
+    }
+
+    return options;
+}
+
+FString BH_VideoEncoder::GetSegmentPattern(const FString& Prefix) const
+{
+    // The proxy is always H.264 so it can be uploaded without transcoding
+    const FString& Extension = Prefix == proxySegmentPrefix ? TEXT("mp4") : segmentExtension;
+    return Prefix + TEXT("*.") + Extension;
 }
 
 FString BH_VideoEncoder::MergeSegments(int32 MaxSegments)
+{
+    return MergeSegmentsWithPrefix(segmentPrefix, TEXT("Gameplay"), MaxSegments);
+}
+
+FString BH_VideoEncoder::MergeProxySegments(int32 MaxSegments)
+{
+    if (proxyHeight <= 0)
+    {
+        return FString();
+    }
+
+    return MergeSegmentsWithPrefix(proxySegmentPrefix, TEXT("GameplayProxy"), MaxSegments);
+}
+
+FString BH_VideoEncoder::MergeSegmentsWithPrefix(const FString& Prefix, const FString& OutputBaseName, int32 MaxSegments)
 {
     FString MergedFilePath;
 
@@ -341,7 +665,7 @@ FString BH_VideoEncoder::MergeSegments(int32 MaxSegments)
     // Get the list of segment files
     IFileManager& FileManager = IFileManager::Get();
     TArray<FString> SegmentFiles;
-    FileManager.FindFiles(SegmentFiles, *(segmentsDir / (segmentPrefix + TEXT("*.mp4"))), true, false);
+    FileManager.FindFiles(SegmentFiles, *(segmentsDir / GetSegmentPattern(Prefix)), true, false);
 
     // Sort and take the last MaxSegments
     SegmentFiles.Sort();
@@ -362,7 +686,7 @@ FString BH_VideoEncoder::MergeSegments(int32 MaxSegments)
     }
 
     // Create the concat file
-    FString ConcatFilePath = segmentsDir / TEXT("concat.txt");
+    FString ConcatFilePath = segmentsDir / (Prefix + TEXT("concat.txt"));
     FString ConcatFileContent;
     for (const FString& SegmentFile : SegmentFiles)
     {
@@ -374,18 +698,49 @@ FString BH_VideoEncoder::MergeSegments(int32 MaxSegments)
     }
     FFileHelper::SaveStringToFile(ConcatFileContent, *ConcatFilePath);
 
+    // The recorder lowers the resolution under storage pressure, segments on both sides of the change
+    // cannot be joined by stream copy
+    bool bMixedResolution = false;
+    if (Prefix == segmentPrefix && SegmentFiles.Num() > 1)
+    {
+        const int32 FirstNumber = FCString::Atoi(*FPaths::GetBaseFilename(SegmentFiles[0]).RightChop(Prefix.Len()));
+        const int32 LastNumber = FCString::Atoi(*FPaths::GetBaseFilename(SegmentFiles.Last()).RightChop(Prefix.Len()));
+
+        FScopeLock Lock(&resolutionChangeLock);
+        for (int32 ChangeSegment : resolutionChangeSegments)
+        {
+            bMixedResolution |= ChangeSegment > FirstNumber && ChangeSegment <= LastNumber;
+        }
+    }
+
     // Set the merged file path
-    MergedFilePath = FPaths::Combine(FPaths::ProjectSavedDir(), 
-        FString::Printf(TEXT("Gameplay_%s.mp4"), 
-        *FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S"))));
+    MergedFilePath = FPaths::Combine(BH_StorageManager::GetExportsDir(), 
+        FString::Printf(TEXT("%s_%s.%s"), *OutputBaseName,
+        *FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S")),
+        bMixedResolution ? TEXT("mp4") : *FPaths::GetExtension(SegmentFiles[0])));
 
     // FFmpeg command to merge segments
-    FString CommandLine = FString::Printf(TEXT("-f concat -safe 0 -i \"%s\" -c copy \"%s\""),
-        *FPaths::ConvertRelativePathToFull(ConcatFilePath),
-        *FPaths::ConvertRelativePathToFull(MergedFilePath));
+    FString CommandLine;
+    if (bMixedResolution)
+    {
+        // Scaled to the reduced resolution and encoded to H.264 once, below normal priority like a transcode
+        UE_LOG(LogBetaHub, Log, TEXT("Segments have different resolutions, re-encoding them."));
+        CommandLine = FString::Printf(TEXT("-f concat -safe 0 -i \"%s\" -vf scale=%d:%d,setsar=1 -c:v libx264 -preset veryfast -crf 23 -pix_fmt yuv420p -movflags +faststart \"%s\""),
+            *FPaths::ConvertRelativePathToFull(ConcatFilePath),
+            (screenWidth / 2) & ~1, (screenHeight / 2) & ~1,
+            *FPaths::ConvertRelativePathToFull(MergedFilePath));
+    }
+    else
+    {
+        CommandLine = FString::Printf(TEXT("-f concat -safe 0 -i \"%s\" -c copy \"%s\""),
+            *FPaths::ConvertRelativePathToFull(ConcatFilePath),
+            *FPaths::ConvertRelativePathToFull(MergedFilePath));
+    }
 
     // Create and start the runnable for merging
-    FBH_Runnable* MergeRunnable = new FBH_Runnable(*ffmpegPath, CommandLine);
+    FBH_Runnable* MergeRunnable = bMixedResolution
+        ? new FBH_Runnable(*ffmpegPath, CommandLine, FPaths::ProjectDir(), -1)
+        : new FBH_Runnable(*ffmpegPath, CommandLine);
 
     // Wait for the process to complete
     MergeRunnable->WaitForExit();
@@ -405,6 +760,7 @@ FString BH_VideoEncoder::MergeSegments(int32 MaxSegments)
         {
             FileManager.Delete(*(segmentsDir / SegmentFile));
         }
+        ForgetSegmentTimes(Prefix, SegmentFiles);
 
         delete MergeRunnable;
         return MergedFilePath;
@@ -419,13 +775,23 @@ FString BH_VideoEncoder::MergeSegments(int32 MaxSegments)
 }
 
 void BH_VideoEncoder::RemoveOldSegments()
+{
+    RemoveOldSegments(segmentPrefix);
+
+    if (proxyHeight > 0)
+    {
+        RemoveOldSegments(proxySegmentPrefix);
+    }
+}
+
+void BH_VideoEncoder::RemoveOldSegments(const FString& Prefix)
 {
     // Removing by count instead of age, because video can be paused and we don't
     // want to remove paused segments
     
     IFileManager& FileManager = IFileManager::Get();
     TArray<FString> SegmentFiles;
-    FileManager.FindFiles(SegmentFiles, *(segmentsDir / (segmentPrefix + TEXT("*.mp4"))), true, false);
+    FileManager.FindFiles(SegmentFiles, *(segmentsDir / GetSegmentPattern(Prefix)), true, false);
 
     // Sort segment files based on their numerical part
     SegmentFiles.Sort([](const FString& A, const FString& B)
@@ -443,6 +809,105 @@ void BH_VideoEncoder::RemoveOldSegments()
         UE_LOG(LogBetaHub, Log, TEXT("Removing old segment: %s"), *SegmentFilePath);
         FileManager.Delete(*SegmentFilePath);
     }
+
+    if (SegmentsToRemove > 0)
+    {
+        SegmentFiles.SetNum(SegmentsToRemove);
+        ForgetSegmentTimes(Prefix, SegmentFiles);
+    }
+}
+
+void BH_VideoEncoder::ReadSegmentList()
+{
+    FString List;
+    if (!FFileHelper::LoadFileToString(List, *segmentListFile))
+    {
+        return;
+    }
+
+    // "name,start,end" per finished segment, with the times in seconds of the run's stream. A line still
+    // being written by ffmpeg has no line break yet and is read next time.
+    TArray<FString> Lines;
+    List.Left(List.Find(TEXT("\n"), ESearchCase::CaseSensitive, ESearchDir::FromEnd) + 1).ParseIntoArrayLines(Lines);
+
+    FScopeLock Lock(&segmentTimesLock);
+
+    int64 finishedFrames = 0;
+    for (const FString& Line : Lines)
+    {
+        TArray<FString> Fields;
+        if (Line.ParseIntoArray(Fields, TEXT(","), false) != 3)
+        {
+            continue;
+        }
+
+        const int32 number = FCString::Atoi(*FPaths::GetBaseFilename(Fields[0]).RightChop(segmentPrefix.Len()));
+        if (number < currentSegment || frameTimes.Num() == 0)
+        {
+            continue;
+        }
+
+        // The raw frames come in at a constant rate, so a stream time is a frame number
+        const int64 firstFrame = FMath::RoundToInt64(FCString::Atod(*Fields[1]) * targetFPS);
+        const int64 endFrame = FMath::RoundToInt64(FCString::Atod(*Fields[2]) * targetFPS);
+        const int64 firstIndex = FMath::Clamp<int64>(firstFrame - frameTimesOffset, 0, frameTimes.Num() - 1);
+        const int64 lastIndex = FMath::Clamp<int64>(endFrame - 1 - frameTimesOffset, firstIndex, frameTimes.Num() - 1);
+
+        segmentTimes.Add(number, FSegmentTimes{ frameTimes[firstIndex], frameTimes[lastIndex] });
+        currentSegment = number + 1;
+        finishedFrames = FMath::Max(finishedFrames, endFrame);
+    }
+
+    // Only the frames of the segment being written are still needed
+    const int32 framesToDrop = (int32)FMath::Clamp<int64>(finishedFrames - frameTimesOffset, 0, frameTimes.Num());
+    if (framesToDrop > 0)
+    {
+        frameTimes.RemoveAt(0, framesToDrop);
+        frameTimesOffset += framesToDrop;
+    }
+}
+
+void BH_VideoEncoder::ForgetSegmentTimes(const FString& Prefix, const TArray<FString>& SegmentFiles)
+{
+    if (Prefix != segmentPrefix)
+    {
+        return;
+    }
+
+    FScopeLock Lock(&segmentTimesLock);
+    for (const FString& SegmentFile : SegmentFiles)
+    {
+        segmentTimes.Remove(FCString::Atoi(*FPaths::GetBaseFilename(SegmentFile).RightChop(Prefix.Len())));
+    }
+}
+
+bool BH_VideoEncoder::GetRecordedTimeRange(int32 MaxSegments, double& OutStart, double& OutEnd) const
+{
+    FScopeLock Lock(&segmentTimesLock);
+
+    // The clip ends with the segment being written, or the last finished one once ffmpeg stopped
+    const int32 lastSegment = frameTimes.Num() > 0 ? currentSegment : currentSegment - 1;
+    const int32 firstSegment = lastSegment - MaxSegments + 1;
+
+    bool bFound = false;
+    OutStart = TNumericLimits<double>::Max();
+    for (const TPair<int32, FSegmentTimes>& Segment : segmentTimes)
+    {
+        if (Segment.Key >= firstSegment && Segment.Key <= lastSegment)
+        {
+            OutStart = FMath::Min(OutStart, Segment.Value.FirstFrameTime);
+            bFound = true;
+        }
+    }
+
+    if (frameTimes.Num() > 0)
+    {
+        OutStart = FMath::Min(OutStart, frameTimes[0]);
+        bFound = true;
+    }
+
+    OutEnd = lastFrameTime;
+    return bFound;
 }
 
 int32 BH_VideoEncoder::GetSegmentCountToKeep()
@@ -452,25 +917,51 @@ int32 BH_VideoEncoder::GetSegmentCountToKeep()
 
 void BH_VideoEncoder::RemoveOldFiles()
 {
-    IFileManager& FileManager = IFileManager::Get();
-    TArray<FString> Files;
-    FileManager.FindFiles(Files, *(segmentsDir / TEXT("*.mp4")), true, false);
+    BH_StorageManager::RemoveStaleFiles();
+}
 
-    FDateTime CurrentTime = FDateTime::UtcNow();
-    FTimespan MaxAge = FTimespan::FromHours(24);
+bool BH_VideoEncoder::NeedsTranscode(const FString& VideoPath)
+{
+    return FPaths::GetExtension(VideoPath).Equals(TEXT("mkv"), ESearchCase::IgnoreCase);
+}
 
-    for (const FString& File : Files)
+FString BH_VideoEncoder::TranscodeForUpload(const FString& VideoPath)
+{
+    FString ffmpeg = BH_FFmpeg::GetFFmpegPath();
+    if (ffmpeg.IsEmpty())
     {
-        FString FilePath = FPaths::Combine(segmentsDir, File);
-        FFileStatData StatData = FileManager.GetStatData(*FilePath);
-        if (StatData.bIsValid)
-        {
-            FDateTime LastWriteTime = StatData.ModificationTime;
-            if ((CurrentTime - LastWriteTime) > MaxAge)
-            {
-                UE_LOG(LogBetaHub, Log, TEXT("Removing old file: %s"), *FilePath);
-                FileManager.Delete(*FilePath);
-            }
-        }
+        UE_LOG(LogBetaHub, Error, TEXT("Cannot transcode video. FFmpeg executable not found."));
+        return FString();
+    }
+
+    FString TranscodedPath = FPaths::ChangeExtension(VideoPath, TEXT("mp4"));
+
+    // Only used for software encoding, so a slower preset than the capture one is affordable here
+    FString CommandLine = FString::Printf(TEXT("-y -i \"%s\" -c:v libx264 -preset veryfast -crf 23 -pix_fmt yuv420p -movflags +faststart \"%s\""),
+        *FPaths::ConvertRelativePathToFull(VideoPath),
+        *FPaths::ConvertRelativePathToFull(TranscodedPath));
+
+    UE_LOG(LogBetaHub, Log, TEXT("Transcoding %s for upload..."), *VideoPath);
+
+    // Below normal priority so the game keeps its CPU time
+    FBH_Runnable* TranscodeRunnable = new FBH_Runnable(*ffmpeg, CommandLine, FPaths::ProjectDir(), -1);
+    TranscodeRunnable->WaitForExit();
+
+    int exitCode;
+    TranscodeRunnable->IsProcessRunning(&exitCode);
+
+    if (exitCode != 0)
+    {
+        UE_LOG(LogBetaHub, Error, TEXT("Failed to transcode video. Exit code: %d"), exitCode);
+        UE_LOG(LogBetaHub, Error, TEXT("FFmpeg Output: %s"), *TranscodeRunnable->GetBufferedOutput());
+        delete TranscodeRunnable;
+        IFileManager::Get().Delete(*TranscodedPath);
+        return FString();
     }
-}
\ No newline at end of file
+
+    delete TranscodeRunnable;
+    IFileManager::Get().Delete(*VideoPath);
+
+    UE_LOG(LogBetaHub, Log, TEXT("Video transcoded: %s"), *TranscodedPath);
+    return TranscodedPath;
+}
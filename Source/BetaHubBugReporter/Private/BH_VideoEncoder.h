@@ -7,20 +7,63 @@
 #include "Containers/Queue.h"
 #include "HAL/Runnable.h"
 #include "HAL/RunnableThread.h"
+#include "HAL/CriticalSection.h"
 #include "Misc/Paths.h"
+#include "BH_StorageManager.h"
+
+// Keeps the capture pipeline away from the game's cores and CPU time
+struct FBH_EncoderCpuLimits
+{
+    // Maximum number of encoder threads, 0 lets ffmpeg decide
+    int32 ThreadLimit = 0;
+    // Logical cores the ffmpeg process and the feeding threads may run on, 0 for no restriction
+    uint64 AffinityMask = 0;
+    // Runs the ffmpeg process and the feeding threads below normal priority
+    bool bLowerPriority = false;
+};
 
 class BH_VideoEncoder : public FRunnable
 {
 private:
-    FString encodingSettings;
+    FString inputSettings;
+    FString outputSettings;
     FString ffmpegPath;
     FString outputFile;
+    FString proxyOutputFile;
     FString segmentsDir;
     FString segmentPrefix;
+    FString proxySegmentPrefix;
     int32 targetFPS;
     int32 screenWidth;
     int32 screenHeight;
+    int32 proxyHeight;
+    int32 proxyBitrateKbps;
+    bool bIntraFrameCaptureRequested;
+    // "mp4" for H.264 capture, "mkv" for MJPEG capture
+    FString segmentExtension;
+    FBH_EncoderCpuLimits cpuLimits;
+    EBH_StorageLevel storageLevel;
+    // Numbers of the segments where the capture resolution changed, merging across them re-encodes
+    TArray<int32> resolutionChangeSegments;
+    bool bLastRunReducedResolution;
+    FCriticalSection resolutionChangeLock;
+    // Wall-clock times of the first and last frame of each finished segment, read from ffmpeg's segment list
+    struct FSegmentTimes
+    {
+        double FirstFrameTime;
+        double LastFrameTime;
+    };
+    TMap<int32, FSegmentTimes> segmentTimes;
+    // FPlatformTime::Seconds() of each frame piped to ffmpeg since its last finished segment, the first is frame frameTimesOffset of the run
+    TArray<double> frameTimes;
+    int64 frameTimesOffset;
+    double lastFrameTime;
+    // Number of the segment ffmpeg is writing
+    int32 currentSegment;
+    FString segmentListFile;
+    mutable FCriticalSection segmentTimesLock;
     static FString PreferredFfmpegOptions;
+    static FString PreferredFfmpegEncoder;
 
     TSharedPtr<FBH_FrameSource> frameSource;
 
@@ -36,9 +79,22 @@ private:
     FTimespan SegmentCheckInterval;
     FDateTime LastSegmentCheckTime;
 
-    void RunEncoding();
+    // Returns true when ffmpeg has to be restarted with settings for the new storage level
+    bool RunEncoding();
+    bool UpdateStorageLevel();
+    // Waits until storage is no longer exhausted, returns false if recording was stopped meanwhile
+    bool WaitForStorage();
+    FString BuildCommandLine() const;
+    FString GetThreadOptions(const FString& Encoder) const;
+    FString GetSegmentPattern(const FString& Prefix) const;
+    int32 GetNextSegmentNumber(const FString& Prefix) const;
+    // Stores the times of the segments ffmpeg finished since the last call
+    void ReadSegmentList();
+    void ForgetSegmentTimes(const FString& Prefix, const TArray<FString>& SegmentFiles);
     void RemoveOldSegments();
+    void RemoveOldSegments(const FString& Prefix);
     int32 GetSegmentCountToKeep();
+    FString MergeSegmentsWithPrefix(const FString& Prefix, const FString& OutputBaseName, int32 MaxSegments);
 
 public:
     BH_VideoEncoder(
@@ -58,6 +114,31 @@ public:
     void ResumeRecording();
     void EncodeFrame(TSharedPtr<FBH_Frame> frame);
 
+    // Enables a second, low-resolution rendition encoded from the same frames in the same ffmpeg process.
+    // Must be called before StartRecording. A height of 0 disables the proxy.
+    void SetProxyRendition(int32 InHeight, int32 InBitrateKbps);
+    bool HasProxyRendition() const { return proxyHeight > 0; }
+
+    // Captures with MJPEG instead of a software H.264 encoder; hardware encoders are always preferred.
+    // Must be called before StartRecording.
+    void SetIntraFrameCapture(bool bEnable);
+
+    // Must be called before StartRecording
+    void SetCpuLimits(const FBH_EncoderCpuLimits& InCpuLimits);
+
+    // True when a merged clip uses the intra-frame capture codec and must be transcoded before uploading
+    static bool NeedsTranscode(const FString& VideoPath);
+
+    // Converts an intra-frame clip to H.264 with a below-normal priority ffmpeg process.
+    // Blocks until done, so call it from a background thread. The source file is deleted on success.
+    // Returns the path of the transcoded clip or an empty string on failure.
+    static FString TranscodeForUpload(const FString& VideoPath);
+
     FString MergeSegments(int32 MaxSegments);
+
+    // FPlatformTime::Seconds() of the first and last frame of the clip MergeSegments(MaxSegments) would save now.
+    // Returns false when no frames were recorded since the last merge.
+    bool GetRecordedTimeRange(int32 MaxSegments, double& OutStart, double& OutEnd) const;
+    FString MergeProxySegments(int32 MaxSegments);
     void RemoveOldFiles(); // New function declaration
 };
@@ -8,6 +8,7 @@
 #endif
 
 #include "BH_PluginSettings.h"
+#include "BH_BandwidthLimiter.h"
 #include "Engine/Engine.h"
 
 #define LOCTEXT_NAMESPACE "FBetaHubBugReporterModule"
@@ -15,6 +16,9 @@
 
 void FBetaHubBugReporterModule::StartupModule()
 {
+    // Created here on the game thread, whichever upload path uses it first
+    BH_BandwidthLimiter::Get();
+
 #if WITH_EDITOR
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
 	if (ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
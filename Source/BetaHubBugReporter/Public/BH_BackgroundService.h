@@ -44,4 +44,16 @@ public:
     void CaptureScreenshot();
 
     UBH_GameRecorder* GetGameRecorder();
+    UBH_LogCapture* GetLogCapture();
+
+    /**
+     * The captured logs to attach to a report, only the recorded video's window with bAttachClipWindowLogs.
+     * Formatted on the calling thread, GetReportLogSnapshot leaves that to a worker thread.
+     */
+    FString GetReportLogs();
+
+    /**
+     * The logs of GetReportLogs without formatting them, null without a log capture
+     */
+    TSharedPtr<const FBH_LogSnapshot, ESPMode::ThreadSafe> GetReportLogSnapshot();
 };
\ No newline at end of file
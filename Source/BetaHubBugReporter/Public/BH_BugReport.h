@@ -4,11 +4,16 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "Templates/Function.h"
+#include "Async/Future.h"
 #include "BH_PluginSettings.h"
 #include "BH_GameRecorder.h"
 #include "BH_MediaTypes.h"
 #include "BH_BugReport.generated.h"
 
+class BH_HttpRequest;
+struct FBH_SpeculativeReport;
+struct FBH_ReportSubmission;
+
 /**
  * Represents a custom field value for bug report submission.
  * Supports both single string values and arrays (for multi-select fields).
@@ -51,6 +56,21 @@ struct BETAHUBBUGREPORTER_API FBH_CustomFieldValue
     }
 };
 
+/**
+ * Identifies the problem a bug report is about, so reports of the same problem can be matched on BetaHub
+ * before a full report is uploaded: the errors and warnings logged most often, on the same map and build.
+ */
+struct BETAHUBBUGREPORTER_API FBH_ReportSignature
+{
+    // Hex SHA-1 of the fields below, empty if nothing was logged to match reports on
+    FString Hash;
+
+    // Normalized log lines, see UBH_LogCapture::GetTopProblems
+    TArray<FString> Problems;
+    FString Map;
+    FString Build;
+};
+
 /**
  * Handles the submission of bug reports to BetaHub
  */
@@ -88,6 +108,8 @@ public:
      * - Each media file in the arrays can have a custom display name via the Name field
      * - Log files support both file paths (FilePath) and string content (Content)
      * - Videos and Screenshots only support file paths
+     * - The draft issue is created while the recording is saved and the media is staged, uploads start once all are done
+     * - The submission can be stopped with CancelSubmission until it succeeds or fails
      * @param CustomFields          Optional map of custom field values, keyed by field identifier (snake_case).
      *                              Use FBH_CustomFieldValue::FromString() for text, single select, and boolean fields.
      *                              Use FBH_CustomFieldValue::FromArray() for multi-select fields.
@@ -154,7 +176,169 @@ public:
         const FString& ReleaseLabel = TEXT(""),
         const FString& ReleaseId = TEXT(""));
 
+    /**
+     * Cancels the report submitted last with SubmitReportWithMedia until it succeeds or fails: its draft is
+     * deleted, its uploads are stopped, its staged files are deleted and its OnFailure is called
+     */
+    void CancelSubmission();
+
+    /**
+     * Adds a screenshot that is still being encoded to the next SubmitReportWithMedia call, which uploads it
+     * once it is written. The file is moved into the upload journal.
+     *
+     * @param Screenshot            Path of the written screenshot, empty if it could not be captured
+     */
+    void AddPendingScreenshot(TFuture<FString>&& Screenshot);
+
+    /**
+     * Starts a bug report as soon as the report form opens, so submitting it only sends the text:
+     * creates the draft issue, saves the recorded video and uploads it with the screenshots and logs
+     * while the player is typing. The files are attached once the report is submitted.
+     * The recording is restarted when the report is submitted, otherwise by the caller.
+     *
+     * @param Settings              Plugin settings containing project information and configuration
+     * @param GameRecorder          Optional game recorder, its recorded video is saved right away
+     * @param Screenshots           Screenshot files the player may send
+     * @param Logs                  Log files the player may send
+     */
+    void BeginSpeculativeReport(
+        UBH_PluginSettings* Settings,
+        UBH_GameRecorder* GameRecorder,
+        const TArray<FBH_MediaFile>& Screenshots,
+        const TArray<FBH_MediaFile>& Logs);
+
+    /**
+     * Submits the report started with BeginSpeculativeReport: sends its text, attaches the media the player
+     * chose to send and publishes it. Submitted like SubmitReportWithMedia if the draft could not be created.
+     *
+     * @param OnSuccess             Callback function when submission succeeds
+     * @param OnFailure             Callback function when submission fails
+     */
+    void FinishSpeculativeReport(
+        const FString& Description,
+        const FString& StepsToReproduce,
+        bool bIncludeVideo,
+        bool bIncludeScreenshots,
+        bool bIncludeLogs,
+        TFunction<void()> OnSuccess,
+        TFunction<void(const FString&)> OnFailure);
+
+    /**
+     * Deletes the draft and the media of a report started with BeginSpeculativeReport that will not be submitted
+     */
+    void AbandonSpeculativeReport();
+
+    /**
+     * Computes the signature of a report sent now
+     *
+     * @param Settings              Plugin settings, the release label identifies the build
+     * @param World                 World the player is in, identifies the map
+     * @param Problems              Errors and warnings logged most often, most important first
+     */
+    static FBH_ReportSignature ComputeSignature(const UBH_PluginSettings* Settings, const UWorld* World, const TArray<FString>& Problems);
+
+    /**
+     * Sets the signature sent with the draft issue, so later reports of the same problem can be matched to it
+     */
+    void SetSignature(const FBH_ReportSignature& InSignature);
+
+    /**
+     * Looks up an open issue with the same signature. A server that does not support signatures finds none.
+     *
+     * @param OnComplete            Called on the game thread, with an empty IssueId if there is no such issue
+     */
+    static void FindDuplicateIssue(
+        UBH_PluginSettings* Settings,
+        const FBH_ReportSignature& Signature,
+        TFunction<void(const FString& IssueId, const FString& IssueTitle)> OnComplete);
+
+    /**
+     * Adds the player's report to an existing issue found by FindDuplicateIssue instead of creating a new one.
+     * Only the text, the signature's log lines and an optional screenshot are sent.
+     *
+     * @param IssueId               Issue returned by FindDuplicateIssue
+     * @param ScreenshotPath        Screenshot to attach, empty for none
+     */
+    void SubmitDuplicateReport(
+        UBH_PluginSettings* Settings,
+        const FString& IssueId,
+        const FString& Description,
+        const FString& StepsToReproduce,
+        const FString& ScreenshotPath,
+        TFunction<void()> OnSuccess,
+        TFunction<void(const FString&)> OnFailure);
+
 private:
+    // Sent with the draft issue when set
+    FBH_ReportSignature Signature;
+
+    // State of a report started with BeginSpeculativeReport, shared with its requests
+    TSharedPtr<FBH_SpeculativeReport> Speculative;
+
+    static void CompleteSpeculativeReport(const TSharedRef<FBH_SpeculativeReport>& State);
+
+    // State of the report submitted last with SubmitReportWithMedia, shared with its stages
+    TSharedPtr<FBH_ReportSubmission> Submission;
+
+    // Screenshots added with AddPendingScreenshot, joined with the next submission
+    TArray<TFuture<FString>> PendingScreenshots;
+
+    /**
+     * Applies the result of a submission stage on the game thread once it is ready, then advances the submission
+     */
+    template <typename ResultType, typename ApplyType>
+    static void JoinStage(const TSharedRef<FBH_ReportSubmission>& State, TFuture<ResultType>&& Stage, ApplyType Apply);
+
+    /**
+     * Moves the media into the upload journal and starts uploading it once every stage the report waits for is done
+     */
+    static void AdvanceSubmission(const TSharedRef<FBH_ReportSubmission>& State);
+
+    static void AbortSubmission(const TSharedRef<FBH_ReportSubmission>& State, const FString& Error);
+
+    /**
+     * Deletes the draft and the files of a failed or cancelled submission, including those of stages finishing later
+     */
+    static void DiscardSubmission(const TSharedRef<FBH_ReportSubmission>& State);
+
+    /**
+     * Creates the request of a draft issue, media is attached to the draft before it is published
+     */
+    static TSharedPtr<BH_HttpRequest> CreateDraftRequest(
+        UBH_PluginSettings* Settings,
+        const FString& Description,
+        const FString& StepsToReproduce,
+        const FString& ReleaseLabel,
+        const FString& ReleaseId,
+        const TMap<FString, FBH_CustomFieldValue>& CustomFields,
+        const FBH_ReportSignature& Signature);
+
+    /**
+     * Saves the recorded video (and its triage proxy) on the game thread, transcoding it off the game thread if needed
+     *
+     * @param bRestartRecording     Starts a new recording once the video is saved
+     * @param OnSaved               Called on the game thread, the paths are empty if there is no video
+     */
+    static void SaveRecordedVideo(
+        TWeakObjectPtr<UBH_GameRecorder> WeakGameRecorder,
+        TWeakObjectPtr<UBH_PluginSettings> WeakSettings,
+        bool bRestartRecording,
+        TFunction<void(const FString& VideoPath, const FString& ProxyPath)> OnSaved);
+
+    /**
+     * Adds the media of a report to the upload journal, the recorded video is moved into it
+     *
+     * @param bDeferVideos          Videos are uploaded after the report is published (bUploadVideoAfterPublishing)
+     */
+    static void AddReportArtifacts(
+        const FString& IssueId,
+        const TArray<FBH_MediaFile>& Videos,
+        const TArray<FBH_MediaFile>& Screenshots,
+        const TArray<FBH_MediaFile>& Logs,
+        const FString& VideoPath,
+        const FString& ProxyPath,
+        bool bDeferVideos);
+
     void SubmitReportWithMediaAsync(
         UBH_PluginSettings* Settings,
         UBH_GameRecorder* GameRecorder,
@@ -182,13 +366,4 @@ private:
     static FString ParseErrorFromResponse(const FString& Response);
     static FString ParseTokenFromResponse(const FString& Response);
     void ShowPopup(const FString& Message);
-
-    // New method for publishing draft issue
-    static void PublishIssue(
-        UBH_PluginSettings* Settings,
-        const FString& IssueId,
-        const FString& ApiToken,
-        TFunction<void()> OnSuccess,
-        TFunction<void(const FString&)> OnFailure
-    );
 };
\ No newline at end of file
@@ -16,6 +16,9 @@ public:
     virtual void Initialize(FSubsystemCollectionBase& Collection) override;
     virtual void Deinitialize() override;
 
+    // Null if the background service is not spawned on startup
+    UBH_Manager* GetManager() const;
+
 protected:
     UPROPERTY(BlueprintReadOnly, Transient, Category = "BetaHub")
     TObjectPtr<UBH_Manager> Manager = nullptr;
@@ -58,6 +58,9 @@ private:
 public:
     UBH_Manager();
 
+    // Null until StartService is called
+    UBH_BackgroundService* GetBackgroundService() const;
+
     UFUNCTION(BlueprintCallable, Category="Bug Report")
     void StartService(UGameInstance* GI);
 
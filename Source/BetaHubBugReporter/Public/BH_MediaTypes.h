@@ -5,6 +5,8 @@
 #include "Misc/Paths.h"
 #include "BH_MediaTypes.generated.h"
 
+class FBH_LogSnapshot;
+
 /**
  * Enum representing different types of media that can be uploaded to BetaHub
  */
@@ -14,6 +16,18 @@ enum class EBH_MediaType : uint8
     Screenshot      UMETA(DisplayName = "Screenshot"),
     Video          UMETA(DisplayName = "Video"),
     LogFile        UMETA(DisplayName = "Log File"),
+    Bundle         UMETA(DisplayName = "Bundle"),      // Archive of several small files of a report, expanded by BetaHub
+};
+
+/**
+ * Integrity checksum sent with presigned uploads and verified by S3
+ */
+UENUM()
+enum class EBH_ChecksumAlgorithm : uint8
+{
+    MD5             UMETA(DisplayName = "MD5"),
+    CRC32C          UMETA(DisplayName = "CRC32C"),
+    SHA256          UMETA(DisplayName = "SHA-256"),
 };
 
 /**
@@ -45,6 +59,11 @@ struct BETAHUBBUGREPORTER_API FBH_MediaFile
     UPROPERTY(BlueprintReadWrite, Category = "BetaHub")
     FString Name;
 
+    /**
+     * Captured logs to upload instead of Content, formatted into it on a worker thread when the report is submitted
+     */
+    TSharedPtr<const FBH_LogSnapshot, ESPMode::ThreadSafe> LogSnapshot;
+
     FBH_MediaFile()
         : FilePath(TEXT(""))
         , Content(TEXT(""))
@@ -81,6 +100,8 @@ public:
                 return TEXT("video_clips");
             case EBH_MediaType::LogFile:
                 return TEXT("log_files");
+            case EBH_MediaType::Bundle:
+                return TEXT("bundles");
             default:
                 checkf(false, TEXT("Unknown media type"));
                 return TEXT("");
@@ -102,6 +123,8 @@ public:
                 return TEXT("Video");
             case EBH_MediaType::LogFile:
                 return TEXT("Log File");
+            case EBH_MediaType::Bundle:
+                return TEXT("Bundle");
             default:
                 return TEXT("Unknown");
         }
@@ -136,6 +159,9 @@ public:
             if (Extension == TEXT("log") || Extension == TEXT("txt")) return TEXT("text/plain");
             if (Extension == TEXT("json")) return TEXT("application/json");
             if (Extension == TEXT("xml")) return TEXT("application/xml");
+
+            // Archives
+            if (Extension == TEXT("gz") || Extension == TEXT("tgz")) return TEXT("application/gzip");
         }
 
         // Default content types by media type
@@ -147,6 +173,8 @@ public:
                 return TEXT("video/mp4");
             case EBH_MediaType::LogFile:
                 return TEXT("text/plain");
+            case EBH_MediaType::Bundle:
+                return TEXT("application/gzip");
             default:
                 return TEXT("application/octet-stream");
         }
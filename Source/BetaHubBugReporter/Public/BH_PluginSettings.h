@@ -5,6 +5,7 @@
 #include "UObject/NoExportTypes.h"
 #include "BH_ReportFormWidget.h"
 #include "BH_PopupWidget.h"
+#include "BH_MediaTypes.h"
 #include "BH_PluginSettings.generated.h"
 
 UCLASS(Config=Game, defaultconfig)
@@ -59,6 +60,122 @@ public:
         meta=(ToolTip="The maximum height of the recorded bug report video. The video will be scaled down if the viewport height exceeds this value."))
     int32 MaxVideoHeight;
 
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="Record a small triage proxy video next to the full-quality clip from the same frames. The proxy is uploaded with the report, the full clip is uploaded in the background once the report is published."))
+    bool bRecordTriageProxy;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(EditCondition="bRecordTriageProxy", ToolTip="The height of the triage proxy video. It is never larger than the full-quality video."))
+    int32 TriageProxyHeight;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(EditCondition="bRecordTriageProxy", ToolTip="The target bitrate of the triage proxy video (in kbps)."))
+    int32 TriageProxyBitrateKbps;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="When no hardware H.264 encoder is available, record with the much cheaper MJPEG codec and convert the clip to H.264 only when a report is submitted. Uses more disk space for the recording buffer."))
+    bool bUseIntraFrameCaptureCodec;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ClampMin="0", ToolTip="The maximum number of threads the video encoder may use. 0 lets the encoder decide, which usually means one thread per core."))
+    int32 EncoderThreadLimit;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="Bitmask of logical cores the video encoder process and its feeding threads may run on (bit 0 is core 0). 0 allows all cores."))
+    int64 EncoderAffinityMask;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="Run the video encoder process and its feeding threads below normal priority, so they yield to the game and render threads."))
+    bool bLowerEncoderPriority;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ClampMin="0", ToolTip="The maximum disk space (in MB) used by video segments, exported clips, temporary upload files and reports waiting to be uploaded together. The video quality is lowered when it gets close to the limit, and recording pauses at the limit until space is freed, e.g. once pending reports are uploaded. 0 means no limit."))
+    int32 MaxStorageMB;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ClampMin="0", ToolTip="The free disk space (in MB) the recorder always leaves. The video quality is lowered when there is less, and recording pauses below a quarter of it. 0 means no limit."))
+    int32 MinFreeDiskSpaceMB;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="Directory for the rolling video segments, e.g. a RAM disk. Leave empty to use Saved/BH_VideoSegments."))
+    FString VideoSegmentsDirectory;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="The checksum used to verify uploaded files. CRC32C and SHA-256 are computed with CPU instructions when available and are much faster than MD5 on large videos. Run BetaHub.BenchmarkChecksums to compare them on a machine."))
+    EBH_ChecksumAlgorithm UploadChecksumAlgorithm;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="Compress log and other text files with gzip before uploading them. They are stored with Content-Encoding: gzip and are decompressed transparently when downloaded."))
+    bool bCompressLogUploads;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ClampMin="1", ClampMax="1024", ToolTip="The maximum size of the logs kept in memory for bug reports, in MB. The oldest logs are dropped beyond it."))
+    int32 MaxCapturedLogMB;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="Attach only the logs covering the recorded video, plus LogLeadInSeconds before it, instead of all logs captured this session."))
+    bool bAttachClipWindowLogs;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ClampMin="0", EditCondition="bAttachClipWindowLogs", ToolTip="How many seconds of logs before the recorded video are attached, when only the video's logs are attached."))
+    int32 LogLeadInSeconds;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ClampMin="1", ClampMax="16", ToolTip="The maximum number of files uploaded at the same time, across all reports. Logs and screenshots are uploaded before videos."))
+    int32 MaxConcurrentUploads;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="Request upload URLs and confirm uploads for several files of a report in one API call. Falls back to one call per file if the server does not support it."))
+    bool bBatchUploadRequests;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="Pack the screenshots and logs of a report into one compressed archive that is uploaded as a single file and unpacked by BetaHub. Videos and files over 4 MB are still uploaded on their own. Requires a BetaHub server that accepts report bundles."))
+    bool bBundleSmallAttachments;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ClampMin="0", ClampMax="168", ToolTip="How long (in hours) files uploaded with a report are remembered by their checksum. A later report attaching an identical file (e.g. the same screenshot) references the uploaded copy instead of uploading it again. 0 disables the cache."))
+    int32 UploadCacheHours;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ClampMin="0", ToolTip="Files of at least this size (in MB) are uploaded in parts that are sent in parallel, retried individually and resumed after an interruption. 0 uploads every file in a single request."))
+    int32 MultipartUploadThresholdMB;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ClampMin="5", ClampMax="512", ToolTip="The size (in MB) of each part of a multipart upload. S3 requires at least 5 MB."))
+    int32 MultipartPartSizeMB;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ClampMin="1", ClampMax="16", ToolTip="The maximum number of parts of one file uploaded at the same time."))
+    int32 MaxConcurrentUploadParts;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ClampMin="0", ToolTip="How many times a report that could not be fully sent is retried, with growing delays and also in later sessions. Reports waiting to be sent are kept in Saved/BetaHub/Journal."))
+    int32 MaxUploadRetryAttempts;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ClampMin="0", ToolTip="The maximum upload rate in kilobits per second while the player is in a network session and playing, so uploads do not compete with the game's netcode. 0 means unlimited."))
+    int32 UploadBandwidthLimitKbps;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ClampMin="0", ToolTip="The maximum upload rate in kilobits per second in menus, while paused, idle or not connected to a session. 0 means unlimited."))
+    int32 IdleUploadBandwidthLimitKbps;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="While the player is in a network session, slow uploads down when the game's ping rises or packets get lost, and speed them up again when the connection recovers."))
+    bool bAdaptiveUploadBandwidth;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="Create the report and upload its video, screenshot and logs as soon as the report form opens, so submitting only sends the text. Reports of closed forms are deleted. Requires a BetaHub server that accepts updates of draft reports."))
+    bool bPreUploadWhileFormOpen;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="Publish bug reports as soon as their text, screenshots and logs are uploaded, so the report form closes right away. Videos are uploaded in the background and attached to the published report when they are done."))
+    bool bUploadVideoAfterPublishing;
+
+    UPROPERTY(EditAnywhere, Config, Category="Settings",
+        meta=(ToolTip="When the report form opens, look up an open issue with the same errors and warnings in the log, on the same map and build. If one is found, the player can add their report to it with only a screenshot instead of filing a new issue with a video. Requires a BetaHub server that supports report signatures."))
+    bool bDetectDuplicateReports;
+
     UPROPERTY(EditAnywhere, Config, Category="Settings", 
         meta=(ToolTip="The path to the widget that will be used to display the bug report form."))
     TSubclassOf<UBH_ReportFormWidget> ReportFormWidgetClass;
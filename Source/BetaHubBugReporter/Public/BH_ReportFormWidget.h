@@ -4,6 +4,7 @@
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
 #include "BH_GameRecorder.h"
+#include "BH_BugReport.h"
 #include "Components/Button.h"
 #include "Components/MultiLineEditableTextBox.h"
 #include "Components/TextBlock.h"
@@ -30,8 +31,22 @@ private:
     FString ScreenshotPath;
     FString LogFileContents;
 
+    // Captured logs, formatted when the report is submitted instead of when the form opens
+    TSharedPtr<const FBH_LogSnapshot, ESPMode::ThreadSafe> LogSnapshot;
+
     UBH_PluginSettings* Settings;
 
+    // Bug report started when the form opened (bPreUploadWhileFormOpen), null once submitted or abandoned
+    UPROPERTY()
+    UBH_BugReport* SpeculativeReport;
+
+    // Errors and warnings logged most often, the report's signature is computed from them
+    TArray<FString> LogProblems;
+    FBH_ReportSignature Signature;
+
+    // Open issue with the same signature (bDetectDuplicateReports), empty if none was found
+    FString DuplicateIssueId;
+
     EBH_ReportType CurrentReportType;
 
     bool bCursorStateModified;
@@ -48,10 +63,18 @@ private:
     UFUNCTION()
     void OnSuggestionCheckBoxChanged(bool bIsChecked);
 
+    UFUNCTION()
+    void OnDuplicateClicked();
+
     void SetReportType(EBH_ReportType NewType);
     void UpdateFormForReportType();
     void ShowPopup(const FString& Title, const FString& Description);
 
+    /**
+     * Adds the logs to attach to the report, if there are any
+     */
+    void AddLogFile(TArray<FBH_MediaFile>& Logs) const;
+
 protected:
     virtual void NativeOnInitialized() override;
     virtual void NativeDestruct() override;
@@ -102,6 +125,13 @@ public:
     UPROPERTY(meta = (BindWidget))
     TObjectPtr<UTextBlock> SubmitLabel;
 
+    // Shown when an open issue with the same signature is found, forms without them can use OnDuplicateIssueFound
+    UPROPERTY(meta = (BindWidgetOptional))
+    TObjectPtr<UButton> DuplicateButton;
+
+    UPROPERTY(meta = (BindWidgetOptional))
+    TObjectPtr<UTextBlock> DuplicateLabel;
+
 
     UFUNCTION(BlueprintCallable, Category="BugReport")
     void Setup(UBH_PluginSettings* InSettings, UBH_GameRecorder* InGameRecorder, const FString& InScreenshotPath, const FString& InLogFileContents, bool bTryCaptureMouse);
@@ -109,6 +139,28 @@ public:
     UFUNCTION(BlueprintCallable, Category="BugReport")
     void SubmitReport();
 
+    /**
+     * Adds the player's report to the open issue found when the form opened, with only its text and screenshot
+     */
+    UFUNCTION(BlueprintCallable, Category="BugReport")
+    void SubmitDuplicateReport();
+
+    /**
+     * Called when an open issue with the same errors and warnings, map and build is found (bDetectDuplicateReports)
+     */
+    UFUNCTION(BlueprintImplementableEvent, Category="BugReport")
+    void OnDuplicateIssueFound(const FString& IssueTitle);
+
+    /**
+     * Sets the errors and warnings the report's signature is computed from, call it before Setup
+     */
+    void SetLogProblems(const TArray<FString>& InLogProblems);
+
+    /**
+     * Sets the captured logs to attach instead of Setup's log contents, call it before Setup
+     */
+    void SetLogSnapshot(const TSharedPtr<const FBH_LogSnapshot, ESPMode::ThreadSafe>& InLogSnapshot);
+
     UFUNCTION(BlueprintCallable, Category="Cursor")
     void SetCursorState();
 
@@ -0,0 +1,64 @@
+// Copyright (c) 2024-2026 Upsoft sp. z o. o.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "BH_SubmitReportAction.generated.h"
+
+class UBH_BugReport;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FBH_OnReportSubmitted, const FString&, Error);
+
+/**
+ * Latent Blueprint node submitting a bug report without the report form. The screenshot is encoded,
+ * the recording saved and the logs staged while the draft issue is created.
+ */
+UCLASS()
+class BETAHUBBUGREPORTER_API UBH_SubmitReportAction : public UBlueprintAsyncActionBase
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * Submits a bug report with the media of the running background service
+     *
+     * @param bIncludeVideo         Attach the recorded gameplay video
+     * @param bIncludeScreenshot    Attach a screenshot of the current frame
+     * @param bIncludeLogs          Attach the logs captured this session
+     */
+    UFUNCTION(BlueprintCallable, Category="BetaHub", meta=(BlueprintInternalUseOnly="true", WorldContext="WorldContextObject"))
+    static UBH_SubmitReportAction* SubmitBugReport(
+        UObject* WorldContextObject,
+        const FString& Description,
+        const FString& StepsToReproduce,
+        bool bIncludeVideo = true,
+        bool bIncludeScreenshot = true,
+        bool bIncludeLogs = true);
+
+    /**
+     * Stops the submission until it succeeds, the draft issue and its media are deleted and OnFailure is called
+     */
+    UFUNCTION(BlueprintCallable, Category="BetaHub")
+    void Cancel();
+
+    UPROPERTY(BlueprintAssignable)
+    FBH_OnReportSubmitted OnSuccess;
+
+    UPROPERTY(BlueprintAssignable)
+    FBH_OnReportSubmitted OnFailure;
+
+    virtual void Activate() override;
+
+private:
+    void Finish(bool bSuccess, const FString& Error);
+
+    UPROPERTY()
+    TObjectPtr<UBH_BugReport> BugReport;
+
+    TWeakObjectPtr<UObject> WorldContext;
+    FString Description;
+    FString StepsToReproduce;
+    bool bIncludeVideo;
+    bool bIncludeScreenshot;
+    bool bIncludeLogs;
+};